@@ -4,11 +4,38 @@
 //
 
 #include "ira.h"
+#include "mps_sliced.h"
+#include "thread_pool.h"
+#include "task_graph.h"
 #include <iostream>
 #include <random>
 
 using namespace std;
 
+#ifndef IRA_PARALLEL_MIN_ELEMENTS
+#define IRA_PARALLEL_MIN_ELEMENTS 1024      // elements of a trailing update from which on it runs in parallel
+#endif
+
+namespace {
+
+    /**
+     * Calls work(first, last) for consecutive ranges of [0, items) on the threads of the pool. Loops with fewer than
+     * IRA_PARALLEL_MIN_ELEMENTS updated elements run on the calling thread.
+     */
+    void distribute(thread_pool& pool, unsigned long items, unsigned long elements, const std::function<void(unsigned long, unsigned long)>& work){
+
+        if(pool.size() <= 1 || items < 2 || elements < IRA_PARALLEL_MIN_ELEMENTS){
+            work(0, items);
+            return;
+        }
+
+        const auto blocks = std::min(items, 4 * pool.size());
+        pool.run(blocks, [&](unsigned long block){
+            work(items * block / blocks, items * (block + 1) / blocks);
+        });
+    }
+}
+
 // constructor and destructor
 //-------------------------------
 /**
@@ -38,6 +65,11 @@ ira::ira(unsigned long n, unsigned long ur_mantissa_length, unsigned long ur_exp
     this->parameters.sparsity_rate = 0;
 
     this->parameters.max_iter = 10;     // Must be 10 because of unit tests.
+    this->parameters.fused_multiply_add = false;
+    this->parameters.in_place_lu = false;
+    this->parameters.threads = 1;
+    this->parameters.decomposition = lu_variant::unblocked;
+    this->parameters.lu_block_size = 32;
 
     this->parameters.ur_m_l = ur_mantissa_length;
     this->parameters.ur_e_l = ur_exponent_length;
@@ -114,6 +146,76 @@ void ira::setMaxIter(unsigned long new_max_iter){
     this->parameters.max_iter = new_max_iter;
 }
 
+/**
+ * Enables or disables the fused multiply-add in the inner loops (decompPLU, the substitutions and the matrix vector
+ * products). With it the products are not rounded before they are accumulated, like on hardware with FMA units.
+ *
+ * @param enabled true to use mps::fma
+ */
+void ira::setFusedMultiplyAdd(bool enabled){
+
+    this->parameters.fused_multiply_add = enabled;
+}
+
+/**
+ * Enables or disables the in-place PLU decomposition. With it decompPLU stores the multipliers of L in the strict lower
+ * part of U (the unit diagonal of L is not stored), like LAPACK's getrf, so only one n x n matrix is allocated in the
+ * precision ul. Row interchanges then only exchange row indices. The results are the same as without it.
+ *
+ * @param enabled true to decompose in place
+ */
+void ira::setInPlaceLU(bool enabled){
+
+    this->parameters.in_place_lu = enabled;
+}
+
+/**
+ * Sets the number of threads of the PLU decomposition. The rows of the trailing update of every pivot step are
+ * distributed over the threads. Every element is computed with the same operations as by one thread, so the results
+ * do not depend on the number of threads.
+ *
+ * @param new_threads the number of threads (0: one per hardware thread, 1: no additional threads)
+ */
+void ira::setThreads(unsigned long new_threads){
+
+    this->parameters.threads = new_threads;
+}
+
+/**
+ * Selects the algorithm of the PLU decomposition.
+ * unblocked: one elimination step after the other, each on the whole trailing matrix.
+ * blocked: right-looking blocked decomposition. The pivot steps of a panel of block size columns are performed on the
+ * panel only, then the block row of U is computed (triangular solve) and the trailing matrix is updated with the whole
+ * panel at once (matrix product, in tiles of block size columns). Every element gets the same operations in the same
+ * order as with the unblocked decomposition, so the results are the same.
+ * tiled: the blocked decomposition in tiles of block size x block size elements, whose operations are scheduled as a
+ * task graph on setThreads threads with work stealing. The next panel starts before the update of the trailing
+ * matrix is finished (lookahead), there is no barrier after a pivot step. The results are the same as well.
+ * The variant used by the last decomposition is stored in evaluation.lu_variant_used.
+ *
+ * @param new_variant the algorithm
+ */
+void ira::setLUVariant(lu_variant new_variant){
+
+    this->parameters.decomposition = new_variant;
+}
+
+/**
+ * Sets the block size of the blocked PLU decomposition (see setLUVariant).
+ *
+ * Throws Exception:    When the block size is 0.
+ *
+ * @param new_block_size the number of columns of a panel
+ */
+void ira::setBlockSize(unsigned long new_block_size){
+
+    if (0 == new_block_size) {
+        throw std::invalid_argument("ERROR: in setBlockSize : block size too small");
+    }
+
+    this->parameters.lu_block_size = new_block_size;
+}
+
 /**
  * Sets the dimension of the system.
  *
@@ -402,6 +504,56 @@ unsigned long ira::getMaxIter() const {
     return this->parameters.max_iter;
 }
 
+/**
+ * Gets whether the inner loops use the fused multiply-add.
+ *
+ * @return true if mps::fma is used
+ */
+bool ira::getFusedMultiplyAdd() const {
+
+    return this->parameters.fused_multiply_add;
+}
+
+/**
+ * Returns true if the PLU decomposition is done in place (see setInPlaceLU).
+ *
+ * @return true if the decomposition is done in place
+ */
+bool ira::getInPlaceLU() const {
+
+    return this->parameters.in_place_lu;
+}
+
+/**
+ * Returns the number of threads of the PLU decomposition (see setThreads).
+ *
+ * @return the number of threads (0: one per hardware thread)
+ */
+unsigned long ira::getThreads() const {
+
+    return this->parameters.threads;
+}
+
+/**
+ * Returns the selected algorithm of the PLU decomposition (see setLUVariant).
+ *
+ * @return the algorithm
+ */
+ira::lu_variant ira::getLUVariant() const {
+
+    return this->parameters.decomposition;
+}
+
+/**
+ * Returns the block size of the blocked PLU decomposition.
+ *
+ * @return the number of columns of a panel
+ */
+unsigned long ira::getBlockSize() const {
+
+    return this->parameters.lu_block_size;
+}
+
 /**
  * Gets the dimension of the system.
  *
@@ -569,7 +721,6 @@ void ira::setUnitaryMatrix() {
 
     this->A.resize(this->parameters.n);
     for(unsigned long i = 0; i <  this->parameters.n; i++){
-        this->A[i].resize(this->parameters.n);
         for(unsigned long j = 0; j < this->parameters.n; j++){
             if(i == j){
                 this->A[i][j] |= one;
@@ -596,11 +747,14 @@ void ira::setMatrix(vector<double> new_matrix) {
         throw std::invalid_argument("ERROR: in setMatrix: new_matrix too small");
     }
 
+    // convert all values at once (in parallel for large matrices), then distribute them to the rows
+    vector<mps> values(new_matrix.size());
+    mps::fromDoubles(new_matrix.data(), new_matrix.size(), values.data(), this->parameters.ur_m_l, this->parameters.ur_e_l);
+
     this->A.resize(this->parameters.n);
     for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
-        this->A[row_idx].resize(this->parameters.n);
         for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
-            this->A[row_idx][col_idx] |= mps(this->parameters.ur_m_l, this->parameters.ur_e_l, new_matrix[get_idx(row_idx, col_idx)]);
+            this->A[row_idx][col_idx] |= std::move(values[get_idx(row_idx, col_idx)]);
         }
     }
 }
@@ -623,7 +777,6 @@ void ira::setRandomMatrix(){
     if(0 == this->parameters.sparsity_rate) {
 
         for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
-            this->A[row_idx].resize(this->parameters.n);
             for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
                 this->A[row_idx][col_idx] |= mps(this->parameters.ur_m_l, this->parameters.ur_e_l, dist(mt));
             }
@@ -649,7 +802,6 @@ void ira::setRandomMatrix(){
         mps zero(this->parameters.ur_m_l, this->parameters.ur_e_l, 0);
 
         for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
-            this->A[row_idx].resize(this->parameters.n);
             for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
 
                 if(col_idx == random_vector[row_idx]){
@@ -686,9 +838,10 @@ void ira::setL(vector<double> new_L) {
         throw std::invalid_argument("ERROR: in setL: new_L too small");
     }
 
+    this->splitLU();
+
     this->L.resize(this->parameters.n);
     for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
-        this->L[row_idx].resize(this->parameters.n);
         for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
             this->L[row_idx][col_idx] |= mps(this->parameters.ur_m_l, this->parameters.ur_e_l, new_L[get_idx(row_idx, col_idx)]);
         }
@@ -712,9 +865,10 @@ void ira::setU(vector<double> new_U) {
         throw std::invalid_argument("ERROR: in setU: new_U too small");
     }
 
+    this->splitLU();
+
     this->U.resize(this->parameters.n);
     for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
-        this->U[row_idx].resize(this->parameters.n);
         for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
             this->U[row_idx][col_idx] |= mps(this->parameters.ur_m_l, this->parameters.ur_e_l, new_U[get_idx(row_idx, col_idx)]);
         }
@@ -773,7 +927,7 @@ string ira::toString(const char& matrix, const int precision) const {
 
     if('A' == matrix){
 
-        if(this->A.empty() || this->A[0].empty() || (this->A[0][0].getExponentLength() == 0 && this->A[0][0].getMantisseLength() == 0)){
+        if(this->A.empty() || (this->A[0][0].getExponentLength() == 0 && this->A[0][0].getMantisseLength() == 0)){
             throw std::invalid_argument("ERROR: toString: A is empty");
         }
 
@@ -789,13 +943,23 @@ string ira::toString(const char& matrix, const int precision) const {
 
     } else if('L' == matrix){
 
-        if(this->L.empty() || this->L[0].empty() || (this->L[0][0].getExponentLength() == 0 && this->L[0][0].getMantisseLength() == 0)){
+        const auto& lower = this->lu_combined ? this->U : this->L;
+
+        if(lower.empty() || (lower[0][0].getExponentLength() == 0 && lower[0][0].getMantisseLength() == 0)){
             throw std::invalid_argument("ERROR: toString: L is empty");
         }
 
+        // with the in-place decomposition, L is the strict lower part of U with a unit diagonal
+        auto zero = mps(lower[0][0].getMantisseLength(), lower[0][0].getExponentLength(), 0).toString(precision);
+        auto one = mps(lower[0][0].getMantisseLength(), lower[0][0].getExponentLength(), 1).toString(precision);
+
         for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
             for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
-                ret.append(this->L[row_idx][col_idx].toString(precision));
+                if(!this->lu_combined || col_idx < row_idx){
+                    ret.append(lower[row_idx][col_idx].toString(precision));
+                } else {
+                    ret.append(col_idx == row_idx ? one : zero);
+                }
                 ret.append(", ");
             }
         }
@@ -805,13 +969,19 @@ string ira::toString(const char& matrix, const int precision) const {
 
     } else if('U' == matrix) {
 
-        if(this->U.empty() || this->U[0].empty() || (this->U[0][0].getExponentLength() == 0 && this->U[0][0].getMantisseLength() == 0)){
+        if(this->U.empty() || (this->U[0][0].getExponentLength() == 0 && this->U[0][0].getMantisseLength() == 0)){
             throw std::invalid_argument("ERROR: toString: U is empty");
         }
 
+        auto zero = mps(this->U[0][0].getMantisseLength(), this->U[0][0].getExponentLength(), 0).toString(precision);
+
         for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
             for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
-                ret.append(this->U[row_idx][col_idx].toString(precision));
+                if(this->lu_combined && col_idx < row_idx){
+                    ret.append(zero);
+                } else {
+                    ret.append(this->U[row_idx][col_idx].toString(precision));
+                }
                 ret.append(", ");
             }
         }
@@ -821,15 +991,17 @@ string ira::toString(const char& matrix, const int precision) const {
 
     } else if('P' == matrix) {
 
-        if(this->P.empty() || (this->P[0].getExponentLength() == 0 && this->P[0].getMantisseLength() == 0)){
+        if(this->P.empty()){
             throw std::invalid_argument("ERROR: toString: P is empty");
         }
 
-
-        vector<unsigned long> P_int;
-        P_int.reserve(P.size());
-        for(const auto & i : P){
-            P_int.push_back((unsigned long) i.getValue());
+        // apply the row interchanges to the identity
+        vector<unsigned long> P_int(P.size());
+        for(unsigned long i = 0; i < P.size(); i++){
+            P_int[i] = i;
+        }
+        for(unsigned long k = 0; k < P.size(); k++){
+            std::swap(P_int[k], P_int[P[k]]);
         }
 
         string tmp_zero = "0.";
@@ -1053,7 +1225,7 @@ void ira::castExpectedError(unsigned long mantissa_length, unsigned long exponen
  * @param double_vector the vector of double objects
  * @return a new vector consisting of mps elements
  */
-vector<mps> ira::double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, vector<double> double_vector){
+vector<mps> ira::double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, const vector<double>& double_vector){
 
     if (double_vector.empty()) {
         throw std::invalid_argument("ERROR: in double_to_mps: double_vector is empty");
@@ -1065,16 +1237,13 @@ vector<mps> ira::double_to_mps(unsigned long mantissa_length, unsigned long expo
         throw std::invalid_argument("ERROR: in double_to_mps : exponent length too small");
     }
 
-    vector<mps> ret(double_vector.size(), mps(mantissa_length, exponent_length));
-
-    for(unsigned long i = 0; i < double_vector.size(); i++){
-        ret[i] = double_vector[i];
-    }
+    vector<mps> ret(double_vector.size());
+    mps::fromDoubles(double_vector.data(), double_vector.size(), ret.data(), mantissa_length, exponent_length);
 
     return ret;
 }
 
-vector<vector<mps>> ira::double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, vector<vector<double>> double_matrix){
+vector<vector<mps>> ira::double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, const vector<vector<double>>& double_matrix){
 
     if (double_matrix.empty() || double_matrix[0].empty()) {
         throw std::invalid_argument("ERROR: in double_to_mps: double_vector is empty");
@@ -1090,9 +1259,7 @@ vector<vector<mps>> ira::double_to_mps(unsigned long mantissa_length, unsigned l
     ret.resize(double_matrix.size());
     for(unsigned long row_idx = 0; row_idx < double_matrix.size(); row_idx++){
         ret[row_idx].resize(double_matrix.size());
-        for(unsigned long col_idx = 0; col_idx < double_matrix.size(); col_idx++){
-            ret[row_idx][col_idx] |= mps(mantissa_length, exponent_length, double_matrix[row_idx][col_idx]);
-        }
+        mps::fromDoubles(double_matrix[row_idx].data(), double_matrix.size(), ret[row_idx].data(), mantissa_length, exponent_length);
     }
 
     return ret;
@@ -1106,17 +1273,14 @@ vector<vector<mps>> ira::double_to_mps(unsigned long mantissa_length, unsigned l
  * @param mps_vector the vector of mps objects.
  * @return a vector new vector consisting of doubles.
  */
-vector<double> ira::mps_to_double(vector<mps> mps_vector){
+vector<double> ira::mps_to_double(const vector<mps>& mps_vector){
 
     if (mps_vector.empty()) {
         throw std::invalid_argument("ERROR: in mps_to_double: mps_vector is empty");
     }
 
     vector<double> ret(mps_vector.size(), 0.0);
-
-    for(unsigned long i = 0; i < mps_vector.size(); i++){
-        ret[i] = mps_vector[i].getValue();
-    }
+    mps::toDoubles(mps_vector.data(), mps_vector.size(), ret.data());
 
     return ret;
 }
@@ -1129,17 +1293,14 @@ vector<double> ira::mps_to_double(vector<mps> mps_vector){
  * @param mps_vector the vector of mps objects.
  * @return a vector new vector consisting of floats.
  */
-vector<float> ira::mps_to_float(vector<mps> mps_vector){
+vector<float> ira::mps_to_float(const vector<mps>& mps_vector){
 
     if (mps_vector.empty()) {
         throw std::invalid_argument("ERROR: in mps_to_float: mps_vector is empty");
     }
 
     vector<float> ret(mps_vector.size(), 0.0);
-
-    for(unsigned long i = 0; i < mps_vector.size(); i++){
-        ret[i] = (float) mps_vector[i].getValue();
-    }
+    mps::toFloats(mps_vector.data(), mps_vector.size(), ret.data());
 
     return ret;
 }
@@ -1341,9 +1502,9 @@ mps ira::calculateVectorMean(const vector<mps>& a){
     for(const auto& element : a){
 
         if(element.isPositive()){
-            sum = sum + element;
+            sum += element;
         } else {
-            sum = sum - element;
+            sum -= element;
         }
     }
 
@@ -1384,7 +1545,7 @@ mps ira::calculateMeanPrecision(const vector<mps>& is, const vector<mps>& should
     for(unsigned long idx = 0; idx < is.size(); idx++){
 
         mps precision(is[0].getMantisseLength(), is[0].getExponentLength(), (double) is[idx].getPrecision(should[idx]));
-        sum = sum + precision;
+        sum += precision;
 
     }
 
@@ -1420,10 +1581,56 @@ vector<mps> ira::add(const vector<mps>& a, const vector<mps>& b) {
         throw std::invalid_argument("ERROR: in add: mantissas do not match");
     }
 
-    vector<mps> result(a.size(), mps(a[0].getMantisseLength(), a[0].getExponentLength(), 0.0));
+    // bit-sliced: all elements at once
+    if(mps::engine::sliced == mps::getEngine()){
+        return (mps_sliced(a) + mps_sliced(b)).toVector();
+    }
+
+    vector<mps> result;
+    result.reserve(a.size());
+
+    for(unsigned long i = 0; i < a.size(); i++){
+        result.push_back(a[i] + b[i]);
+    }
+
+    return result;
+}
+
+/**
+ * Adds two vectors together in a target format. The vectors may have different formats, their elements are cast
+ * within the additions (mps::add), so the result is the same as casting the vectors first.
+ *
+ * @param a the first vector.
+ * @param b the second vector.
+ * @param mantissa_length the mantissa length of the result.
+ * @param exponent_length the exponent length of the result.
+ * @return the resulting vector after the addition.
+ */
+vector<mps> ira::add(const vector<mps>& a, const vector<mps>& b, unsigned long mantissa_length, unsigned long exponent_length) {
+
+    if (a.empty()) {
+        throw std::invalid_argument("ERROR: in add: a is empty");
+    }
+    if (b.empty()) {
+        throw std::invalid_argument("ERROR: in add: b is empty");
+    }
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("ERROR: in add: dimensions of a and b do not match");
+    }
+
+    // bit-sliced: the planes are cast to the target format
+    if(mps::engine::sliced == mps::getEngine()){
+        mps_sliced one(a), two(b);
+        one.cast(mantissa_length, exponent_length);
+        two.cast(mantissa_length, exponent_length);
+        return (one + two).toVector();
+    }
+
+    vector<mps> result;
+    result.reserve(a.size());
 
     for(unsigned long i = 0; i < a.size(); i++){
-        result[i] = a[i] + b[i];
+        result.push_back(mps::add(a[i], b[i], mantissa_length, exponent_length));
     }
 
     return result;
@@ -1454,50 +1661,125 @@ vector<mps> ira::subtract(const vector<mps>& a, const vector<mps>& b) {
         throw std::invalid_argument("ERROR: in subtract: mantissas do not match");
     }
 
-    vector<mps> result(a.size(), mps(a[0].getMantisseLength(), a[0].getExponentLength(), 0.0));
+    // bit-sliced: all elements at once
+    if(mps::engine::sliced == mps::getEngine()){
+        return (mps_sliced(a) - mps_sliced(b)).toVector();
+    }
+
+    vector<mps> result;
+    result.reserve(a.size());
 
     for(unsigned long i = 0; i < a.size(); i++){
-        result[i] = a[i] - b[i];
+        result.push_back(a[i] - b[i]);
     }
 
     return result;
 }
 
+namespace {
+
+    // the matrix vector products for both matrix types (vector<vector<mps>> and mps_matrix)
+    template<typename Matrix>
+    vector<mps> matrixVectorProduct(const Matrix& D, const vector<mps>& x, bool fused) {
+
+        if (D.empty()) {
+            throw std::invalid_argument("ERROR: in dotProduct: D is empty");
+        }
+        if (x.empty()) {
+            throw std::invalid_argument("ERROR: in dotProduct: x is empty");
+        }
+        if (D.size() != x.size()) {
+            throw std::invalid_argument("ERROR: in dotProduct: dimensions of D and x do not match");
+        }
+        if (D[0][0].getExponentLength() != x[0].getExponentLength()) {
+            throw std::invalid_argument("ERROR: in dotProduct: exponents do not match");
+        }
+        if (D[0][0].getMantisseLength() != x[0].getMantisseLength()) {
+            throw std::invalid_argument("ERROR: in dotProduct: mantissas do not match");
+        }
+        vector<mps> y(x.size(), mps(D[0][0].getMantisseLength(), D[0][0].getExponentLength(), 0.0));
+
+        for(unsigned long i = 0; i < x.size(); i++){
+            for(unsigned long j = 0; j < x.size(); j++){
+                if(fused){
+                    y[i].addProduct(x[j], D[i][j]);
+                } else {
+                    y[i] += x[j] * D[i][j];
+                }
+            }
+        }
+
+        return y;
+    }
+
+    template<typename Matrix>
+    vector<mps> matrixVectorProduct(const Matrix& D, const vector<mps>& x, unsigned long mantissa_length, unsigned long exponent_length, bool fused) {
+
+        if (D.empty()) {
+            throw std::invalid_argument("ERROR: in dotProduct: D is empty");
+        }
+        if (x.empty()) {
+            throw std::invalid_argument("ERROR: in dotProduct: x is empty");
+        }
+        if (D.size() != x.size()) {
+            throw std::invalid_argument("ERROR: in dotProduct: dimensions of D and x do not match");
+        }
+        vector<mps> y(x.size(), mps(mantissa_length, exponent_length, 0.0));
+
+        for(unsigned long i = 0; i < x.size(); i++){
+            for(unsigned long j = 0; j < x.size(); j++){
+                if(fused){
+                    y[i] = mps::fma(x[j], D[i][j], y[i], mantissa_length, exponent_length);
+                } else {
+                    y[i] += mps::multiply(x[j], D[i][j], mantissa_length, exponent_length);
+                }
+            }
+        }
+
+        return y;
+    }
+}
+
 /**
  * Performs a matrix vector product.
  * The elements of the matrix and the vector are mps objects.
  *
  * @param D the matrix for the multiplication
  * @param x the vector for the multiplication
+ * @param fused true to accumulate the products with a single rounding (mps::fma)
  * @return the resulting vector from the multiplication.
  */
 
-vector<mps> ira::dotProduct(const vector<vector<mps>>& D, const vector<mps>& x) {
+vector<mps> ira::dotProduct(const vector<vector<mps>>& D, const vector<mps>& x, bool fused) {
 
-    if (D.empty()) {
-        throw std::invalid_argument("ERROR: in dotProduct: D is empty");
-    }
-    if (x.empty()) {
-        throw std::invalid_argument("ERROR: in dotProduct: x is empty");
-    }
-    if (D.size() != x.size()) {
-        throw std::invalid_argument("ERROR: in dotProduct: dimensions of D and x do not match");
-    }
-    if (D[0][0].getExponentLength() != x[0].getExponentLength()) {
-        throw std::invalid_argument("ERROR: in dotProduct: exponents do not match");
-    }
-    if (D[0][0].getMantisseLength() != x[0].getMantisseLength()) {
-        throw std::invalid_argument("ERROR: in dotProduct: mantissas do not match");
-    }
-    vector<mps> y(x.size(), mps(D[0][0].getMantisseLength(), D[0][0].getExponentLength(), 0.0));
+    return matrixVectorProduct(D, x, fused);
+}
 
-    for(unsigned long i = 0; i < x.size(); i++){
-        for(unsigned long j = 0; j < x.size(); j++){
-            y[i] = y[i] + (x[j] * D[i][j]);
-        }
-    }
+vector<mps> ira::dotProduct(const mps_matrix& D, const vector<mps>& x, bool fused) {
+
+    return matrixVectorProduct(D, x, fused);
+}
 
-    return y;
+/**
+ * Performs a matrix vector product in a target format.
+ * The matrix and the vector may have different formats, their elements are cast within the operations (mps::multiply,
+ * mps::fma), so the result is the same as casting them first.
+ *
+ * @param D the matrix for the multiplication
+ * @param x the vector for the multiplication
+ * @param mantissa_length the mantissa length of the result
+ * @param exponent_length the exponent length of the result
+ * @param fused true to accumulate the products with a single rounding (mps::fma)
+ * @return the resulting vector from the multiplication.
+ */
+vector<mps> ira::dotProduct(const vector<vector<mps>>& D, const vector<mps>& x, unsigned long mantissa_length, unsigned long exponent_length, bool fused) {
+
+    return matrixVectorProduct(D, x, mantissa_length, exponent_length, fused);
+}
+
+vector<mps> ira::dotProduct(const mps_matrix& D, const vector<mps>& x, unsigned long mantissa_length, unsigned long exponent_length, bool fused) {
+
+    return matrixVectorProduct(D, x, mantissa_length, exponent_length, fused);
 }
 
 /**
@@ -1506,9 +1788,10 @@ vector<mps> ira::dotProduct(const vector<vector<mps>>& D, const vector<mps>& x)
  *
  * @param A the first matrix for the multiplication
  * @param B the first matrix for the multiplication
+ * @param fused true to accumulate the products with a single rounding (mps::fma)
  * @return the resulting vector from the multiplication.
  */
-vector<vector<mps>> ira::dotProduct(const vector<vector<mps>>& A, const vector<vector<mps>>& B){
+vector<vector<mps>> ira::dotProduct(const vector<vector<mps>>& A, const vector<vector<mps>>& B, bool fused){
 
     if (A.empty()) {
         throw std::invalid_argument("ERROR: in dotProduct: A is empty");
@@ -1540,7 +1823,11 @@ vector<vector<mps>> ira::dotProduct(const vector<vector<mps>>& A, const vector<v
 
             mps sum (mantissa_length, exponent_length, 0.0);
             for(unsigned long idx = 0; idx < A[0].size(); idx++){
-                sum = sum + ( A[row_idx][idx] * B[idx][col_idx] );
+                if(fused){
+                    sum.addProduct(A[row_idx][idx], B[idx][col_idx]);
+                } else {
+                    sum += A[row_idx][idx] * B[idx][col_idx];
+                }
             }
             ret[row_idx][col_idx] |= sum;
         }
@@ -1579,7 +1866,7 @@ vector<mps> ira::multiplyWithSystemMatrix(vector<mps> x) const {
         throw std::invalid_argument("ERROR: in multiplyWithSystemMatrix: mantissas do not match");
     }
 
-    return dotProduct(this->A, x);
+    return dotProduct(this->A, x, this->parameters.fused_multiply_add);
 }
 //-------------------------------
 
@@ -1589,6 +1876,9 @@ vector<mps> ira::multiplyWithSystemMatrix(vector<mps> x) const {
 /**
  * Performs a PLU-Decomposition of the form PA = LU.
  * The result is saved into internal variables of the ira object, namely L, U and P.
+ * With setInPlaceLU(true) L is stored in the strict lower part of U and the rows of U are exchanged by their indices.
+ * The algorithm (unblocked, blocked or tiled) is selected with setLUVariant, the work is distributed over setThreads
+ * threads.
  *
  * @param mantissa_precision the precision of the mantissa for the PLU-decomposition.
  * @param exponent_precision the precision of the exponent for the PLU-decomposition.
@@ -1602,20 +1892,27 @@ void ira::decompPLU(unsigned long mantissa_precision, unsigned long exponent_pre
         throw std::invalid_argument("ERROR: in decompPLU : exponent size too small");
     }
 
+    const bool in_place = this->parameters.in_place_lu;
+    this->lu_combined = in_place;
+
     // set up L
     //-------------------------------
-    mps mps_zero(mantissa_precision, exponent_precision, 0);
-    mps mps_one(mantissa_precision, exponent_precision, 1);
+    if(in_place){
+        this->L.clear();
+    } else {
 
-    this->L.resize(this->parameters.n);
-    for(unsigned long row_idx = 0; row_idx <  this->parameters.n; row_idx++){
-        this->L[row_idx].resize(this->parameters.n);
-        for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
+        mps mps_zero(mantissa_precision, exponent_precision, 0);
+        mps mps_one(mantissa_precision, exponent_precision, 1);
 
-            if(row_idx == col_idx){
-                this->L[row_idx][col_idx] |= mps_one;
-            } else {
-                this->L[row_idx][col_idx] |= mps_zero;
+        this->L.resize(this->parameters.n);
+        for(unsigned long row_idx = 0; row_idx <  this->parameters.n; row_idx++){
+            for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
+
+                if(row_idx == col_idx){
+                    this->L[row_idx][col_idx] |= mps_one;
+                } else {
+                    this->L[row_idx][col_idx] |= mps_zero;
+                }
             }
         }
     }
@@ -1624,9 +1921,6 @@ void ira::decompPLU(unsigned long mantissa_precision, unsigned long exponent_pre
     // set up P
     //-------------------------------
     this->P.resize(this->parameters.n);
-    for(unsigned long i = 0; i < this->parameters.n; i++){
-        P[i] |= mps(mantissa_precision, exponent_precision, (double) i);
-    }
     //-------------------------------
 
 
@@ -1634,7 +1928,6 @@ void ira::decompPLU(unsigned long mantissa_precision, unsigned long exponent_pre
     //-------------------------------
     this->U.resize(this->parameters.n);
     for(unsigned long row_idx = 0; row_idx < this->parameters.n; row_idx++){
-        this->U[row_idx].resize(this->parameters.n);
         for(unsigned long col_idx = 0; col_idx < this->parameters.n; col_idx++){
 
             this->U[row_idx][col_idx] |= A[row_idx][col_idx];
@@ -1646,61 +1939,119 @@ void ira::decompPLU(unsigned long mantissa_precision, unsigned long exponent_pre
 
     // algorithm
     //-------------------------------
-    for(unsigned long k = 0; k < this->parameters.n; k++){
-        // cout << "iteration: " << k << "/" << this->n << endl;
+    const auto n = this->parameters.n;
+    const auto block_size = this->parameters.lu_block_size;
 
-        auto max_row = get_max_U_idx(k, k);
+    if(lu_variant::tiled == this->parameters.decomposition && block_size < n){
 
-        interchangeRow(this->U, k, max_row, k, this->parameters.n);
-        interchangeRow(this->L, k, max_row, 0, k);
+        this->evaluation.lu_variant_used = lu_variant::tiled;
+        this->decompTiled(block_size);
+        return;
+    }
 
-        auto tmp = P[k]; P[k] = P[max_row]; P[max_row] = tmp;
+    thread_pool pool(n * n < IRA_PARALLEL_MIN_ELEMENTS ? 1 : this->parameters.threads);
 
-        for(unsigned long j = k+1; j < this->parameters.n; j++){
+    if(lu_variant::unblocked == this->parameters.decomposition || block_size >= n){
 
-            //idx = get_idx(j, k);
-            this->L[j][k] = this->U[j][k] / this->U[k][k];
+        this->evaluation.lu_variant_used = lu_variant::unblocked;
 
-            for(unsigned long i = k; i < this->parameters.n; i++){
+        for(unsigned long k = 0; k < n; k++){
 
-                this->U[j][i]  = this->U[j][i] - (this->L[j][k] * this->U[k][i]);
-            }
+            this->pivotRow(k);
+
+            // trailing update: the rows are independent, blocks of rows are distributed over the threads
+            distribute(pool, n - k - 1, (n - k - 1) * (n - k), [&](unsigned long first, unsigned long last){
+                this->eliminate(k, k + 1 + first, k + 1 + last, n);
+            });
         }
 
+    } else {
+
+        this->evaluation.lu_variant_used = lu_variant::blocked;
+
+        for(unsigned long block_start = 0; block_start < n; block_start += block_size){
+
+            const auto block_end = std::min(block_start + block_size, n);
+
+            // panel: the elimination steps of the block, only on the columns of the block
+            for(unsigned long k = block_start; k < block_end; k++){
+
+                this->pivotRow(k);
+
+                distribute(pool, n - k - 1, (n - k - 1) * (block_end - k), [&](unsigned long first, unsigned long last){
+                    this->eliminate(k, k + 1 + first, k + 1 + last, block_end);
+                });
+            }
+
+            if(block_end == n){
+                break;
+            }
+
+            // block row of U (triangular solve): the column tiles are independent, their rows depend on each other
+            const auto tiles = (n - block_end + block_size - 1) / block_size;
+            distribute(pool, tiles, (block_end - block_start) * (n - block_end), [&](unsigned long first, unsigned long last){
+                for(auto tile = first; tile < last; tile++){
+                    auto column = block_end + tile * block_size;
+                    this->updateBlock(block_start, block_end, block_start + 1, block_end, column, std::min(column + block_size, n));
+                }
+            });
+
+            // trailing matrix (matrix product): blocks of rows are distributed over the threads
+            distribute(pool, n - block_end, (n - block_end) * (n - block_end), [&](unsigned long first, unsigned long last){
+                for(auto column = block_end; column < n; column += block_size){
+                    this->updateBlock(block_start, block_end, block_end + first, block_end + last, column, std::min(column + block_size, n));
+                }
+            });
+        }
     }
     //-------------------------------
 }
 
 /**
  * Performs a forward substitution.
- * The values of the needed lower triangular matrix are taken from the internal matrix L of the ira object.
+ * The values of the needed lower triangular matrix are taken from the internal matrix L of the ira object (after an
+ * in-place decomposition from the strict lower part of U, the diagonal is one).
  *
  * @param b the b vector needed for the substitution.
  * @return the resulting x vector.
  */
 vector<mps> ira::forwardSubstitution(const vector<mps>& b) const {
 
-    if (this->L.empty()) {
+    const auto& L = this->lu_combined ? this->U : this->L;
+
+    if (L.empty()) {
         throw std::invalid_argument("ERROR: in forwardSubstitution: L is empty");
     }
     if (b.empty()) {
         throw std::invalid_argument("ERROR: in forwardSubstitution: b is empty");
     }
 
-    vector<mps> x(b.size(), mps(this->L[0][0].getMantisseLength(), this->L[0][0].getExponentLength()));
+    vector<mps> x(b.size(), mps(L[0][0].getMantisseLength(), L[0][0].getExponentLength()));
 
-    x[0] = b[0]/L[0][0];
+    if(this->lu_combined){
+        x[0] = b[0];
+    } else {
+        x[0] = b[0]/L[0][0];
+    }
 
-    mps tmp_sum(this->L[0][0].getMantisseLength(), this->L[0][0].getExponentLength());
+    mps tmp_sum(L[0][0].getMantisseLength(), L[0][0].getExponentLength());
 
     for(unsigned long i = 1; i < this->parameters.n; i++){
 
         tmp_sum = 0;
         for(unsigned long j = 0; j < i; j++){
-            tmp_sum =  tmp_sum + (L[i][j] * x[j]);
+            if(this->parameters.fused_multiply_add){
+                tmp_sum.addProduct(L[i][j], x[j]);
+            } else {
+                tmp_sum += L[i][j] * x[j];
+            }
         }
 
-        x[i] = (b[i] - tmp_sum) / L[i][i];
+        if(this->lu_combined){
+            x[i] = b[i] - tmp_sum;
+        } else {
+            x[i] = (b[i] - tmp_sum) / L[i][i];
+        }
     }
 
     return x;
@@ -1737,7 +2088,11 @@ vector<mps> ira::backwardSubstitution(const vector<mps>& b) const {
         tmp_sum = 0;
         for(unsigned long j = n_minus_one; j > i; j--){
 
-            tmp_sum =  tmp_sum + (U[i][j] * x[j]);
+            if(this->parameters.fused_multiply_add){
+                tmp_sum.addProduct(U[i][j], x[j]);
+            } else {
+                tmp_sum += U[i][j] * x[j];
+            }
         }
 
         x[i] = (b[i] - tmp_sum) / U[i][i];
@@ -1768,8 +2123,8 @@ vector<mps> ira::directPLU(const vector<mps>& b){
 
 
 
-    auto x = ira::permuteVector(this->P, tmp_b);
-    x = this->forwardSubstitution(x);
+    ira::permuteVector(this->P, tmp_b);
+    auto x = this->forwardSubstitution(tmp_b);
     x = this->backwardSubstitution(x);
 
     return x;
@@ -1804,9 +2159,10 @@ vector<mps> ira::irPLU(const vector<mps> &b) {
     vector<unsigned long> ul{this->parameters.ul_m_l, this->parameters.ul_e_l};
     //-------------------------------
 
-    // start timer
+    // start timer and counters
     //-------------------------------
     const auto start = std::chrono::high_resolution_clock::now();
+    const auto counters_start = mps_counters::read();
     //-------------------------------
 
     // perform PLU decomposition
@@ -1818,9 +2174,9 @@ vector<mps> ira::irPLU(const vector<mps> &b) {
     //-------------------------------
     auto tmp_b = b;
     ira::cast(tmp_b, ul[0], ul[1]);
-    auto x = ira::permuteVector(this->P, tmp_b);
+    ira::permuteVector(this->P, tmp_b);
 
-    x = this->forwardSubstitution(x);
+    auto x = this->forwardSubstitution(tmp_b);
     x = this->backwardSubstitution(x);
     ira::cast(x, u[0], u[1]);
     //-------------------------------
@@ -1831,10 +2187,15 @@ vector<mps> ira::irPLU(const vector<mps> &b) {
         // calculate: r_i = b − A * x_i
         // in precision: ur
         //-------------------------------
-        auto x_in_ur = x;
-        ira::cast(x_in_ur, ur[0], ur[1]);
-        auto b_approx = ira::dotProduct(this->A, x_in_ur);
+        auto b_approx = ira::dotProduct(this->A, x, ur[0], ur[1], this->parameters.fused_multiply_add);
         auto r = subtract(b, b_approx);
+
+        // x_i in precision ur (only needed for the evaluation)
+        vector<mps> x_in_ur;
+        if(this->parameters.expected_result_present) {
+            x_in_ur = x;
+            ira::cast(x_in_ur, ur[0], ur[1]);
+        }
         //-------------------------------
 
         // check convergence (precision)
@@ -1870,7 +2231,7 @@ vector<mps> ira::irPLU(const vector<mps> &b) {
         // in precision: ul
         //-------------------------------
         ira::cast(r, ul[0], ul[1]);
-        r = ira::permuteVector(this->P, r);
+        ira::permuteVector(this->P, r);
         auto d = this->forwardSubstitution(r);
         d = this->backwardSubstitution(d);
         //-------------------------------
@@ -1879,8 +2240,7 @@ vector<mps> ira::irPLU(const vector<mps> &b) {
         // calculate: x_i+1 = x_i + d_i i
         // n precision u.
         //-------------------------------
-        ira::cast(d, u[0], u[1]);
-        x = add(x, d);
+        x = add(x, d, u[0], u[1]);
         //-------------------------------
 
 
@@ -1937,6 +2297,7 @@ vector<mps> ira::irPLU(const vector<mps> &b) {
 
     auto result_in_microseconds = (std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count());
     this->evaluation.milliseconds = ((long double) result_in_microseconds) / 1000;
+    this->evaluation.counters = mps_counters::read() - counters_start;
 
     return x;
 }
@@ -1953,6 +2314,10 @@ vector<mps> ira::irPLU_2(const vector<mps> &b) {
         this->evaluation.sum_milliseconds_u = 0.0;
         this->evaluation.sum_milliseconds_ur = 0.0;
     }
+
+    this->evaluation.counters_ul = {};
+    this->evaluation.counters_u = {};
+    this->evaluation.counters_ur = {};
     //-------------------------------
 
     // set precisions (for easier naming)
@@ -1962,14 +2327,16 @@ vector<mps> ira::irPLU_2(const vector<mps> &b) {
     vector<unsigned long> ul{this->parameters.ul_m_l, this->parameters.ul_e_l};
     //-------------------------------
 
-    // start timer
+    // start timer and counters
     //-------------------------------
     const auto start = std::chrono::high_resolution_clock::now();
+    const auto counters_start = mps_counters::read();
     //-------------------------------
 
     // perform PLU decomposition
     //-------------------------------
     const auto a1 = std::chrono::high_resolution_clock::now();
+    auto phase_start = mps_counters::read();
     this->decompPLU(ul[0], ul[1]);
     //-------------------------------
 
@@ -1977,12 +2344,13 @@ vector<mps> ira::irPLU_2(const vector<mps> &b) {
     //-------------------------------
     auto tmp_b = b;
     ira::cast(tmp_b, ul[0], ul[1]);
-    auto x = ira::permuteVector(this->P, tmp_b);
+    ira::permuteVector(this->P, tmp_b);
 
-    x = this->forwardSubstitution(x);
+    auto x = this->forwardSubstitution(tmp_b);
     x = this->backwardSubstitution(x);
     ira::cast(x, u[0], u[1]);
     const auto a2 = std::chrono::high_resolution_clock::now();
+    this->evaluation.counters_ul += mps_counters::read() - phase_start;
     this->evaluation.sum_milliseconds_ul += (long double) std::chrono::duration_cast<std::chrono::nanoseconds>(a2 - a1).count();
     //-------------------------------
 
@@ -1993,11 +2361,11 @@ vector<mps> ira::irPLU_2(const vector<mps> &b) {
         // in precision: ur
         //-------------------------------
         const auto b1 = std::chrono::high_resolution_clock::now();
-        auto x_in_ur = x;
-        ira::cast(x_in_ur, ur[0], ur[1]);
-        auto b_approx = ira::dotProduct(this->A, x_in_ur);
+        phase_start = mps_counters::read();
+        auto b_approx = ira::dotProduct(this->A, x, ur[0], ur[1], this->parameters.fused_multiply_add);
         auto r = subtract(b, b_approx);
         const auto b2 = std::chrono::high_resolution_clock::now();
+        this->evaluation.counters_ur += mps_counters::read() - phase_start;
         this->evaluation.sum_milliseconds_ur += (long double) std::chrono::duration_cast<std::chrono::nanoseconds>(b2 - b1).count();
         //-------------------------------
 
@@ -2006,11 +2374,13 @@ vector<mps> ira::irPLU_2(const vector<mps> &b) {
         // in precision: ul
         //-------------------------------
         const auto c1 = std::chrono::high_resolution_clock::now();
+        phase_start = mps_counters::read();
         ira::cast(r, ul[0], ul[1]);
-        r = ira::permuteVector(this->P, r);
+        ira::permuteVector(this->P, r);
         auto d = this->forwardSubstitution(r);
         d = this->backwardSubstitution(d);
         const auto c2 = std::chrono::high_resolution_clock::now();
+        this->evaluation.counters_ul += mps_counters::read() - phase_start;
         this->evaluation.sum_milliseconds_ul += (long double) std::chrono::duration_cast<std::chrono::nanoseconds>(c2 - c1).count();
         //-------------------------------
 
@@ -2019,9 +2389,10 @@ vector<mps> ira::irPLU_2(const vector<mps> &b) {
         // n precision u.
         //-------------------------------
         const auto d1 = std::chrono::high_resolution_clock::now();
-        ira::cast(d, u[0], u[1]);
-        x = add(x, d);
+        phase_start = mps_counters::read();
+        x = add(x, d, u[0], u[1]);
         const auto d2 = std::chrono::high_resolution_clock::now();
+        this->evaluation.counters_u += mps_counters::read() - phase_start;
         this->evaluation.sum_milliseconds_u += (long double) std::chrono::duration_cast<std::chrono::nanoseconds>(d2 - d1).count();
         //-------------------------------
 
@@ -2051,6 +2422,7 @@ vector<mps> ira::irPLU_2(const vector<mps> &b) {
 
     auto result_in_microseconds = (std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count());
     this->evaluation.milliseconds = ((long double) result_in_microseconds) / 1000;
+    this->evaluation.counters = mps_counters::read() - counters_start;
 
     this->evaluation.sum_milliseconds_ul /= 1000000;
     this->evaluation.sum_milliseconds_u /= 1000000;
@@ -2314,6 +2686,221 @@ unsigned long ira::get_max_U_idx(unsigned long column, unsigned long start) cons
     return max_row;
 }
 
+/**
+ * Performs the partial pivoting of an elimination step of decompPLU: exchanges row k with the row of the largest
+ * element of column k (below the diagonal) and records the interchange in P.
+ *
+ * @param k the elimination step
+ */
+void ira::pivotRow(unsigned long k) {
+
+    auto max_row = get_max_U_idx(k, k);
+
+    if(this->lu_combined){
+        this->U.swapRows(k, max_row);
+    } else {
+        interchangeRow(this->U, k, max_row, k, this->parameters.n);
+        interchangeRow(this->L, k, max_row, 0, k);
+    }
+
+    this->P[k] = max_row;
+}
+
+/**
+ * Performs the elimination step k of decompPLU on a range of rows: computes the multipliers of column k and subtracts
+ * the multiple of row k from the columns up to an end column.
+ * In place, the multiplier replaces the eliminated element (column k is not updated).
+ *
+ * @param k the elimination step
+ * @param first_row the first row
+ * @param last_row the row after the last row
+ * @param last_column the column after the last updated column
+ */
+void ira::eliminate(unsigned long k, unsigned long first_row, unsigned long last_row, unsigned long last_column) {
+
+    const bool in_place = this->lu_combined;
+
+    for(unsigned long j = first_row; j < last_row; j++){
+
+        auto& multiplier = in_place ? this->U[j][k] : this->L[j][k];
+        multiplier = this->U[j][k] / this->U[k][k];
+
+        for(unsigned long i = in_place ? k+1 : k; i < last_column; i++){
+
+            if(this->parameters.fused_multiply_add){
+                this->U[j][i].subtractProduct(multiplier, this->U[k][i]);
+            } else {
+                this->U[j][i] -= multiplier * this->U[k][i];
+            }
+        }
+    }
+}
+
+/**
+ * Performs the PLU decomposition of decompPLU in tiles of tile_size x tile_size elements. The operations on the tiles are
+ * tasks of a task graph, executed by setThreads threads (task_graph.h):
+ *  panel(p):           the pivot steps of the tile column p (on the rows from tile p on, only on its columns)
+ *  solve(p, J):        the row interchanges of panel p and the triangular solve on tile (p, J), for J > p
+ *  update(p, I, J):    the update of tile (I, J) with the tiles (I, p) and (p, J) (matrix product), for I, J > p
+ * A task only waits for the tasks that write the tiles it needs, so panel p + 1 starts as soon as the tile column p + 1
+ * is updated, while the updates of step p on the other columns still run (lookahead). Tasks of lower columns are taken
+ * first. The row interchanges of a panel on the columns to its left are applied at the end.
+ * Every element gets the same operations in the same order as with the unblocked decomposition.
+ *
+ * @param tile_size the number of rows and columns of a tile
+ */
+void ira::decompTiled(unsigned long tile_size) {
+
+    const auto n = this->parameters.n;
+    const auto tiles = (n + tile_size - 1) / tile_size;
+    const bool in_place = this->lu_combined;
+
+    auto tile_start = [&](unsigned long tile){ return tile * tile_size; };
+    auto tile_end = [&](unsigned long tile){ return std::min((tile + 1) * tile_size, n); };
+
+    // row interchanges of the steps of panel p on the columns [first_column, last_column)
+    auto interchange = [this, &tile_start, &tile_end](unsigned long p, mps_matrix& matrix, unsigned long first_column, unsigned long last_column){
+        for(unsigned long k = tile_start(p); k < tile_end(p); k++){
+            interchangeRow(matrix, k, this->P[k], first_column, last_column);
+        }
+    };
+
+    task_graph graph;
+    vector<unsigned long> previous_update(tiles * tiles);      // task of update(p-1, I, J) at I * tiles + J
+    vector<unsigned long> current_update(tiles * tiles);
+    vector<unsigned long> solve(tiles);
+    unsigned long panel = 0;
+
+    for(unsigned long p = 0; p < tiles; p++){
+
+        panel = graph.add([this, p, in_place, &tile_start, &tile_end](){
+
+            const auto first = tile_start(p);
+            const auto last = tile_end(p);
+
+            for(unsigned long k = first; k < last; k++){
+
+                auto max_row = get_max_U_idx(k, k);
+                this->P[k] = max_row;
+
+                if(in_place){
+                    interchangeRow(this->U, k, max_row, first, last);
+                } else {
+                    interchangeRow(this->U, k, max_row, k, last);
+                    interchangeRow(this->L, k, max_row, first, k);
+                }
+
+                this->eliminate(k, k + 1, this->parameters.n, last);
+            }
+        }, p);
+
+        for(unsigned long I = p; I < tiles && p > 0; I++){
+            graph.depend(panel, previous_update[I * tiles + p]);
+        }
+
+        for(unsigned long J = p + 1; J < tiles; J++){
+
+            solve[J] = graph.add([this, p, J, &interchange, &tile_start, &tile_end](){
+                interchange(p, this->U, tile_start(J), tile_end(J));
+                this->updateBlock(tile_start(p), tile_end(p), tile_start(p) + 1, tile_end(p), tile_start(J), tile_end(J));
+            }, J);
+
+            graph.depend(solve[J], panel);
+            for(unsigned long I = p; I < tiles && p > 0; I++){
+                graph.depend(solve[J], previous_update[I * tiles + J]);
+            }
+        }
+
+        for(unsigned long I = p + 1; I < tiles; I++){
+            for(unsigned long J = p + 1; J < tiles; J++){
+
+                current_update[I * tiles + J] = graph.add([this, p, I, J, &tile_start, &tile_end](){
+                    this->updateBlock(tile_start(p), tile_end(p), tile_start(I), tile_end(I), tile_start(J), tile_end(J));
+                }, J);
+
+                graph.depend(current_update[I * tiles + J], solve[J]);
+            }
+        }
+
+        std::swap(previous_update, current_update);
+    }
+
+    // row interchanges of the later panels on the columns of L (after all tasks that read them)
+    for(unsigned long J = 0; J + 1 < tiles; J++){
+
+        auto task = graph.add([this, J, tiles, in_place, &interchange, &tile_start, &tile_end](){
+            for(unsigned long p = J + 1; p < tiles; p++){
+                interchange(p, in_place ? this->U : this->L, tile_start(J), tile_end(J));
+            }
+        }, tiles + J);
+
+        graph.depend(task, panel);
+    }
+
+    graph.run(n * n < IRA_PARALLEL_MIN_ELEMENTS ? 1 : this->parameters.threads);
+}
+
+/**
+ * Applies the elimination steps [first_step, last_step) of decompPLU to a block of U, with the multipliers computed
+ * before. A row j is only updated by the steps before j. Every element gets the steps in ascending order, so the
+ * result is the same as with one elimination step after the other.
+ *
+ * @param first_step the first elimination step
+ * @param last_step the step after the last elimination step
+ * @param first_row the first row of the block
+ * @param last_row the row after the last row of the block
+ * @param first_column the first column of the block
+ * @param last_column the column after the last column of the block
+ */
+void ira::updateBlock(unsigned long first_step, unsigned long last_step, unsigned long first_row, unsigned long last_row, unsigned long first_column, unsigned long last_column) {
+
+    const auto& lower = this->lu_combined ? this->U : this->L;
+
+    for(unsigned long j = first_row; j < last_row; j++){
+        for(unsigned long k = first_step; k < std::min(last_step, j); k++){
+
+            const auto& multiplier = lower[j][k];
+
+            for(unsigned long i = first_column; i < last_column; i++){
+
+                if(this->parameters.fused_multiply_add){
+                    this->U[j][i].subtractProduct(multiplier, this->U[k][i]);
+                } else {
+                    this->U[j][i] -= multiplier * this->U[k][i];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Stores the result of an in-place decomposition in separate matrices L and U again (L gets its unit diagonal and the
+ * strict lower part of U is set to zero). Does nothing if the decomposition was not done in place.
+ */
+void ira::splitLU() {
+
+    if(!this->lu_combined){
+        return;
+    }
+    this->lu_combined = false;
+
+    if(this->U.empty()){
+        return;
+    }
+
+    mps zero(this->U[0][0].getMantisseLength(), this->U[0][0].getExponentLength(), 0);
+    mps one(this->U[0][0].getMantisseLength(), this->U[0][0].getExponentLength(), 1);
+
+    this->L = mps_matrix(this->U.size(), zero);
+    for(unsigned long row_idx = 0; row_idx < this->U.size(); row_idx++){
+        for(unsigned long col_idx = 0; col_idx < row_idx; col_idx++){
+            this->L[row_idx][col_idx] = std::move(this->U[row_idx][col_idx]);
+            this->U[row_idx][col_idx] = zero;
+        }
+        this->L[row_idx][row_idx] = one;
+    }
+}
+
 /**
  * Interchanges two rows of a given matrix.
  * A column index can be set to omit all elements before that index.
@@ -2325,7 +2912,7 @@ unsigned long ira::get_max_U_idx(unsigned long column, unsigned long start) cons
  * @param start the index of the starting column
  * @param start the index of the ending column
  */
-void ira::interchangeRow(vector<vector<mps>>& matrix, unsigned long row_one, unsigned long row_two, unsigned long start, unsigned long end) {
+void ira::interchangeRow(mps_matrix& matrix, unsigned long row_one, unsigned long row_two, unsigned long start, unsigned long end) {
 
     for(auto i = start; i < end; i++){
         auto tmp = matrix[row_one][i];
@@ -2335,22 +2922,20 @@ void ira::interchangeRow(vector<vector<mps>>& matrix, unsigned long row_one, uns
 }
 
 /**
- * Permutes a vector according to a permutation vector.
+ * Permutes a vector in place with the row interchanges of a PLU decomposition (like LAPACK's laswp).
  *
- * @param permutation_vector the permutation vector.
+ * @param pivots the row interchanges (step k: element k with element pivots[k]).
  * @param input_vector the vector that should be permuted.
- * @return the permuted vector.
  */
-vector<mps> ira::permuteVector(const vector<mps>& permutation_vector, const vector<mps>& input_vector) {
+void ira::permuteVector(const vector<unsigned long>& pivots, vector<mps>& input_vector) {
 
-    vector<mps> ret;
-    ret.resize(input_vector.size(), mps());
-
-    for(unsigned long i = 0; i < permutation_vector.size(); i++){
-        auto idx = (unsigned long) permutation_vector[i].getValue();
-        ret[i] |= input_vector[idx];
+    for(unsigned long k = 0; k < pivots.size(); k++){
+        if(pivots[k] != k){
+            // moves with |= (a moved from mps object has no format)
+            mps tmp(std::move(input_vector[k]));
+            input_vector[k] |= std::move(input_vector[pivots[k]]);
+            input_vector[pivots[k]] |= std::move(tmp);
+        }
     }
-
-    return ret;
 }
 //-------------------------------
\ No newline at end of file
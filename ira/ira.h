@@ -4,6 +4,8 @@
 
 #include <vector>
 #include "mps.h"
+#include "mps_counters.h"
+#include "mps_matrix.h"
 
 #ifndef MPS_IRA_H
 #define MPS_IRA_H
@@ -13,6 +15,15 @@
 
 class ira {
 
+public:
+
+    // algorithms of the PLU decomposition (setLUVariant)
+    enum class lu_variant {
+        unblocked,      // one elimination step after the other on the whole trailing matrix
+        blocked,        // panels of block size columns, triangular solve and matrix product update
+        tiled           // tiles of block size, the tile operations are scheduled as a task graph (lookahead)
+    };
+
 private:
 
     // parameters struct
@@ -24,6 +35,11 @@ private:
         double sparsity_rate;                   // percentage of zeros in the system matrix.
 
         unsigned long max_iter;                 // The maximal number of refinement steps.
+        bool fused_multiply_add;                // true if the inner loops use mps::fma (a single rounding).
+        bool in_place_lu;                       // true if decompPLU stores L in the strict lower part of U.
+        unsigned long threads;                  // threads of the decomposition (0: one per hardware thread).
+        lu_variant decomposition;               // the algorithm of the decomposition.
+        unsigned long lu_block_size;            // the number of columns of a panel of the blocked decomposition.
         unsigned long n;                        // dimension of the system
         unsigned long matrix_1D_size;           // The number of elements of the system matrix.
 
@@ -72,6 +88,14 @@ public:
         long double sum_milliseconds_u;
         long double sum_milliseconds_ur;
 
+        lu_variant lu_variant_used;             // the algorithm of the last decomposition
+
+        // gate level counts (only with MPS_COUNTERS, see mps_counters.h)
+        mps_counters::snapshot counters;        // whole refinement
+        mps_counters::snapshot counters_ul;     // decomposition and substitutions (precision ul)
+        mps_counters::snapshot counters_u;      // updates of the solution (precision u)
+        mps_counters::snapshot counters_ur;     // residuals (precision ur)
+
     } evaluation{};
     //-------------------------------
 
@@ -79,11 +103,12 @@ private:
 
     // variables
     //-------------------------------
-    vector<vector<mps>> A;              // the A which should be solved
+    mps_matrix A;                       // the A which should be solved
 
-    vector<vector<mps>> L;              // The resulting lower triangular Matrix after PLU decomposition.
-    vector<vector<mps>> U;              // The resulting upper triangular Matrix after PLU decomposition.
-    vector<mps> P;                      // The resulting permutation vector P after PLU decomposition.
+    mps_matrix L;                       // The resulting lower triangular Matrix after PLU decomposition.
+    mps_matrix U;                       // The resulting upper triangular Matrix after PLU decomposition.
+    vector<unsigned long> P;            // The row interchanges of the PLU decomposition (step k: row k with row P[k]).
+    bool lu_combined = false;           // true if L is stored in the strict lower part of U (unit diagonal, L empty).
     //-------------------------------
 
 public:
@@ -99,6 +124,11 @@ public:
     void setRandomRange(double lower_bound, double upper_bound);
     void setSparsityRate(double new_sparsity_rate);
     void setMaxIter(unsigned long new_max_iter);
+    void setFusedMultiplyAdd(bool enabled);
+    void setInPlaceLU(bool enabled);
+    void setThreads(unsigned long new_threads);
+    void setLUVariant(lu_variant new_variant);
+    void setBlockSize(unsigned long new_block_size);
     void setDimension(unsigned long new_dimension);
     void setLowerPrecision(unsigned long mantissa_length, unsigned long exponent_length);
     void setLowerPrecisionMantissa(unsigned long mantissa_length);
@@ -116,6 +146,11 @@ public:
     [[nodiscard]] vector<double> getRandomRange() const;
     [[nodiscard]] double getSparsityRate() const;
     [[nodiscard]] unsigned long getMaxIter() const;
+    [[nodiscard]] bool getFusedMultiplyAdd() const;
+    [[nodiscard]] bool getInPlaceLU() const;
+    [[nodiscard]] unsigned long getThreads() const;
+    [[nodiscard]] lu_variant getLUVariant() const;
+    [[nodiscard]] unsigned long getBlockSize() const;
     [[nodiscard]] unsigned long getDimension() const;
     [[nodiscard]] unsigned long get1DMatrixSize() const;
     [[nodiscard]] vector<unsigned long> getLowerPrecision() const;
@@ -161,10 +196,10 @@ public:
 
     // array converters
     //-------------------------------
-    [[nodiscard]] static vector<mps> double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, vector<double> double_vector);
-    [[nodiscard]] static vector<vector<mps>> double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, vector<vector<double>> double_matrix);
-    [[nodiscard]] static vector<double> mps_to_double(vector<mps> mps_vector);
-    [[nodiscard]] static vector<float> mps_to_float(vector<mps> mps_vector);
+    [[nodiscard]] static vector<mps> double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, const vector<double>& double_vector);
+    [[nodiscard]] static vector<vector<mps>> double_to_mps(unsigned long mantissa_length, unsigned long exponent_length, const vector<vector<double>>& double_matrix);
+    [[nodiscard]] static vector<double> mps_to_double(const vector<mps>& mps_vector);
+    [[nodiscard]] static vector<float> mps_to_float(const vector<mps>& mps_vector);
     //-------------------------------
 
     // generators
@@ -185,9 +220,13 @@ public:
     // operators
     //-------------------------------
     static vector<mps> add(const vector<mps>& a, const vector<mps>& b);
+    static vector<mps> add(const vector<mps>& a, const vector<mps>& b, unsigned long mantissa_length, unsigned long exponent_length);
     static vector<mps> subtract(const vector<mps>& a, const vector<mps>& b);
-    static vector<mps> dotProduct(const vector<vector<mps>>& D, const vector<mps>& x);
-    static vector<vector<mps>> dotProduct(const vector<vector<mps>>& A, const vector<vector<mps>>& B);
+    static vector<mps> dotProduct(const vector<vector<mps>>& D, const vector<mps>& x, bool fused = false);
+    static vector<mps> dotProduct(const vector<vector<mps>>& D, const vector<mps>& x, unsigned long mantissa_length, unsigned long exponent_length, bool fused = false);
+    static vector<mps> dotProduct(const mps_matrix& D, const vector<mps>& x, bool fused = false);
+    static vector<mps> dotProduct(const mps_matrix& D, const vector<mps>& x, unsigned long mantissa_length, unsigned long exponent_length, bool fused = false);
+    static vector<vector<mps>> dotProduct(const vector<vector<mps>>& A, const vector<vector<mps>>& B, bool fused = false);
 
     vector<mps> multiplyWithSystemMatrix(vector<mps> x) const;
     //-------------------------------
@@ -214,8 +253,13 @@ private:
     //-------------------------------
     [[nodiscard]] unsigned long get_idx(unsigned long row, unsigned long column) const;
     [[nodiscard]] unsigned long get_max_U_idx(unsigned long column, unsigned long start) const;
-    static void interchangeRow(vector<vector<mps>>& matrix, unsigned long row_one, unsigned long row_two, unsigned long start, unsigned long end) ;
-    [[nodiscard]] static vector<mps> permuteVector(const vector<mps> &permutation_vector, const vector<mps> &matrix);
+    void pivotRow(unsigned long k);
+    void eliminate(unsigned long k, unsigned long first_row, unsigned long last_row, unsigned long last_column);
+    void decompTiled(unsigned long tile_size);
+    void updateBlock(unsigned long first_step, unsigned long last_step, unsigned long first_row, unsigned long last_row, unsigned long first_column, unsigned long last_column);
+    void splitLU();
+    static void interchangeRow(mps_matrix& matrix, unsigned long row_one, unsigned long row_two, unsigned long start, unsigned long end) ;
+    static void permuteVector(const vector<unsigned long> &pivots, vector<mps> &input_vector);
     //-------------------------------
 
 };
@@ -0,0 +1,92 @@
+//
+// mps_matrix => square matrix of mps objects stored in one contiguous row-major array.
+//
+// The rows are addressed through a row table, so exchanging two rows only exchanges two indices. matrix[i] returns a
+// pointer to the first element of row i, so the elements are accessed like with vector<vector<mps>> (matrix[i][j]).
+//
+
+#ifndef MPS_MPS_MATRIX_H
+#define MPS_MPS_MATRIX_H
+
+#include <vector>
+#include <numeric>
+#include <utility>
+#include "mps.h"
+
+class mps_matrix {
+
+public:
+
+    mps_matrix() = default;
+
+    /**
+     * Creates an n x n matrix with all elements set to a value.
+     *
+     * @param n the dimension of the matrix
+     * @param value the value of all elements
+     */
+    mps_matrix(unsigned long n, const mps& value) : dimension(n), elements(n * n, value), rows(n) {
+        std::iota(this->rows.begin(), this->rows.end(), 0UL);
+    }
+
+    /**
+     * Sets the dimension of the matrix. The elements are only reallocated if the dimension changes, then they are
+     * empty mps objects (they get their format with |=).
+     *
+     * @param n the new dimension
+     */
+    void resize(unsigned long n){
+
+        if(n == this->dimension){
+            return;
+        }
+
+        this->dimension = n;
+        this->elements.clear();
+        this->elements.resize(n * n);
+        this->rows.resize(n);
+        std::iota(this->rows.begin(), this->rows.end(), 0UL);
+    }
+
+    /**
+     * Releases all elements.
+     */
+    void clear(){
+
+        this->dimension = 0;
+        vector<mps>().swap(this->elements);
+        vector<unsigned long>().swap(this->rows);
+    }
+
+    [[nodiscard]] unsigned long size() const {
+        return this->dimension;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return 0 == this->dimension;
+    }
+
+    mps* operator[](unsigned long row){
+        return this->elements.data() + this->rows[row] * this->dimension;
+    }
+
+    const mps* operator[](unsigned long row) const {
+        return this->elements.data() + this->rows[row] * this->dimension;
+    }
+
+    /**
+     * Exchanges two rows (only their entries in the row table).
+     */
+    void swapRows(unsigned long row_one, unsigned long row_two){
+        std::swap(this->rows[row_one], this->rows[row_two]);
+    }
+
+
+private:
+
+    unsigned long dimension = 0;
+    vector<mps> elements;               // the elements, row after row (in the order of the rows at the allocation)
+    vector<unsigned long> rows;         // the index of every row in the elements
+};
+
+#endif //MPS_MPS_MATRIX_H
@@ -0,0 +1,221 @@
+//
+// task_graph => tasks with dependencies, executed by a work-stealing scheduler.
+//
+// A task is started as soon as all its prerequisites are finished. Every thread has its own queue: the tasks released
+// by a finished task are pushed to the queue of the thread that finished it, which takes its newest task first, while
+// idle threads steal the oldest tasks of the other queues. Of the tasks released at once, the one with the lowest
+// priority value is taken first, so urgent tasks (e.g. the next panel of a factorization) run before the work that
+// does not block anything (lookahead).
+// The first exception thrown by a task is rethrown by run (the remaining tasks are still executed).
+//
+
+#ifndef MPS_TASK_GRAPH_H
+#define MPS_TASK_GRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class task_graph {
+
+public:
+
+    /**
+     * Adds a task.
+     *
+     * @param work the work of the task
+     * @param priority the lower the value, the earlier the task is taken when it is released with others
+     * @return the id of the task
+     */
+    unsigned long add(std::function<void()> work, unsigned long priority = 0){
+
+        this->tasks.emplace_back();
+        this->tasks.back().work = std::move(work);
+        this->tasks.back().priority = priority;
+
+        return this->tasks.size() - 1;
+    }
+
+    /**
+     * Lets a task wait for another one.
+     *
+     * @param task the id of the task
+     * @param prerequisite the id of the task that must be finished first
+     */
+    void depend(unsigned long task, unsigned long prerequisite){
+
+        this->tasks[prerequisite].successors.push_back(task);
+        this->tasks[task].remaining++;
+    }
+
+    [[nodiscard]] unsigned long size() const {
+        return this->tasks.size();
+    }
+
+    /**
+     * Executes all tasks and waits for them. The calling thread takes part.
+     *
+     * @param threads the number of threads including the calling thread (0: one per hardware thread)
+     */
+    void run(unsigned long threads){
+
+        if(0 == threads){
+            threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        threads = std::max(1UL, std::min(threads, (unsigned long) this->tasks.size()));
+
+        this->queues = std::vector<queue>(threads);
+        this->finished.store(0);
+        this->queued.store(0);
+        this->error = nullptr;
+
+        std::vector<unsigned long> ready;
+        for(unsigned long i = 0; i < this->tasks.size(); i++){
+            if(0 == this->tasks[i].remaining.load(std::memory_order_relaxed)){
+                ready.push_back(i);
+            }
+        }
+        this->push(0, ready);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for(unsigned long t = 1; t < threads; t++){
+            workers.emplace_back([this, t](){ this->workerLoop(t); });
+        }
+        this->workerLoop(0);
+
+        for(auto& worker : workers){
+            worker.join();
+        }
+
+        if(this->error){
+            std::rethrow_exception(this->error);
+        }
+    }
+
+
+private:
+
+    struct task {
+        std::function<void()> work;
+        std::vector<unsigned long> successors;
+        std::atomic<unsigned long> remaining{0};    // unfinished prerequisites
+        unsigned long priority = 0;
+    };
+
+    struct queue {
+        std::mutex lock;
+        std::deque<unsigned long> tasks;
+    };
+
+    std::deque<task> tasks;                     // (a deque does not move its elements)
+    std::vector<queue> queues;
+
+    std::atomic<unsigned long> finished{0};     // finished tasks
+    std::atomic<unsigned long> queued{0};       // tasks in the queues
+    std::mutex idle_lock;
+    std::condition_variable idle;               // a task was queued (or all are finished)
+
+    std::mutex error_lock;
+    std::exception_ptr error;
+
+    // pushes released tasks to the queue of a thread, the most urgent one last (it is taken first)
+    void push(unsigned long thread, std::vector<unsigned long>& ready){
+
+        if(ready.empty()){
+            return;
+        }
+
+        std::sort(ready.begin(), ready.end(), [this](unsigned long one, unsigned long two){
+            return this->tasks[one].priority > this->tasks[two].priority;
+        });
+
+        {
+            std::lock_guard<std::mutex> guard(this->queues[thread].lock);
+            this->queues[thread].tasks.insert(this->queues[thread].tasks.end(), ready.begin(), ready.end());
+        }
+        this->queued.fetch_add(ready.size());
+
+        std::lock_guard<std::mutex> guard(this->idle_lock);
+        this->idle.notify_all();
+    }
+
+    // takes the newest task of the own queue or steals the oldest task of another queue
+    bool take(unsigned long thread, unsigned long& task){
+
+        for(unsigned long i = 0; i < this->queues.size(); i++){
+
+            auto& victim = this->queues[(thread + i) % this->queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+
+            if(!victim.tasks.empty()){
+                if(0 == i){
+                    task = victim.tasks.back();
+                    victim.tasks.pop_back();
+                } else {
+                    task = victim.tasks.front();
+                    victim.tasks.pop_front();
+                }
+                this->queued.fetch_sub(1);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void execute(unsigned long thread, unsigned long id){
+
+        auto& current = this->tasks[id];
+
+        try {
+            current.work();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(this->error_lock);
+            if(!this->error){
+                this->error = std::current_exception();
+            }
+        }
+
+        std::vector<unsigned long> ready;
+        for(auto successor : current.successors){
+            if(1 == this->tasks[successor].remaining.fetch_sub(1, std::memory_order_acq_rel)){
+                ready.push_back(successor);
+            }
+        }
+        this->push(thread, ready);
+
+        if(this->finished.fetch_add(1) + 1 == this->tasks.size()){
+            std::lock_guard<std::mutex> guard(this->idle_lock);
+            this->idle.notify_all();
+        }
+    }
+
+    void workerLoop(unsigned long thread){
+
+        while(true){
+
+            unsigned long id;
+            if(this->take(thread, id)){
+                this->execute(thread, id);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(this->idle_lock);
+            this->idle.wait(guard, [this](){
+                return this->queued.load() > 0 || this->finished.load() == this->tasks.size();
+            });
+            if(this->finished.load() == this->tasks.size()){
+                return;
+            }
+        }
+    }
+};
+
+#endif //MPS_TASK_GRAPH_H
@@ -0,0 +1,159 @@
+//
+// thread_pool => fixed group of worker threads for parallel loops (fork-join).
+//
+// run(count, task) calls task(i) for every i in [0, count) and returns when all calls are done. The calling thread
+// takes part, so a pool of size t starts t - 1 workers. The tasks are handed out one by one through an atomic counter.
+// The first exception thrown by a task is rethrown by run (the remaining tasks are still executed).
+//
+
+#ifndef MPS_THREAD_POOL_H
+#define MPS_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class thread_pool {
+
+public:
+
+    /**
+     * Starts the workers.
+     *
+     * @param threads the number of threads including the calling thread (0: one per hardware thread)
+     */
+    explicit thread_pool(unsigned long threads){
+
+        if(0 == threads){
+            threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        this->workers.reserve(threads - 1);
+        for(unsigned long t = 1; t < threads; t++){
+            this->workers.emplace_back([this](){ this->workerLoop(); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool(){
+
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->stopping = true;
+        }
+        this->wake.notify_all();
+
+        for(auto& worker : this->workers){
+            worker.join();
+        }
+    }
+
+    /**
+     * Returns the number of threads (including the calling thread).
+     */
+    [[nodiscard]] unsigned long size() const {
+        return this->workers.size() + 1;
+    }
+
+    /**
+     * Calls task(i) for every i in [0, count) on all threads of the pool and waits for them.
+     *
+     * @param count the number of tasks
+     * @param task the task
+     */
+    void run(unsigned long count, const std::function<void(unsigned long)>& task){
+
+        if(this->workers.empty() || count <= 1){
+            for(unsigned long i = 0; i < count; i++){
+                task(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->current = &task;
+            this->task_count = count;
+            this->next_task.store(0, std::memory_order_relaxed);
+            this->pending = this->workers.size();
+            this->error = nullptr;
+            this->generation++;
+        }
+        this->wake.notify_all();
+
+        this->execute();
+
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->finished.wait(guard, [this](){ return 0 == this->pending; });
+        this->current = nullptr;
+
+        if(this->error){
+            std::rethrow_exception(this->error);
+        }
+    }
+
+
+private:
+
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable wake;               // a new loop was started (or the pool is stopped)
+    std::condition_variable finished;           // all workers are done with the current loop
+
+    const std::function<void(unsigned long)>* current = nullptr;
+    unsigned long task_count = 0;
+    std::atomic<unsigned long> next_task{0};
+    unsigned long pending = 0;                  // workers that are not done with the current loop
+    unsigned long long generation = 0;          // number of started loops
+    std::exception_ptr error;
+    bool stopping = false;
+
+    // takes tasks of the current loop until none are left
+    void execute(){
+
+        for(auto i = this->next_task.fetch_add(1); i < this->task_count; i = this->next_task.fetch_add(1)){
+            try {
+                (*this->current)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(this->lock);
+                if(!this->error){
+                    this->error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void workerLoop(){
+
+        unsigned long long seen = 0;
+
+        while(true){
+
+            {
+                std::unique_lock<std::mutex> guard(this->lock);
+                this->wake.wait(guard, [this, seen](){ return this->stopping || this->generation != seen; });
+                if(this->stopping){
+                    return;
+                }
+                seen = this->generation;
+            }
+
+            this->execute();
+
+            std::lock_guard<std::mutex> guard(this->lock);
+            if(0 == --this->pending){
+                this->finished.notify_one();
+            }
+        }
+    }
+};
+
+#endif //MPS_THREAD_POOL_H
@@ -0,0 +1,200 @@
+//
+// inline_vector => a vector for trivially copyable elements with inline storage for the first N elements.
+//
+// As long as the size does not exceed N, no memory is allocated on the heap. This is the case for the bit fields of
+// all common floating point formats (binary16 to binary128). Larger sizes use heap memory from the per thread cache of
+// scratch_arena.h, so temporaries of the same size reuse the memory of the previous ones.
+//
+
+#ifndef MPS_INLINE_VECTOR_H
+#define MPS_INLINE_VECTOR_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+
+#include "scratch_arena.h"
+
+template<typename T, unsigned long N>
+class inline_vector {
+
+    static_assert(std::is_trivially_copyable<T>::value, "inline_vector only supports trivially copyable types");
+    static_assert(N > 0, "inline_vector needs at least one inline element");
+
+public:
+
+    // constructors, assignment and destructor
+    //-------------------------------
+    inline_vector() : ptr(local), count(0), capacity(N) {}
+
+    explicit inline_vector(unsigned long size, const T& value = T()) : inline_vector() {
+        resize(size, value);
+    }
+
+    inline_vector(std::initializer_list<T> values) : inline_vector() {
+        reserve(values.size());
+        std::copy(values.begin(), values.end(), ptr);
+        count = values.size();
+    }
+
+    inline_vector(const inline_vector& other) : inline_vector() {
+        reserve(other.count);
+        std::copy(other.ptr, other.ptr + other.count, ptr);
+        count = other.count;
+    }
+
+    inline_vector(inline_vector&& other) noexcept : inline_vector() {
+        take(other);
+    }
+
+    inline_vector& operator=(const inline_vector& other){
+
+        if(this != &other){
+            reserve(other.count);
+            std::copy(other.ptr, other.ptr + other.count, ptr);
+            count = other.count;
+        }
+
+        return *this;
+    }
+
+    inline_vector& operator=(inline_vector&& other) noexcept {
+
+        if(this != &other){
+            release();
+            take(other);
+        }
+
+        return *this;
+    }
+
+    ~inline_vector(){
+        release();
+    }
+    //-------------------------------
+
+
+    // element access
+    //-------------------------------
+    T& operator[](unsigned long idx){ return ptr[idx]; }
+    const T& operator[](unsigned long idx) const { return ptr[idx]; }
+
+    T& back(){ return ptr[count - 1]; }
+    const T& back() const { return ptr[count - 1]; }
+
+    T* data(){ return ptr; }
+    const T* data() const { return ptr; }
+
+    T* begin(){ return ptr; }
+    T* end(){ return ptr + count; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    //-------------------------------
+
+
+    // capacity
+    //-------------------------------
+    [[nodiscard]] unsigned long size() const { return count; }
+    [[nodiscard]] bool empty() const { return 0 == count; }
+
+    /**
+     * Returns true if the elements are stored inside the object (no heap memory in use).
+     */
+    [[nodiscard]] bool isInline() const { return ptr == local; }
+
+    void reserve(unsigned long new_capacity){
+
+        if(new_capacity <= capacity){
+            return;
+        }
+
+        std::size_t bytes = std::max(new_capacity, 2 * capacity) * sizeof(T);
+        T* tmp = static_cast<T*>(scratch_arena::allocate(bytes));
+        std::copy(ptr, ptr + count, tmp);
+
+        if(ptr != local){
+            scratch_arena::deallocate(ptr, capacity * sizeof(T));
+        }
+        ptr = tmp;
+        capacity = bytes / sizeof(T);
+    }
+    //-------------------------------
+
+
+    // modifiers
+    //-------------------------------
+    void clear(){
+        count = 0;
+    }
+
+    void resize(unsigned long new_size, const T& value = T()){
+
+        if(new_size > count){
+            reserve(new_size);
+            std::fill(ptr + count, ptr + new_size, value);
+        }
+        count = new_size;
+    }
+
+    void push_back(const T& value){
+
+        if(count == capacity){
+            reserve(count + 1);
+        }
+        ptr[count++] = value;
+    }
+
+    void pop_back(){
+        count--;
+    }
+
+    bool operator==(const inline_vector& other) const {
+        return count == other.count && std::equal(ptr, ptr + count, other.ptr);
+    }
+
+    bool operator!=(const inline_vector& other) const {
+        return !(*this == other);
+    }
+    //-------------------------------
+
+
+private:
+
+    T local[N];
+    T* ptr;
+    unsigned long count;
+    unsigned long capacity;
+
+    // frees the heap memory (if used) and returns to the inline storage
+    void release(){
+
+        if(ptr != local){
+            scratch_arena::deallocate(ptr, capacity * sizeof(T));
+        }
+        ptr = local;
+        count = 0;
+        capacity = N;
+    }
+
+    // takes over the elements of other (which must not use heap memory of this object) and leaves it empty
+    void take(inline_vector& other){
+
+        if(other.ptr != other.local){
+            ptr = other.ptr;
+            capacity = other.capacity;
+            count = other.count;
+
+            other.ptr = other.local;
+            other.capacity = N;
+            other.count = 0;
+        } else {
+            std::copy(other.local, other.local + other.count, local);
+            ptr = local;
+            capacity = N;
+            count = other.count;
+            other.count = 0;
+        }
+    }
+};
+
+#endif //MPS_INLINE_VECTOR_H
@@ -1,9 +1,59 @@
 #include "mps.h"
+#include "mps_counters.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
+#include <thread>
 
 #include <sstream>
 
+#ifndef MPS_DEFAULT_ENGINE
+#define MPS_DEFAULT_ENGINE reference
+#endif
+
+#ifndef MPS_BATCH_PARALLEL_THRESHOLD
+#define MPS_BATCH_PARALLEL_THRESHOLD 16384      // values per thread of the batch conversions
+#endif
+
+
+// arithmetic engines
+//-------------------------------
+std::atomic<mps::engine> mps::arithmetic_engine(mps::engine::MPS_DEFAULT_ENGINE);
+
+/**
+ * Selects the engine used for the arithmetic operations and comparisons of all mps objects.
+ * The reference and packed engines produce the same results. The default is set by the build (MPS_DEFAULT_ENGINE).
+ *
+ * The native engine uses the hardware for binary32 and binary64 and produces the same results as the reference engine.
+ * The operations whose results the hardware computes differently (mps_native.cpp) and all other formats are computed by
+ * the packed engine.
+ *
+ * The sliced engine computes the vector operations of ira (add, subtract) for many values at once on bit planes
+ * (mps_sliced.h), with the integer kernels of the packed engine. Single operations use the reference engine.
+ *
+ * The analytic engine computes the results with the packed engine and charges the operation counters (mps_counters.h)
+ * with the exact work of the reference engine, computed by a cost model (mps_cost.cpp). Formats with mantissas longer
+ * than 62 bits are computed by the reference engine itself. Without MPS_COUNTERS it is the packed engine.
+ *
+ * Info: The packed engine falls back to the reference engine for exponents longer than 62 bits.
+ *
+ * @param new_engine the engine which should be used
+ */
+void mps::setEngine(mps::engine new_engine){
+    arithmetic_engine.store(new_engine, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the engine used for the arithmetic operations and comparisons.
+ *
+ * @return the selected engine
+ */
+mps::engine mps::getEngine(){
+    return arithmetic_engine.load(std::memory_order_relaxed);
+}
+//-------------------------------
+
+
 // constructors and destructor
 //-------------------------------
 
@@ -75,6 +125,24 @@ mps::mps(){
     this->exponent_length = 0;
 
     this->sign = false;
+    this->classification = value_class::nan;
+}
+
+/**
+ * Copy constructor.
+ */
+mps::mps(const mps& other) = default;
+
+/**
+ * Move constructor. The storage of the other object is taken over, the other object is left empty (like a default
+ * constructed one, it takes over the format of the next object assigned to it).
+ */
+mps::mps(mps&& other) noexcept :
+        mantissa_length(other.mantissa_length), exponent_length(other.exponent_length), sign(other.sign),
+        exponent(std::move(other.exponent)), mantissa(std::move(other.mantissa)),
+        classification(other.classification) {
+
+    other.clear();
 }
 
 /**
@@ -102,7 +170,7 @@ mps::~mps() = default;
  * @return the mantissa
  */
 [[nodiscard]] vector<bool> mps::getMantissa() const{
-    return this->mantissa;
+    return this->mantissa.toVector();
 }
 
 /**
@@ -111,7 +179,7 @@ mps::~mps() = default;
  * @return the mantissa
  */
 [[nodiscard]] vector<bool> mps::getExponent() const{
-    return this->exponent;
+    return this->exponent.toVector();
 }
 
 /**
@@ -161,6 +229,39 @@ vector<bool> mps::getBitArray() const {
     return ret;
 }
 
+/**
+ * Returns a read view of the packed words of the mantissa (no copy).
+ * The view is valid as long as this mps object is neither changed nor destroyed.
+ *
+ * @return view of the mantissa
+ */
+[[nodiscard]] bits_view mps::getMantissaView() const {
+    return this->mantissa.view();
+}
+
+/**
+ * Returns a read view of the packed words of the exponent (no copy).
+ * The view is valid as long as this mps object is neither changed nor destroyed.
+ *
+ * @return view of the exponent
+ */
+[[nodiscard]] bits_view mps::getExponentView() const {
+    return this->exponent.view();
+}
+
+/**
+ * Writes the bit array (sign + exponent + mantissa) into a buffer, one byte per bit.
+ *
+ * @param out buffer for getBitArrayLength() bytes
+ * @param zero value of a zero bit (a one bit is zero + 1), e.g. '0' for characters
+ */
+void mps::getBitArray(unsigned char* out, unsigned char zero) const {
+
+    out[0] = (unsigned char) (zero + this->sign);
+    this->exponent.view().unpack(out + 1, zero);
+    this->mantissa.view().unpack(out + 1 + this->exponent_length, zero);
+}
+
 /**
  * Calculates the value of the floating point object as double.
  *
@@ -180,38 +281,40 @@ double mps::getValue() const {
     }
 
 
-    double ret;
-
-    // positive or negative
-    if(this->sign){
-        ret = -1;
-    } else {
-        ret = 1;
+    // significand (1.b1...b52)
+    // Longer mantissas are rounded on the 53rd bit (ties to even), the following bits are ignored.
+    //-------------------------------
+    uint64_t head = 0 == mantissa_length ? 0 : mantissa.data()[0];
+    uint64_t significand = (((uint64_t) 1) << 52) | (head >> 12);
+    if(((head >> 11) & 1) && (significand & 1)){
+        significand++;
     }
+    double ret = std::ldexp((double) significand, -52);
+    //-------------------------------
 
-    // handle mantissa
-    for(unsigned long i = 0; i < mantissa_length; i++){
-        if(mantissa[i]){
-            if(ret >= 0){
-                ret += pow(0.5, i + 1);
-            } else {
-                ret -= pow(0.5, i + 1);
-            }
-        }
-    }
 
-    // get exponent
-    long exp = 0;
-    for(unsigned long i = 0; i < exponent_length; i++){
-        if(this->exponent[i]){
-            exp += (long) pow(2, exponent_length-i-1);
+    // exponent (the bias removed)
+    //-------------------------------
+    long exp;
+    if(exponent_length <= 62){
+        exp = (long) exponent.toInt() - getBias();
+    } else {
+        // The field is 2^(E-1) + exp - 1, so exp - 1 is the two's complement of the lower bits with the inverted
+        // first bit as sign. Values outside the range of double saturate.
+        const long limit = 1L << 20;
+        long offset = this->exponent[0] ? 0 : -1;
+        for(unsigned long i = 1; i < exponent_length; i++){
+            offset = std::clamp(2 * offset + (long) this->exponent[i], -limit, limit);
         }
+        exp = offset + 1;
     }
+    //-------------------------------
 
-    // apply bias and apply exponent
-    exp -= getBias();
+    if(this->sign){
+        ret = -ret;
+    }
 
-    return ret * pow(2, exp);
+    return ret * std::ldexp(1.0, (int) std::clamp(exp, -4096L, 4096L));
 }
 
 
@@ -222,20 +325,7 @@ double mps::getValue() const {
  * @return true if zero
  */
 bool mps::isZero() const{
-
-    for(unsigned long i = 0; i < this->exponent_length; i++){
-        if(this->exponent[i]){
-            return false;
-        }
-    }
-
-    for(unsigned long i = 0; i < this->mantissa_length; i++){
-        if(this->mantissa[i]){
-            return false;
-        }
-    }
-
-    return true;
+    return value_class::zero == this->classification;
 }
 
 /**
@@ -244,21 +334,7 @@ bool mps::isZero() const{
  * @return true if pos. or neg. infinity
  */
 bool mps::isInf() const{
-
-
-    for(unsigned long i = 0; i < this->exponent_length; i++){
-        if(!this->exponent[i]){
-            return false;
-        }
-    }
-
-    for(unsigned long i = 0; i < this->mantissa_length; i++){
-        if(this->mantissa[i]){
-            return false;
-        }
-    }
-
-    return true;
+    return value_class::inf == this->classification;
 }
 
 /**
@@ -282,26 +358,7 @@ bool mps::isPositive() const{
  * @return true if NaN
  */
 bool mps::isNaN() const{
-
-    for(unsigned long i = 0; i < exponent_length; i++){
-
-        if(!exponent[i]){
-            return false;
-        }
-    }
-
-    if(!mantissa[0]){
-        return false;
-    }
-
-    for(unsigned long i = 1; i < mantissa_length; i++){
-
-        if(mantissa[i]){
-            return false;
-        }
-    }
-
-    return true ;
+    return value_class::nan == this->classification;
 }
 
 /**
@@ -312,14 +369,8 @@ bool mps::isNaN() const{
  */
 std::string mps::print() const {
 
-    std::string str;
-    for(bool bit : this->getBitArray()){
-        if(bit){
-            str.append("1");
-        } else {
-            str.append("0");
-        }
-    }
+    std::string str(this->getBitArrayLength(), '0');
+    this->getBitArray((unsigned char*) str.data(), '0');
 
     return str;
 }
@@ -350,7 +401,12 @@ std::string mps::toString(const int precision) const {
  * So if the two mantissas are different of a magnitude smaller than the precision specified, the function returns true.
  *
  *
- * The two mps objects must have the same mantissa length and exponent length.
+ * The largest allowed error is 2^(exponent of compare - precision - 1). Its exponent is computed on the packed words.
+ * Prints a WARNING if the biased exponent of this error is negative or larger than the bias (then the values must
+ * match exactly).
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
  *
  * @param compare the mps object to which "this" mps object should be compared to
  * @param precision up to which precision the mps objects should be compared
@@ -358,28 +414,32 @@ std::string mps::toString(const int precision) const {
  */
 [[nodiscard]] bool mps::checkPrecision(const mps& compare, unsigned long precision) const {
 
-    vector<bool> max_error_exponent;
-    max_error_exponent.reserve(this->exponent_length);
-    for(auto i = precision; i > 0; i /= 2){
-        max_error_exponent.insert(max_error_exponent.begin(), i % 2);
+    if (this->exponent_length != compare.exponent_length) {
+        throw std::invalid_argument("ERROR: in checkPrecision : Exponents do not match");
     }
-    for(auto i = max_error_exponent.size(); i < this->exponent_length; i++){
-        max_error_exponent.insert(max_error_exponent.begin(), false);
+    if (this->mantissa_length != compare.mantissa_length) {
+        throw std::invalid_argument("ERROR: in checkPrecision : Mantissas do not match");
     }
 
-    addOneToBinary(&max_error_exponent);
-    max_error_exponent = binarySubtraction(compare.exponent, max_error_exponent);
+    // the largest allowed error is 2^(exponent of compare - precision - 1)
+    packed_bits distance(std::min<unsigned long>(this->exponent_length, packed_bits::word_size));
+    distance.fromInt(precision + 1);
+    distance.insert(distance.begin(), this->exponent_length - distance.size(), false);
 
+    const bool fits = this->exponent_length >= packed_bits::word_size || 0 == (precision + 1) >> this->exponent_length;
+    const auto first_difference = compare.exponent.mismatch(distance);
 
     mps max_error = mps(this->mantissa_length, this->exponent_length);
     max_error.setZero(false);
 
-    if(not max_error_exponent[0]){ // if overflow happened
-        max_error.setExponent(max_error_exponent);
-    } else {
+    auto max_error_exponent = packed_bits::absoluteDifference(compare.exponent, distance);
+    const bool negative = first_difference < this->exponent_length && !compare.exponent[first_difference];
+
+    if(!fits || negative || max_error_exponent[0]){
         cout << "WARNING: checkPrecision: value to small to check precision properly!\n";
-        max_error_exponent.resize(this->exponent_length, false);
-        max_error_exponent.back() = true;
+    } else {
+        max_error.exponent = max_error_exponent;
+        max_error.updateClassification();
     }
 
     auto diff = *this - compare;
@@ -397,6 +457,8 @@ std::string mps::toString(const int precision) const {
  * A high level definition of the precision is the number of matching mantissa bits from left to right.
  * However, this is not a completely correct definition.
  *
+ * The differences are computed on the packed words (count leading zeros), so any mantissa and exponent length works.
+ *
  * Prints a WARNING when NaNs or Infinities are involved except if both mps objects are the same.
  *
  * Throws Exception:    When the mantissas do not match.
@@ -428,71 +490,54 @@ std::string mps::toString(const int precision) const {
         return numeric_limits<long long>::max() * -1;
     }
 
-    auto exponent_this = (long long) binaryToInt(this->exponent);
-    auto exponent_compare = (long long) binaryToInt(compare.exponent);
+    const auto E = this->exponent_length;
+    const auto M = this->mantissa_length;
 
-    long long precision_error = 0;
+    auto first_difference = this->exponent.mismatch(compare.exponent);
 
-    if(exponent_this == exponent_compare){
+    if(first_difference == E){
 
-        auto mantissa_this = (long long) binaryToInt(this->mantissa);
-        auto mantissa_compare = (long long) binaryToInt(compare.mantissa);
-
-        if(mantissa_this == mantissa_compare){
-            return (long long) compare.mantissa_length;
-        }
-
-        precision_error = (long long) floor(log2(abs(mantissa_this - mantissa_compare))) + 1;
-
-
-    } else if (1 == exponent_this - exponent_compare){
-
-        auto copy_this = this->mantissa;
-        copy_this.insert(copy_this.begin(), true);
-
-        auto copy_compare = compare.mantissa;
-        copy_compare.insert(copy_compare.begin(), {false, true});
-        copy_compare.pop_back();
-
-        auto mantissa_compare = (long long) binaryToInt(copy_compare);
-        auto mantissa_this = (long long) binaryToInt(copy_this);
-
-        precision_error = (long long) floor(log2(abs(mantissa_this - mantissa_compare))) + 1;
-
-    } else if(1 == exponent_compare - exponent_this) {
+        // the matching bits are the leading zeros of the difference of the mantissas
+        return (long long) packed_bits::absoluteDifference(this->mantissa, compare.mantissa).leadingZeros();
+    }
 
-        auto copy_compare = compare.mantissa;
-        copy_compare.insert(copy_compare.begin(), true);
+    const bool this_larger = this->exponent[first_difference];
+    auto exponent_difference = packed_bits::absoluteDifference(this->exponent, compare.exponent);
+    auto exponent_difference_zeros = exponent_difference.leadingZeros();
 
-        auto copy_this = this->mantissa;
-        copy_this.insert(copy_this.begin(), {false, true});
-        copy_this.pop_back();
+    if(exponent_difference_zeros == E - 1){
 
-        auto mantissa_compare = (long long) binaryToInt(copy_compare);
-        auto mantissa_this = (long long) binaryToInt(copy_this);
+        // the exponents differ by one: align the smaller mantissa (with its hidden bit) to the larger one
+        const auto& larger = this_larger ? *this : compare;
+        const auto& smaller = this_larger ? compare : *this;
 
-        precision_error = (long long) floor(log2(abs(mantissa_this - mantissa_compare))) + 1;
+        auto copy_larger = larger.mantissa;
+        copy_larger.insert(copy_larger.begin(), true);
 
-    } else {
+        auto copy_smaller = smaller.mantissa;
+        copy_smaller.insert(copy_smaller.begin(), {false, true});
+        copy_smaller.pop_back();
 
-        if(exponent_compare > exponent_this){
-            return 0;
-        } else {
+        // M + 1 bits are compared, M bits are counted
+        return (long long) packed_bits::absoluteDifference(copy_larger, copy_smaller).leadingZeros() - 1;
+    }
 
-            auto difference = abs(exponent_compare - exponent_this);
+    if(!this_larger){
+        return 0;
+    }
 
-            for(unsigned long i = 0; i < (unsigned long) difference; i++){
-                if(this->mantissa[i]){
-                    difference++;
-                    break;
-                }
-            }
+    // the difference of the exponents (saturated to the range of the return value)
+    long long difference = numeric_limits<long long>::max() - 1;
+    if(E - exponent_difference_zeros < packed_bits::word_size - 1){
+        exponent_difference.erase(exponent_difference.begin(), exponent_difference.begin() + (long) exponent_difference_zeros);
+        difference = (long long) exponent_difference.toInt();
+    }
 
-            return difference * -1;
-        }
+    if((long long) this->mantissa.leadingZeros() < std::min(difference, (long long) M)){
+        difference++;
     }
 
-    return ((long long) compare.mantissa_length) - precision_error;
+    return difference * -1;
 }
 
 /**
@@ -605,6 +650,8 @@ void mps::setInf(bool negative) {
     for(unsigned long i = 0; i < mantissa_length; i++){
         mantissa[i] = false;
     }
+
+    classification = value_class::inf;
 }
 
 /**
@@ -627,6 +674,8 @@ void mps::setZero(bool negative){
     for(unsigned long i = 0; i < mantissa_length; i++){
         mantissa[i] = false;
     }
+
+    classification = value_class::zero;
 }
 
 /**
@@ -657,6 +706,8 @@ void mps::setNaN(bool negative){
     for(unsigned long i = 1; i < mantissa_length; i++){
         mantissa[i] = false;
     }
+
+    classification = value_class::nan;
 }
 
 /**
@@ -684,6 +735,8 @@ void mps::setMantissa(vector<bool>& new_mantissa){
     for(unsigned long i = 0; i < new_mantissa.size(); i++){
         this->mantissa[i] = new_mantissa[i];
     }
+
+    updateClassification();
 }
 
 /**
@@ -702,6 +755,8 @@ void mps::setExponent(vector<bool>& new_exponent){
     for(unsigned long i = 0; i < new_exponent.size(); i++){
         this->exponent[i] = new_exponent[i];
     }
+
+    updateClassification();
 }
 //-------------------------------
 
@@ -753,19 +808,9 @@ void mps::cast(const unsigned long new_mantissa_size, const unsigned long new_ex
     //-------------------------------
     if(new_exponent_size > this->exponent_length){
 
-        if((this->exponent)[0] || this->isZero()){    // positive exponent case
-
-            for(auto i = this->exponent_length; i < new_exponent_size; i++){
-                this->exponent.insert(this->exponent.begin()+1, false);
-            }
-
-        } else {    // negative exponent case
-
-            for(auto i = this->exponent_length; i < new_exponent_size; i++){
-                this->exponent.insert(this->exponent.begin()+1, true);
-            }
-
-        }
+        // the new bits are inserted after the first bit (positive exponent: zeros, negative exponent: ones)
+        bool fill = !((this->exponent)[0] || this->isZero());
+        this->exponent.insert(this->exponent.begin()+1, new_exponent_size - this->exponent_length, fill);
 
         this->exponent_length = new_exponent_size;
 
@@ -810,9 +855,7 @@ void mps::cast(const unsigned long new_mantissa_size, const unsigned long new_ex
         // ------------------------------------------------------
 
 
-        for(auto i = new_exponent_size; i < this->exponent_length; i++){
-            this->exponent.erase(this->exponent.begin()+1);
-        }
+        this->exponent.erase(this->exponent.begin()+1, this->exponent.begin()+1+(long)(this->exponent_length - new_exponent_size));
 
         this->exponent_length = new_exponent_size;
         //-------------------------------
@@ -823,9 +866,7 @@ void mps::cast(const unsigned long new_mantissa_size, const unsigned long new_ex
     //-------------------------------
     if(new_mantissa_size > this->mantissa_length){
 
-        for(unsigned long i = this->mantissa_length; i < new_mantissa_size; i++){
-            this->mantissa.push_back(false);
-        }
+        this->mantissa.resize(new_mantissa_size, false);
         this->mantissa_length = new_mantissa_size;
 
     } else if(new_mantissa_size < this->mantissa_length) {
@@ -834,6 +875,8 @@ void mps::cast(const unsigned long new_mantissa_size, const unsigned long new_ex
         this->mantissa_length = new_mantissa_size;
     }
     //-------------------------------
+
+    updateClassification();
 }
 
 /**
@@ -872,6 +915,206 @@ void mps::resize_mps_object(const unsigned long new_mantissa_size, const unsigne
 //-------------------------------
 
 
+// batch conversion
+//-------------------------------
+namespace {
+
+    /**
+     * Calls work(first, last) for consecutive chunks of [0, n). Large inputs are split over the hardware threads.
+     */
+    template<typename F>
+    void forEachChunk(size_t n, const F& work){
+
+        size_t threads = std::max(1U, std::thread::hardware_concurrency());
+        threads = std::min(threads, n / MPS_BATCH_PARALLEL_THRESHOLD);
+        if(threads <= 1){
+            work((size_t) 0, n);
+            return;
+        }
+
+        auto chunk = (n + threads - 1) / threads;
+        vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for(size_t t = 1; t < threads; t++){
+            workers.emplace_back([&work, t, chunk, n](){ work(std::min(t * chunk, n), std::min((t + 1) * chunk, n)); });
+        }
+        work((size_t) 0, chunk);
+
+        for(auto& worker : workers){
+            worker.join();
+        }
+    }
+}
+
+/**
+ * Converts an array of doubles into mps objects of the given format (the same bit patterns as the constructor).
+ * The output objects must exist already, their previous format does not matter.
+ * Large arrays are converted in parallel.
+ *
+ * Throws Exception:    When the mantissa length is too small.
+ *                      When the exponent length is too small.
+ *
+ * @param values pointer to the first value
+ * @param n number of values
+ * @param out pointer to the first of n mps objects
+ * @param mantissa_length mantissa length of the result
+ * @param exponent_length exponent length of the result
+ */
+void mps::fromDoubles(const double* values, size_t n, mps* out, unsigned long mantissa_length, unsigned long exponent_length){
+
+    if (mantissa_length <= 0) {
+        throw std::invalid_argument("ERROR: in fromDoubles : mantissa size too small");
+    }
+    if (exponent_length <= 1) {
+        throw std::invalid_argument("ERROR: in fromDoubles : exponent size too small");
+    }
+
+    forEachChunk(n, [&](size_t first, size_t last){
+        for(auto i = first; i < last; i++){
+            out[i].mantissa_length = mantissa_length;
+            out[i].exponent_length = exponent_length;
+            out[i].setValue(values[i]);
+        }
+    });
+}
+
+/**
+ * Converts an array of floats into mps objects of the given format (see fromDoubles).
+ *
+ * @param values pointer to the first value
+ * @param n number of values
+ * @param out pointer to the first of n mps objects
+ * @param mantissa_length mantissa length of the result
+ * @param exponent_length exponent length of the result
+ */
+void mps::fromFloats(const float* values, size_t n, mps* out, unsigned long mantissa_length, unsigned long exponent_length){
+
+    if (mantissa_length <= 0) {
+        throw std::invalid_argument("ERROR: in fromFloats : mantissa size too small");
+    }
+    if (exponent_length <= 1) {
+        throw std::invalid_argument("ERROR: in fromFloats : exponent size too small");
+    }
+
+    forEachChunk(n, [&](size_t first, size_t last){
+        for(auto i = first; i < last; i++){
+            out[i].mantissa_length = mantissa_length;
+            out[i].exponent_length = exponent_length;
+            out[i].setValue(values[i]);
+        }
+    });
+}
+
+/**
+ * Writes the values (getValue) of an array of mps objects into an array of doubles.
+ * Large arrays are converted in parallel.
+ *
+ * @param values pointer to the first mps object
+ * @param n number of objects
+ * @param out pointer to the first of n doubles
+ */
+void mps::toDoubles(const mps* values, size_t n, double* out){
+
+    forEachChunk(n, [&](size_t first, size_t last){
+        for(auto i = first; i < last; i++){
+            out[i] = values[i].getValue();
+        }
+    });
+}
+
+/**
+ * Writes the values of an array of mps objects into an array of floats (getValue rounded to float).
+ *
+ * @param values pointer to the first mps object
+ * @param n number of objects
+ * @param out pointer to the first of n floats
+ */
+void mps::toFloats(const mps* values, size_t n, float* out){
+
+    forEachChunk(n, [&](size_t first, size_t last){
+        for(auto i = first; i < last; i++){
+            out[i] = (float) values[i].getValue();
+        }
+    });
+}
+
+/**
+ * Writes the bit arrays of an array of mps objects into one buffer (row after row, one byte per bit, see getBitArray).
+ * Large arrays are written in parallel.
+ *
+ * Throws Exception:    When the formats of the objects do not match.
+ *
+ * @param values pointer to the first mps object
+ * @param n number of objects
+ * @param out buffer for n * getBitArrayLength() bytes
+ */
+void mps::toBitArrays(const mps* values, size_t n, unsigned char* out){
+
+    if(0 == n){
+        return;
+    }
+
+    const auto length = values[0].getBitArrayLength();
+    for(size_t i = 1; i < n; i++){
+        if(values[i].mantissa_length != values[0].mantissa_length || values[i].exponent_length != values[0].exponent_length){
+            throw std::invalid_argument("ERROR: in toBitArrays : formats do not match");
+        }
+    }
+
+    forEachChunk(n, [&](size_t first, size_t last){
+        for(auto i = first; i < last; i++){
+            values[i].getBitArray(out + i * length);
+        }
+    });
+}
+//-------------------------------
+
+
+// classification
+//-------------------------------
+/**
+ * Sets the class of the value (normal, zero, infinity or NaN) according to the bit array.
+ * Must be called whenever the bits are changed directly, e.g. by the arithmetic kernels.
+ */
+void mps::updateClassification(){
+
+    if(this->exponent.allSet()){
+
+        if(this->mantissa.noneSet()){
+            this->classification = value_class::inf;
+            return;
+        }
+
+        // NaN: the mantissa must be 100...0
+        auto words = this->mantissa.data();
+        bool nan = words[0] == ((packed_bits::word) 1) << (packed_bits::word_size - 1);
+        for(unsigned long i = 1; nan && i < this->mantissa.wordCount(); i++){
+            nan = 0 == words[i];
+        }
+
+        this->classification = nan ? value_class::nan : value_class::normal;
+
+    } else if(this->exponent.noneSet() && this->mantissa.noneSet()){
+        this->classification = value_class::zero;
+    } else {
+        this->classification = value_class::normal;
+    }
+}
+
+/**
+ * Sets the class of a result of an arithmetic kernel and returns it.
+ *
+ * @param value the result of the kernel
+ * @return the classified result
+ */
+mps mps::classified(mps value){
+
+    value.updateClassification();
+    return value;
+}
+//-------------------------------
+
+
 // operators
 //-------------------------------
 
@@ -886,6 +1129,10 @@ mps& mps::operator=(double value){
 
 /**
  * Sets one mps object equal to another mps object.
+ * An empty object (default constructed or moved from) takes over the format of the other object.
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
  */
 mps& mps::operator=(const mps& other) {
 
@@ -893,22 +1140,77 @@ mps& mps::operator=(const mps& other) {
         return *this;
     }
 
+    this->checkAssignment(other);
+
+    this->sign = other.sign;
+    this->mantissa = other.mantissa;
+    this->exponent = other.exponent;
+    this->classification = other.classification;
+
+    return *this;
+}
+
+/**
+ * Sets one mps object equal to a temporary mps object. The storage of the temporary object is taken over, the
+ * temporary object is left empty. An empty object (default constructed or moved from) takes over the format of the
+ * other object, so std::swap, std::sort and the like work on mps objects.
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
+ */
+mps& mps::operator=(mps&& other) {
+
+    if (this == &other){
+        return *this;
+    }
+
+    this->checkAssignment(other);
+
+    this->sign = other.sign;
+    this->mantissa = std::move(other.mantissa);
+    this->exponent = std::move(other.exponent);
+    this->classification = other.classification;
+
+    other.clear();
+
+    return *this;
+}
+
+/**
+ * Checks that another mps object can be assigned to this one. An empty object takes over the format of the other one.
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
+ *
+ * @param other the assigned object
+ */
+void mps::checkAssignment(const mps& other) {
+
+    if (0 == this->mantissa_length && 0 == this->exponent_length) {
+        this->mantissa_length = other.mantissa_length;
+        this->exponent_length = other.exponent_length;
+        return;
+    }
+
     if (this->exponent_length != other.exponent_length) {
         throw std::invalid_argument("ERROR: in = : Exponents do not match");
     }
     if (this->mantissa_length != other.mantissa_length) {
         throw std::invalid_argument("ERROR: in = : Mantissas do not match");
     }
+}
 
-    this->sign = other.sign;
-    for(unsigned long i = 0; i < this->mantissa_length; i++){
-        this->mantissa[i] = other.mantissa[i];
-    }
-    for(unsigned long i = 0; i < this->exponent_length; i++){
-        this->exponent[i] = other.exponent[i];
-    }
+/**
+ * Leaves the object empty (no format, no storage).
+ */
+void mps::clear() noexcept {
 
-    return *this;
+    this->mantissa_length = 0;
+    this->exponent_length = 0;
+    this->sign = false;
+    this->mantissa.clear();
+    this->exponent.clear();
+    this->classification = value_class::nan;
 }
 
 /**
@@ -935,13 +1237,35 @@ mps& mps::operator|=(const mps& other) {
     }
 
     this->sign = other.sign;
-    for(unsigned long i = 0; i < this->mantissa_length; i++){
-        this->mantissa[i] = other.mantissa[i];
-    }
-    for(unsigned long i = 0; i < this->exponent_length; i++){
-        this->exponent[i] = other.exponent[i];
+    this->mantissa = other.mantissa;
+    this->exponent = other.exponent;
+    this->classification = other.classification;
+
+    return *this;
+}
+
+/**
+ * Sets one mps object equal to a temporary mps object and takes over its format and storage. The temporary
+ * object is left empty.
+ *
+ * This operator should be used with caution since, in this way, implicit casts are possible.
+ */
+mps& mps::operator|=(mps&& other) {
+
+    if (this == &other){
+        return *this;
     }
 
+    this->mantissa_length = other.mantissa_length;
+    this->exponent_length = other.exponent_length;
+
+    this->sign = other.sign;
+    this->mantissa = std::move(other.mantissa);
+    this->exponent = std::move(other.exponent);
+    this->classification = other.classification;
+
+    other.clear();
+
     return *this;
 }
 
@@ -962,6 +1286,8 @@ mps mps::operator+(const mps& other) const {
         throw std::invalid_argument("ERROR: in + : Mantissas do not match");
     }
 
+    mps_counters::countOperation(mps_counters::operation::addition, this->mantissa_length, this->exponent_length);
+
 
     if(this->isNaN() || other.isNaN()){
 
@@ -999,13 +1325,13 @@ mps mps::operator+(const mps& other) const {
 
 
     if(this->isPositive() && other.isPositive()){
-        return addition(*this, other, false);
+        return classified(addition(*this, other, false));
     } else if(!this->isPositive() && !other.isPositive()){
-        return addition(*this, other, true);
+        return classified(addition(*this, other, true));
     } else if(!this->isPositive()){
-        return subtraction(other, *this, false);
+        return classified(subtraction(other, *this, false));
     } else{
-        return subtraction(*this, other, false);
+        return classified(subtraction(*this, other, false));
     }
 
 }
@@ -1027,6 +1353,8 @@ mps mps::operator-(const mps& other) const {
         throw std::invalid_argument("ERROR: in - : Mantissas do not match");
     }
 
+    mps_counters::countOperation(mps_counters::operation::subtraction, this->mantissa_length, this->exponent_length);
+
 
     if(this->isNaN() || other.isNaN()){
 
@@ -1066,13 +1394,13 @@ mps mps::operator-(const mps& other) const {
 
 
     if(this->isPositive() && other.isPositive()){
-        return subtraction(*this, other, false);
+        return classified(subtraction(*this, other, false));
     } else if(!this->isPositive() && !other.isPositive()){
-        return subtraction(*this, other, true);
+        return classified(subtraction(*this, other, true));
     } else if(this->isPositive()) {
-        return addition(*this, other, false);
+        return classified(addition(*this, other, false));
     } else {
-        return addition(*this, other, true);
+        return classified(addition(*this, other, true));
     }
 }
 
@@ -1093,6 +1421,8 @@ mps mps::operator*(const mps& other) const {
         throw std::invalid_argument("ERROR: in * : Mantissas do not match");
     }
 
+    mps_counters::countOperation(mps_counters::operation::multiplication, this->mantissa_length, this->exponent_length);
+
 
     if(this->isNaN() || other.isNaN()){
 
@@ -1122,82 +1452,455 @@ mps mps::operator*(const mps& other) const {
         ret.setInf(!other.isPositive());
         return ret;
 
-    } else if(this->isZero() || other.isZero()){
-        mps ret(other.mantissa_length, other.exponent_length);
-        ret.setZero();
-        return ret;
-    }
+    } else if(this->isZero() || other.isZero()){
+        mps ret(other.mantissa_length, other.exponent_length);
+        ret.setZero();
+        return ret;
+    }
+
+
+    return classified(multiplication(*this, other, this->sign != other.sign));
+}
+
+/**
+ * Performs a division of two mps floating point values.
+ *
+ * It is responsible for special values and choosing which "calculation" to use.
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
+ */
+mps mps::operator/(const mps& other) const {
+
+    if (this->exponent_length != other.exponent_length) {
+        throw std::invalid_argument("ERROR: in / : Exponents do not match");
+    }
+    if (this->mantissa_length != other.mantissa_length) {
+        throw std::invalid_argument("ERROR: in / : Mantissas do not match");
+    }
+
+    mps_counters::countOperation(mps_counters::operation::division, this->mantissa_length, this->exponent_length);
+
+
+    if(this->isNaN() || other.isNaN()){
+
+        mps ret(this->mantissa_length, this->exponent_length);
+        ret.setNaN();
+        return ret;
+
+    } else if(this->isInf() && other.isInf()){
+        mps ret(this->mantissa_length, this->exponent_length);
+
+        if(this->isPositive() == other.isPositive()){
+            ret.setNaN();
+        } else {
+            ret.setInf(!this->isPositive());
+        }
+
+        return ret;
+    } else if(this->isInf()){
+
+        mps ret(this->mantissa_length, this->exponent_length);
+        ret.setInf(!this->isPositive());
+        return ret;
+
+    } else if(other.isInf()){
+
+        mps ret(other.mantissa_length, other.exponent_length);
+        if(this->isPositive() == other.isPositive()){
+            ret.setZero();
+        } else {
+            ret.setZero(true);
+        }
+        return ret;
+
+    } else if(this->isZero()){
+        mps ret(other.mantissa_length, other.exponent_length);
+        if(this->isPositive() == other.isPositive()){
+            ret.setZero();
+        } else {
+            ret.setZero(true);
+        }
+        return ret;
+    } else if(other.isZero()){
+        mps ret(other.mantissa_length, other.exponent_length);
+        ret.setInf(!this->isPositive());
+        return ret;
+    }
+
+
+    return classified(division(*this, other, this->sign != other.sign));
+}
+
+/**
+ * Adds another mps object to the mps object (this = this + other).
+ * With the packed engine the result is written into the bit fields of the object, so their storage is reused
+ * (calculateInto). Otherwise, the result is computed by the operator and moved into the object.
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
+ */
+mps& mps::operator+=(const mps& other) {
+    calculateInto(*this, other, '+', this);
+    return *this;
+}
+
+/**
+ * Subtracts another mps object from the mps object (this = this - other).
+ */
+mps& mps::operator-=(const mps& other) {
+    calculateInto(*this, other, '-', this);
+    return *this;
+}
+
+/**
+ * Multiplies the mps object with another mps object (this = this * other).
+ */
+mps& mps::operator*=(const mps& other) {
+    calculateInto(*this, other, '*', this);
+    return *this;
+}
+
+/**
+ * Divides the mps object by another mps object (this = this / other).
+ */
+mps& mps::operator/=(const mps& other) {
+    calculateInto(*this, other, '/', this);
+    return *this;
+}
+
+/**
+ * Operators with temporary operands (e.g. a * b + c). The result is written into a temporary operand like in the
+ * compound operators and then moved out, so no new object is created.
+ */
+mps operator+(mps&& one, const mps& two) {
+    mps::calculateInto(one, two, '+', &one);
+    return std::move(one);
+}
+
+mps operator-(mps&& one, const mps& two) {
+    mps::calculateInto(one, two, '-', &one);
+    return std::move(one);
+}
+
+mps operator*(mps&& one, const mps& two) {
+    mps::calculateInto(one, two, '*', &one);
+    return std::move(one);
+}
+
+mps operator/(mps&& one, const mps& two) {
+    mps::calculateInto(one, two, '/', &one);
+    return std::move(one);
+}
+
+mps operator+(const mps& one, mps&& two) {
+    mps::calculateInto(one, two, '+', &two);
+    return std::move(two);
+}
+
+mps operator-(const mps& one, mps&& two) {
+    mps::calculateInto(one, two, '-', &two);
+    return std::move(two);
+}
+
+mps operator*(const mps& one, mps&& two) {
+    mps::calculateInto(one, two, '*', &two);
+    return std::move(two);
+}
+
+mps operator/(const mps& one, mps&& two) {
+    mps::calculateInto(one, two, '/', &two);
+    return std::move(two);
+}
+
+mps operator+(mps&& one, mps&& two) {
+    mps::calculateInto(one, two, '+', &one);
+    return std::move(one);
+}
+
+mps operator-(mps&& one, mps&& two) {
+    mps::calculateInto(one, two, '-', &one);
+    return std::move(one);
+}
+
+mps operator*(mps&& one, mps&& two) {
+    mps::calculateInto(one, two, '*', &one);
+    return std::move(one);
+}
+
+mps operator/(mps&& one, mps&& two) {
+    mps::calculateInto(one, two, '/', &one);
+    return std::move(one);
+}
+
+/**
+ * Computes a * b + c with a single rounding (fused multiply-add). The product is not rounded before the addition.
+ * Special values are handled like in the operators.
+ *
+ * With exponents longer than 62 bits, the product and the sum are computed by the operators (two roundings).
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
+ *
+ * @param a the first factor
+ * @param b the second factor
+ * @param c the summand
+ * @return the resulting mps object
+ */
+mps mps::fma(const mps& a, const mps& b, const mps& c) {
+    return fusedOperation(a, b, c, false);
+}
+
+/**
+ * Adds the product a * b to the mps object with a single rounding (this = this + a * b).
+ *
+ * @param a the first factor
+ * @param b the second factor
+ * @return reference to the mps object
+ */
+mps& mps::addProduct(const mps& a, const mps& b) {
+    *this = fusedOperation(a, b, *this, false);
+    return *this;
+}
+
+/**
+ * Subtracts the product a * b from the mps object with a single rounding (this = this - a * b).
+ *
+ * @param a the first factor
+ * @param b the second factor
+ * @return reference to the mps object
+ */
+mps& mps::subtractProduct(const mps& a, const mps& b) {
+    *this = fusedOperation(a, b, *this, true);
+    return *this;
+}
+
+/**
+ * Computes one (operation) two and stores the result in ret, whose storage is reused (compound operators and operators
+ * with temporary operands). ret may be one of the operands.
+ *
+ * With the packed engine (and the analytic engine for the formats of its cost model), the kernels write the result
+ * directly into the bit fields of ret. Special values, the other engines and the formats that the packed engine does
+ * not support are computed by the operator, whose result is moved into ret.
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
+ *
+ * @param one the first operand
+ * @param two the second operand
+ * @param operation '+', '-', '*' or '/'
+ * @param ret the mps object in which the result is stored
+ */
+void mps::calculateInto(const mps& one, const mps& two, char operation, mps* ret) {
+
+    auto selected = getEngine();
+    bool analytic = engine::analytic == selected && costSupported(one);
+    bool kernel = (engine::packed == selected && packedSupported(one)) || analytic;
+
+    if(!kernel || one.exponent_length != two.exponent_length || one.mantissa_length != two.mantissa_length
+       || value_class::normal != one.classification || value_class::normal != two.classification){
+
+        switch(operation){
+            case '+': *ret = one + two; break;
+            case '-': *ret = one - two; break;
+            case '*': *ret = one * two; break;
+            default: *ret = one / two; break;
+        }
+        return;
+    }
+
+    // the same kernels as in the operators
+    //-------------------------------
+    auto add = [&](const mps& x, const mps& y, bool set_sign){
+        if(analytic){
+            chargeAddition(x, y);
+        }
+        packedAddition(x, y, set_sign, ret);
+    };
+    auto subtract = [&](const mps& minued, const mps& subtrahend, bool set_sign){
+        if(analytic){
+            chargeSubtraction(minued, subtrahend);
+        }
+        packedSubtraction(minued, subtrahend, set_sign, ret);
+    };
+
+    bool different_signs = one.sign != two.sign;
+
+    if('+' == operation){
+
+        mps_counters::countOperation(mps_counters::operation::addition, one.mantissa_length, one.exponent_length);
+        if(!different_signs){
+            add(one, two, one.sign);
+        } else if(one.sign){
+            subtract(two, one, false);
+        } else {
+            subtract(one, two, false);
+        }
+
+    } else if('-' == operation){
+
+        mps_counters::countOperation(mps_counters::operation::subtraction, one.mantissa_length, one.exponent_length);
+        if(!different_signs){
+            subtract(one, two, one.sign);
+        } else {
+            add(one, two, one.sign);
+        }
+
+    } else if('*' == operation){
+
+        mps_counters::countOperation(mps_counters::operation::multiplication, one.mantissa_length, one.exponent_length);
+        if(analytic){
+            chargeMultiplication(one, two);
+        }
+        packedMultiplication(one, two, different_signs, ret);
+
+    } else {
+
+        mps_counters::countOperation(mps_counters::operation::division, one.mantissa_length, one.exponent_length);
+        if(analytic){
+            chargeDivision(one, two);
+        }
+        packedDivision(one, two, different_signs, ret);
+    }
+    //-------------------------------
+
+    ret->updateClassification();
+}
+
+/**
+ * Returns an operand in the target format. An operand in another format is cast into one of the operand slots of the
+ * calling thread. The storage of the slots is reused, so no temporary objects are created. The returned reference is
+ * valid until the slot is used again.
+ *
+ * @param value the operand
+ * @param mantissa_length mantissa length of the target format
+ * @param exponent_length exponent length of the target format
+ * @param slot the slot for the cast operand (position of the operand)
+ * @return the operand in the target format
+ */
+const mps& mps::inFormat(const mps& value, unsigned long mantissa_length, unsigned long exponent_length, unsigned char slot) {
+
+    if(value.mantissa_length == mantissa_length && value.exponent_length == exponent_length){
+        return value;
+    }
+
+    thread_local mps slots[3];
+
+    auto& ret = slots[slot];
+    ret |= value;
+    ret.cast(mantissa_length, exponent_length);
+
+    return ret;
+}
+
+/**
+ * Adds two mps objects in a target format. The result is the same as casting both operands to the target format
+ * first (mps::cast), but no cast copies have to be made by the caller.
+ *
+ * @param one the first addend
+ * @param two the second addend
+ * @param mantissa_length mantissa length of the result
+ * @param exponent_length exponent length of the result
+ * @return the sum in the target format
+ */
+mps mps::add(const mps& one, const mps& two, unsigned long mantissa_length, unsigned long exponent_length) {
+    return inFormat(one, mantissa_length, exponent_length, 0) + inFormat(two, mantissa_length, exponent_length, 1);
+}
+
+/**
+ * Subtracts two mps objects in a target format (like mps::add).
+ *
+ * @param minuend the minuend
+ * @param subtrahend the subtrahend
+ * @param mantissa_length mantissa length of the result
+ * @param exponent_length exponent length of the result
+ * @return the difference in the target format
+ */
+mps mps::subtract(const mps& minuend, const mps& subtrahend, unsigned long mantissa_length, unsigned long exponent_length) {
+    return inFormat(minuend, mantissa_length, exponent_length, 0) - inFormat(subtrahend, mantissa_length, exponent_length, 1);
+}
 
+/**
+ * Multiplies two mps objects in a target format (like mps::add).
+ *
+ * @param one the first factor
+ * @param two the second factor
+ * @param mantissa_length mantissa length of the result
+ * @param exponent_length exponent length of the result
+ * @return the product in the target format
+ */
+mps mps::multiply(const mps& one, const mps& two, unsigned long mantissa_length, unsigned long exponent_length) {
+    return inFormat(one, mantissa_length, exponent_length, 0) * inFormat(two, mantissa_length, exponent_length, 1);
+}
 
-    return multiplication(*this, other, this->sign != other.sign);
+/**
+ * Divides two mps objects in a target format (like mps::add).
+ *
+ * @param dividend the dividend
+ * @param divisor the divisor
+ * @param mantissa_length mantissa length of the result
+ * @param exponent_length exponent length of the result
+ * @return the quotient in the target format
+ */
+mps mps::divide(const mps& dividend, const mps& divisor, unsigned long mantissa_length, unsigned long exponent_length) {
+    return inFormat(dividend, mantissa_length, exponent_length, 0) / inFormat(divisor, mantissa_length, exponent_length, 1);
 }
 
 /**
- * Performs a division of two mps floating point values.
+ * Computes a * b + c with a single rounding in a target format (like mps::add).
  *
- * It is responsible for special values and choosing which "calculation" to use.
+ * @param a the first factor
+ * @param b the second factor
+ * @param c the summand
+ * @param mantissa_length mantissa length of the result
+ * @param exponent_length exponent length of the result
+ * @return the result in the target format
+ */
+mps mps::fma(const mps& a, const mps& b, const mps& c, unsigned long mantissa_length, unsigned long exponent_length) {
+    return fusedOperation(inFormat(a, mantissa_length, exponent_length, 0), inFormat(b, mantissa_length, exponent_length, 1),
+                          inFormat(c, mantissa_length, exponent_length, 2), false);
+}
+
+/**
+ * Checks the operands of a fused multiply-add and handles the special values.
+ * If a factor is zero or infinite the product is exact, so the result is computed with the operators. Exponents longer
+ * than 62 bits are computed with the operators as well.
  *
- * Throws Exception:    When the mantissas do not match.
- *                      When the exponents do not match.
+ * @param negate_product true to subtract the product from c
  */
-mps mps::operator/(const mps& other) const {
+mps mps::fusedOperation(const mps& a, const mps& b, const mps& c, bool negate_product) {
 
-    if (this->exponent_length != other.exponent_length) {
-        throw std::invalid_argument("ERROR: in / : Exponents do not match");
+    if (a.exponent_length != b.exponent_length || a.exponent_length != c.exponent_length) {
+        throw std::invalid_argument("ERROR: in fma : Exponents do not match");
     }
-    if (this->mantissa_length != other.mantissa_length) {
-        throw std::invalid_argument("ERROR: in / : Mantissas do not match");
+    if (a.mantissa_length != b.mantissa_length || a.mantissa_length != c.mantissa_length) {
+        throw std::invalid_argument("ERROR: in fma : Mantissas do not match");
+    }
+    if (!packedSupported(a)) {
+        // The fused kernels compute the exponents with 64-bit integers, so longer exponents are rounded twice.
+        auto product = a * b;
+        return negate_product ? c - product : product + c;
     }
 
 
-    if(this->isNaN() || other.isNaN()){
+    if(a.isNaN() || b.isNaN() || c.isNaN()){
 
-        mps ret(this->mantissa_length, this->exponent_length);
+        mps ret(a.mantissa_length, a.exponent_length);
         ret.setNaN();
         return ret;
 
-    } else if(this->isInf() && other.isInf()){
-        mps ret(this->mantissa_length, this->exponent_length);
-
-        if(this->isPositive() == other.isPositive()){
-            ret.setNaN();
-        } else {
-            ret.setInf(!this->isPositive());
-        }
-
-        return ret;
-    } else if(this->isInf()){
-
-        mps ret(this->mantissa_length, this->exponent_length);
-        ret.setInf(!this->isPositive());
-        return ret;
-
-    } else if(other.isInf()){
+    } else if(a.isInf() || b.isInf() || a.isZero() || b.isZero()){
 
-        mps ret(other.mantissa_length, other.exponent_length);
-        if(this->isPositive() == other.isPositive()){
-            ret.setZero();
-        } else {
-            ret.setZero(true);
-        }
-        return ret;
+        auto product = a * b;
+        return negate_product ? c - product : product + c;
 
-    } else if(this->isZero()){
-        mps ret(other.mantissa_length, other.exponent_length);
-        if(this->isPositive() == other.isPositive()){
-            ret.setZero();
-        } else {
-            ret.setZero(true);
-        }
-        return ret;
-    } else if(other.isZero()){
-        mps ret(other.mantissa_length, other.exponent_length);
-        ret.setInf(!this->isPositive());
-        return ret;
+    } else if(c.isInf()){
+        return c;
     }
 
 
-    return division(*this, other, this->sign != other.sign);
+    mps_counters::countOperation(mps_counters::operation::fma, a.mantissa_length, a.exponent_length);
+    return classified(fusedMultiplyAdd(a, b, c, negate_product));
 }
 
 
@@ -1208,6 +1911,9 @@ mps mps::operator/(const mps& other) const {
  */
 void mps::setValue(const double value) {
 
+    exponent.resize(exponent_length);
+    mantissa.resize(mantissa_length);
+
     // Handle special values.
     //-------------------------------
     if(0 == value){
@@ -1226,88 +1932,59 @@ void mps::setValue(const double value) {
     }
     //-------------------------------
 
-    // prepare vectors
-    //-------------------------------
-    exponent.clear();
-    mantissa.clear();
+    // split the value into exponent and the bits behind the leading one
     //-------------------------------
+    this->sign = value < 0;
 
+    uint64_t value_bits;
+    std::memcpy(&value_bits, &value, sizeof value_bits);
+    auto fraction_bits = value_bits & ((((uint64_t) 1) << 52) - 1);
+    long mantissa_shift = (long) ((value_bits >> 52) & 0x7FF) - 1023;
 
-    // set sign
-    //-------------------------------
-    this->sign = value <= 0;
+    // subnormal values are normalized first
+    if(-1023 == mantissa_shift){
+        int binary_exponent;
+        double fraction = std::frexp(std::abs(value), &binary_exponent);    // in [0.5, 1)
+        mantissa_shift = binary_exponent - 1;
+
+        std::memcpy(&fraction_bits, &fraction, sizeof fraction_bits);
+        fraction_bits &= (((uint64_t) 1) << 52) - 1;
+    }
     //-------------------------------
 
 
     // exponent
     //-------------------------------
-    // calculate the exponent
-    long mantissa_shift;
-    if(abs(value) > numeric_limits<float>::max()){
-        // When the value is too large, rounding problems occur using log2.
-        // (At least I think that is the problem)
-        double tmp_value = abs(value);
-        long tmp_count = 0;
-
-        while(tmp_value >= 1){
-            tmp_value /= 2;
-            tmp_count++;
-        }
-        mantissa_shift = tmp_count-1;
-    } else {
-        mantissa_shift = (long) floor(log2(abs(value)));
-    }
-
-    // Getting the exponent in binary format.
-    // The sign is not relevant. Always returns a "positive" value.
-    for(auto i = mantissa_shift + getBias(); i > 0; i /= 2){
-        exponent.insert(exponent.begin(), i % 2);
-    }
+    if(exponent_length <= 62){
 
-    bool value_too_large = false;
-    if(exponent.size() > exponent_length){
-        value_too_large = true;
-    } else if(exponent.size() == exponent_length){
-        value_too_large = allTrue(this->exponent);
-    }
-
-    if  (value_too_large){
-
-        exponent.resize(exponent_length);
-        mantissa.resize(mantissa_length);
-
-        if(value > 0){
-            this->setInf();
-        } else {
-            this->setInf(true);
+        auto biased = mantissa_shift + getBias();
+        if(biased >= (1L << exponent_length) - 1){
+            setInf(value < 0);
+            return;
         }
-
-        return;
+        exponent.fromInt(biased > 0 ? (uint64_t) biased : 0);
 
     } else {
-        exponent.insert(exponent.begin(), exponent_length-exponent.size(), false);
+        // The field is 2^(E-1) + mantissa_shift - 1. Too large or too small values are not possible.
+        this->exponent[0] = mantissa_shift >= 1;
+        for(unsigned long i = 1; i < exponent_length; i++){
+            this->exponent[i] = ((mantissa_shift - 1) >> std::min<unsigned long>(exponent_length - 1 - i, 62)) & 1;
+        }
     }
     //-------------------------------
 
 
-    // mantissa
+    // mantissa (the bits behind the leading one, truncated or padded with zeros)
     //-------------------------------
-    auto tmp_value = value / pow(2, mantissa_shift); // adjust the value so that everything is behind the decimal point.
-
-    // Convert the part after the decimal point to a bit string.
-    // The sign is not relevant. Always returns a "positive" value.
-    double reminder = abs(tmp_value) - floor(abs(tmp_value));
-    for(unsigned long i = 0; i < mantissa_length; i++){
-
-        reminder *= 2;
-        if(reminder >= 1){
-            mantissa.push_back(true); reminder -= 1;
-        } else{
-            mantissa.push_back(false);
-        }
+    if(mantissa_length < 64){
+        mantissa.fromInt(mantissa_length <= 52 ? fraction_bits >> (52 - mantissa_length) : fraction_bits << (mantissa_length - 52));
+    } else {
+        std::fill(mantissa.data(), mantissa.data() + mantissa.wordCount(), 0);
+        mantissa.data()[0] = fraction_bits << 12;
     }
     //-------------------------------
 
+    updateClassification();
 }
 
 /**
@@ -1320,6 +1997,18 @@ void mps::setValue(const double value) {
  */
 [[nodiscard]] mps mps::addition(const mps &one, const mps &two, const bool set_sign) {
 
+    auto selected = getEngine();
+    if(engine::native == selected && nativeSupported(one, two, '+')){
+        return nativeCalculation(one, two, set_sign, '+');
+    }
+    if((engine::packed == selected || engine::native == selected) && packedSupported(one)){
+        return packedAddition(one, two, set_sign);
+    }
+    if(engine::analytic == selected && costSupported(one)){
+        chargeAddition(one, two);
+        return packedAddition(one, two, set_sign);
+    }
+
     // Set up the return object.
     //-------------------------------
     mps ret;
@@ -1332,7 +2021,7 @@ void mps::setValue(const double value) {
     // addition of mantissas.
     //-------------------------------
     auto add = []
-            (const vector<bool> &first, const vector<bool> &second, unsigned long off_set, bool *carrier) -> vector<bool>{
+            (const packed_bits &first, const packed_bits &second, unsigned long off_set, bool *carrier) -> packed_bits{
 
         bool hd[2] = {true, true};
         bool p[2] = {false, false};
@@ -1429,6 +2118,18 @@ void mps::setValue(const double value) {
  */
 [[nodiscard]] mps mps::subtraction(const mps &minued, const mps &subtrahend, bool set_sign) {
 
+    auto selected = getEngine();
+    if(engine::native == selected && nativeSupported(minued, subtrahend, '-')){
+        return nativeCalculation(minued, subtrahend, set_sign, '-');
+    }
+    if((engine::packed == selected || engine::native == selected) && packedSupported(minued)){
+        return packedSubtraction(minued, subtrahend, set_sign);
+    }
+    if(engine::analytic == selected && costSupported(minued)){
+        chargeSubtraction(minued, subtrahend);
+        return packedSubtraction(minued, subtrahend, set_sign);
+    }
+
     // Set up the return object.
     //-------------------------------
     mps ret;
@@ -1441,7 +2142,7 @@ void mps::setValue(const double value) {
     // subtraction of mantissas.
     //-------------------------------
     auto subtract = []
-            (const vector<bool> &first, const vector<bool> &sub, unsigned long off_set) -> vector<bool>{
+            (const packed_bits &first, const packed_bits &sub, unsigned long off_set) -> packed_bits{
 
             bool carrier;
 
@@ -1526,6 +2227,7 @@ void mps::setValue(const double value) {
     //-------------------------------
     unsigned long exponent_shift = 0;
     for(unsigned long i = 0; i < ret.mantissa.size(); i++){
+        mps_counters::addBitComparisons(1);
         if(ret.mantissa[i]){
             exponent_shift = i;
             break;
@@ -1536,8 +2238,9 @@ void mps::setValue(const double value) {
     }
 
     ret.mantissa.erase(ret.mantissa.begin(), ret.mantissa.begin() + (long) exponent_shift + 1);
+    mps_counters::addShifts(1);
 
-    vector<bool> exponent_shift_binary = intToBinary(exponent_shift);
+    packed_bits exponent_shift_binary = intToBinary(exponent_shift);
     exponent_shift_binary.insert(exponent_shift_binary.begin(), ret.exponent_length - exponent_shift_binary.size(), false);
     ret.exponent = binarySubtraction(ret.exponent, exponent_shift_binary);
     //-------------------------------
@@ -1561,6 +2264,18 @@ void mps::setValue(const double value) {
  */
 [[nodiscard]] mps mps::multiplication(const mps& one, const mps& two, bool set_sign) {
 
+    auto selected = getEngine();
+    if(engine::native == selected && nativeSupported(one, two, '*')){
+        return nativeCalculation(one, two, set_sign, '*');
+    }
+    if((engine::packed == selected || engine::native == selected) && packedSupported(one)){
+        return packedMultiplication(one, two, set_sign);
+    }
+    if(engine::analytic == selected && costSupported(one)){
+        chargeMultiplication(one, two);
+        return packedMultiplication(one, two, set_sign);
+    }
+
     // Set up the return object.
     //-------------------------------
     mps ret(one.mantissa_length, one.exponent_length);
@@ -1572,7 +2287,7 @@ void mps::setValue(const double value) {
     //-------------------------------
     if(one.exponent[0] && two.exponent[0]){ // Both exponents are positive.
 
-        vector<bool> addend = two.exponent;
+        packed_bits addend = two.exponent;
 
         addend[0] = !addend[0];
         addOneToBinary(&addend);    // Carrier bit must not be checked because of if-statement.
@@ -1588,7 +2303,7 @@ void mps::setValue(const double value) {
 
     } else {
 
-        vector<bool> subtrahend;
+        packed_bits subtrahend;
         subtrahend.reserve(two.exponent.size());
         subtrahend.push_back(false);
         for(unsigned long i = 1; i < two.exponent.size(); i++){
@@ -1616,55 +2331,17 @@ void mps::setValue(const double value) {
     //-------------------------------
     //bool prefix[2] = {false, true};
 
-    vector<bool> S;
-    bool carrier;
-    S = invertAndAddOne(one.mantissa, &carrier);
-    S.insert(S.begin(), carrier);
-    S.insert(S.begin(), true);
-
-
-    // set up P vector (product)
-    vector<bool> &P = ret.mantissa;     // Use reference P in order to keep the naming.
-    P.clear();
-    P.reserve(one.mantissa.size() + two.mantissa_length + 5);              // 3 => 2* (sign and "invisible 1") + 1
-    for(unsigned long i = 0; i < one.mantissa_length + 2; i++){    // 2 => sign and "invisible 1"
-        P.push_back(false);
-    }
-    P.push_back(false);
-    P.push_back(true);
-    for(unsigned long i = 0; i < two.mantissa_length; i++){
-        P.push_back(two.mantissa[i]);
-    }
-    P.push_back(false);
-
-    // main loop
-    for(unsigned long i = 0; i < two.mantissa_length+2; i++){
-
-
-        if(!P.end()[-2] && P.back()){
-            binarySummation(&P, one.mantissa, true);
-        } else if(P.end()[-2] && !P.back()) {
-            binarySummation(&P, S);
-        }
-
-        P.pop_back();
-        P.insert(P.begin(), P[0]);
-
-    }
-
-    P.pop_back();
-    P.erase (P.begin());        // delete "invisible 1"
+    packed_bits &P = ret.mantissa;     // Use reference P in order to keep the naming.
+    P = boothMultiplication(one.mantissa, two.mantissa);
 
-    // normalize
-    int count = 0;
-    for(unsigned long i = 0; i < P.size(); i++){
-        if(P[0]){
-            P.erase(P.begin());
-            break;
-        }
-        P.erase(P.begin());
+    // normalize (the leading zeros and the leading one are removed at once)
+    unsigned long count = 0;
+    mps_counters::addBitComparisons(1);
+    while(!P[count]){
         count++;
+        mps_counters::addBitComparisons(1);
     }
+    P.erase(P.begin(), P.begin() + (long) count + 1);
     //-------------------------------
 
     // rounding
@@ -1692,6 +2369,18 @@ void mps::setValue(const double value) {
  */
 [[nodiscard]] mps mps::division(const mps& dividend, const mps& divisor, bool set_sign) {
 
+    auto selected = getEngine();
+    if(engine::native == selected && nativeSupported(dividend, divisor, '/')){
+        return nativeCalculation(dividend, divisor, set_sign, '/');
+    }
+    if((engine::packed == selected || engine::native == selected) && packedSupported(dividend)){
+        return packedDivision(dividend, divisor, set_sign);
+    }
+    if(engine::analytic == selected && costSupported(dividend)){
+        chargeDivision(dividend, divisor);
+        return packedDivision(dividend, divisor, set_sign);
+    }
+
     // Set up the return object.
     //-------------------------------
     mps ret; //(dividend.mantissa_length, divisor.exponent_length);
@@ -1705,7 +2394,7 @@ void mps::setValue(const double value) {
     //-------------------------------
     if(divisor.exponent[0]){ // Both exponents are positive.
 
-        vector<bool> subtrahend = divisor.exponent;
+        packed_bits subtrahend = divisor.exponent;
 
         subtrahend[0] = !subtrahend[0];
         addOneToBinary(&subtrahend);    // Carrier bit must not be checked because of if-statement.
@@ -1722,7 +2411,7 @@ void mps::setValue(const double value) {
 
     } else if(!divisor.exponent[0]){
 
-        vector<bool> subtrahend;
+        packed_bits subtrahend;
         subtrahend.reserve(divisor.exponent.size());
         subtrahend.push_back(false);
         for(unsigned long i = 1; i < divisor.exponent.size(); i++){
@@ -1749,12 +2438,12 @@ void mps::setValue(const double value) {
     //-------------------------------
 
     // remainder
-    vector<bool> R = dividend.mantissa;
+    packed_bits R = dividend.mantissa;
     R.insert(R.begin(), true);
     R.insert(R.begin(), 2, false);
 
     // quotient
-    vector<bool> &Q = ret.mantissa;         // reference for better naming.
+    packed_bits &Q = ret.mantissa;         // reference for better naming.
     Q.resize(ret.mantissa_length, false);
 
     // subtrahend (used for binarySummation)
@@ -1776,21 +2465,19 @@ void mps::setValue(const double value) {
 
     // normalisation
     //-------------------------------
+    // the leading zeros and the leading one are removed at once (the scan stops in the middle of the quotient)
     unsigned long count = 0;
-    vector<bool> count_vec(divisor.exponent.size(), false);
+    packed_bits count_vec(divisor.exponent.size(), false);
 
-    for(unsigned long i = 0; i < Q.size(); i++){
-        if(Q[0]){
-            Q.erase(Q.begin());
-            count++;
-            //addOneToBinary(&count_vec);
+    while(count < Q.size() - count){
+        mps_counters::addBitComparisons(1);
+        count++;
+        if(Q[count - 1]){
             break;
-        } else {
-            Q.erase(Q.begin());
-            count++;
-            addOneToBinary(&count_vec);
         }
+        addOneToBinary(&count_vec);
     }
+    Q.erase(Q.begin(), Q.begin() + (long) count);
 
     // rerun the algorithm for every leading bit removed.
     for(unsigned long i = 0; i < count; i++){
@@ -1822,6 +2509,150 @@ void mps::setValue(const double value) {
 
     return ret;
 }
+
+/**
+ * Computes a * b + c (or c - a * b) with a single rounding (round to nearest, ties to even).
+ *
+ * The product is computed exactly by the Booth multiplier. The product and the summand are placed into two registers
+ * of 3M + 13 bits, aligned to the larger one of them (the first bit is for the carrier). Bits that are shifted out of a
+ * register are collected in its last bit (sticky bit), which does not change the rounding. The registers are added or
+ * subtracted once, then the sum is normalised and rounded like the results of the other operations. The exponents are
+ * computed with E + 2 bits, so they do not wrap: results with a biased exponent of 11...1 or larger are infinite,
+ * results below the smallest normal number are flushed to (positive) zero (like in the packed engine). Every addition
+ * of the exponent unit is counted as E + 2 full adders.
+ *
+ * Info: Does not check for correct input or special values. a and b must be finite and not zero, c must be finite.
+ * The exponents must not be longer than 62 bits.
+ *
+ * @param a reference to the first factor
+ * @param b reference to the second factor
+ * @param c reference to the summand
+ * @param negate_product true to subtract the product from c
+ * @return the resulting mps object
+ */
+[[nodiscard]] mps mps::fusedMultiplyAdd(const mps& a, const mps& b, const mps& c, bool negate_product) {
+
+    auto selected = getEngine();
+    if(engine::packed == selected || engine::native == selected){
+        return packedFusedMultiplyAdd(a, b, c, negate_product);
+    }
+    if(engine::analytic == selected && costSupported(a)){
+        chargeFusedMultiplyAdd(a, b, c, negate_product);
+        return packedFusedMultiplyAdd(a, b, c, negate_product);
+    }
+
+    // Set up the return object.
+    //-------------------------------
+    mps ret(a.mantissa_length, a.exponent_length);
+    ret.sign = (a.sign != b.sign) != negate_product;
+
+    const auto M = a.mantissa_length;
+    const auto W = 3 * M + 13;
+    const long mask = (1L << a.exponent_length) - 1;
+    const long bias = (1L << (a.exponent_length - 1)) - 1;
+
+    auto unbiased = [bias](const mps& x) -> long { return (long) x.exponent.toInt() - bias; };
+    auto exponentAddition = [&a](){ mps_counters::addFullAdders(a.exponent_length + 2); };
+
+    // copies the bits [first, end) of a significand into a register, starting at the index offset
+    auto place = [W](packed_bits& reg, const packed_bits& bits, unsigned long first, unsigned long offset){
+        for(auto i = first; i < bits.size(); i++){
+            if(bits[i]){
+                reg[std::min(offset + i - first, W - 1)] = true;
+            }
+        }
+    };
+    //-------------------------------
+
+
+    // exact product (the first bit of P is zero, the next one has the weight 2^top)
+    //-------------------------------
+    auto P = boothMultiplication(a.mantissa, b.mantissa);
+    long top = unbiased(a) + unbiased(b) + 1;
+    exponentAddition();
+    exponentAddition();
+    //-------------------------------
+
+
+    // addition of c
+    //-------------------------------
+    packed_bits R(W);
+
+    if(c.isZero()){
+        place(R, P, 1, 1);
+    } else {
+
+        packed_bits C = c.mantissa;
+        C.insert(C.begin(), true);
+
+        long top_product = top;
+        long top_summand = unbiased(c);
+        exponentAddition();
+        top = std::max(top_product, top_summand);
+
+        packed_bits X(W), Y(W);
+        place(X, P, 1, 1 + std::min((unsigned long) (top - top_product), W));
+        place(Y, C, 0, 1 + std::min((unsigned long) (top - top_summand), W));
+        if(top_product != top_summand){
+            mps_counters::addShifts(1);     // alignment of the smaller operand
+        }
+
+        if(ret.sign == c.sign){
+            R = binaryAddition(X, Y);
+        } else {
+            auto larger_tmp = larger(X, Y);
+            if(0 == larger_tmp){
+                ret.setZero();
+                return ret;
+            }
+            R = 1 == larger_tmp ? binarySubtraction(X, Y) : binarySubtraction(Y, X);
+            ret.sign = 1 == larger_tmp ? ret.sign : c.sign;
+        }
+    }
+    //-------------------------------
+
+
+    // normalize (the leading zeros and the leading one are removed at once)
+    //-------------------------------
+    unsigned long count = 0;
+    mps_counters::addBitComparisons(1);
+    while(!R[count]){
+        count++;
+        mps_counters::addBitComparisons(1);
+    }
+    R.erase(R.begin(), R.begin() + (long) count + 1);
+    mps_counters::addShifts(1);
+
+    long e = top + 1 - (long) count;
+    exponentAddition();
+    //-------------------------------
+
+
+    // rounding (results with many leading zeros are exact, they are filled up with zeros)
+    //-------------------------------
+    if(round(&R, M)){
+        e++;
+    }
+    R.resize(M);
+    //-------------------------------
+
+
+    // exponent range
+    //-------------------------------
+    if(e + bias >= mask){
+        ret.setInf(ret.sign);
+        return ret;
+    }
+    if(e + bias <= 0){
+        ret.setZero();
+        return ret;
+    }
+    //-------------------------------
+
+    ret.mantissa = std::move(R);
+    ret.exponent.fromInt(e + bias);
+    return ret;
+}
 //-------------------------------
 
 
@@ -2125,26 +2956,23 @@ bool mps::operator<=(const mps& other) const {
  */
 [[nodiscard]] char mps::compare(const mps& one, const mps& two){
 
-    // compare exponent
-    for(unsigned long i = 0; i < one.exponent_length; i++){
-
-        if(one.exponent[i] && !two.exponent[i]){
-            return 1;
-        }
-        if(two.exponent[i] && !one.exponent[i]){
-            return -1;
-        }
+    auto selected = getEngine();
+    if(engine::packed == selected || engine::native == selected){
+        return packedCompare(one, two);
     }
 
-    // compare mantissa
-    for(unsigned long i = 0; i < one.mantissa_length; i++){
+    // The first different bit (found word by word) decides. Like the bit serial comparator, every bit up to it is
+    // counted as one comparison.
+    auto idx = one.exponent.mismatch(two.exponent);
+    if(idx < one.exponent_length){
+        mps_counters::addBitComparisons(idx + 1);
+        return one.exponent[idx] ? 1 : -1;
+    }
 
-        if(one.mantissa[i] && !two.mantissa[i]){
-            return 1;
-        }
-        if(two.mantissa[i] && !one.mantissa[i]){
-            return -1;
-        }
+    idx = one.mantissa.mismatch(two.mantissa);
+    mps_counters::addBitComparisons(one.exponent_length + std::min(idx + 1, one.mantissa_length));
+    if(idx < one.mantissa_length){
+        return one.mantissa[idx] ? 1 : -1;
     }
 
     // equal case
@@ -2156,6 +2984,55 @@ bool mps::operator<=(const mps& other) const {
 // helper methods
 //-------------------------------
 
+/**
+ * Multiplies two significands (hidden digit and mantissa) with the Booth algorithm.
+ *
+ * @param one reference to the mantissa of the multiplicand
+ * @param two reference to the mantissa of the multiplier
+ * @return the exact product with a leading zero (the first one is at index 1 or 2)
+ */
+packed_bits mps::boothMultiplication(const packed_bits& one, const packed_bits& two){
+
+    packed_bits S;
+    bool carrier;
+    S = invertAndAddOne(one, &carrier);
+    S.insert(S.begin(), carrier);
+    S.insert(S.begin(), true);
+
+
+    // set up P vector (product)
+    packed_bits P;
+    P.reserve(one.size() + two.size() + 5);              // 3 => 2* (sign and "invisible 1") + 1
+    for(unsigned long i = 0; i < one.size() + 2; i++){    // 2 => sign and "invisible 1"
+        P.push_back(false);
+    }
+    P.push_back(false);
+    P.push_back(true);
+    for(unsigned long i = 0; i < two.size(); i++){
+        P.push_back(two[i]);
+    }
+    P.push_back(false);
+
+    // main loop
+    for(unsigned long i = 0; i < two.size()+2; i++){
+
+        if(!P[P.size() - 2] && P.back()){
+            binarySummation(&P, one, true);
+        } else if(P[P.size() - 2] && !P.back()) {
+            binarySummation(&P, S);
+        }
+
+        P.pop_back();
+        P.insert(P.begin(), P[0]);
+        mps_counters::addShifts(1);
+    }
+
+    P.pop_back();
+    P.erase (P.begin());        // delete "invisible 1"
+
+    return P;
+}
+
 /**
  * Performs a binary addition using a full adder.
  * The binary numbers are represented as vectors containing booleans.
@@ -2166,15 +3043,16 @@ bool mps::operator<=(const mps& other) const {
  * @param carrier_return pointer to a boolean where the last state of the carrier bit can be saved
  * @return the result as a binary number
  */
-vector<bool> mps::binaryAddition(const vector<bool>& a, const vector<bool>& b, bool* carrier_return){
+packed_bits mps::binaryAddition(const packed_bits& a, const packed_bits& b, bool* carrier_return){
 
-    vector<bool> ret;
+    packed_bits ret(a.size());
     bool carrier = false;
+    mps_counters::addFullAdders(a.size());
 
-    // full adder
+    // full adder (the result is written from the last bit to the first)
     for(auto i = a.size(); i > 0;){
         i--;
-        ret.insert(ret.begin(), (a[i] ^ b[i]) ^ carrier);
+        ret[i] = (a[i] ^ b[i]) ^ carrier;
         carrier = ((a[i] && b[i]) || (a[i] && carrier)) || (b[i] && carrier);
     }
 
@@ -2202,7 +3080,7 @@ vector<bool> mps::binaryAddition(const vector<bool>& a, const vector<bool>& b, b
  * @param subtrahend reference to the vector which should be subtracted
  * @return the result as a binary number
  */
-vector<bool> mps::binarySubtraction(const vector<bool>& minuend, const vector<bool>& subtrahend){
+packed_bits mps::binarySubtraction(const packed_bits& minuend, const packed_bits& subtrahend){
 
     bool carrie;
     auto tmp = invertAndAddOne(subtrahend, &carrie);
@@ -2224,7 +3102,7 @@ vector<bool> mps::binarySubtraction(const vector<bool>& minuend, const vector<bo
  * @param summand pointer to the vector to which the addend is added.
  * @param addend reference to the addend which is going to be added to the summand.
  */
-void mps::binarySummation(vector<bool> *summand, const vector<bool> &addend, const bool prefix) {
+void mps::binarySummation(packed_bits *summand, const packed_bits &addend, const bool prefix) {
 
     bool carrier = false;
     bool tmp;
@@ -2233,6 +3111,7 @@ void mps::binarySummation(vector<bool> *summand, const vector<bool> &addend, con
     if(prefix) {
         j += 2;
     }
+    mps_counters::addFullAdders(prefix ? addend.size() + 2 : addend.size());
 
     // full adder
     for(auto i = addend.size(); i > 0;){
@@ -2282,10 +3161,11 @@ void mps::binarySummation(vector<bool> *summand, const vector<bool> &addend, con
  * @param cr pointer to a bool where the last value of the carrier bit can be saved (default: nullptr)
  * @return the result as a vector consisting of booleans
  */
-vector<bool> mps::binaryOffsetAddition(const vector<bool>& lp, const vector<bool>& rp, unsigned long off_set, bool c, const bool p[2], const bool hd[2],  bool* cr){
+packed_bits mps::binaryOffsetAddition(const packed_bits& lp, const packed_bits& rp, unsigned long off_set, bool c, const bool p[2], const bool hd[2],  bool* cr){
 
-    // setting up basic variable.
-    vector<bool> ret;
+    // setting up basic variable (the result is written from the last bit to the first).
+    packed_bits ret(off_set > 0 ? rp.size() + off_set + 1 : lp.size() + 1);
+    auto k = ret.size();
     bool carrier = false;
 
     // calculate the right padding part.
@@ -2294,7 +3174,7 @@ vector<bool> mps::binaryOffsetAddition(const vector<bool>& lp, const vector<bool
         i--;
         //ret.insert(ret.begin(), lp[i] ^ carrier);
         //carrier = ((lp[i] && false) || (lp[i] && carrier));
-        ret.insert(ret.begin(), (lp[i] ^ p[1]) ^ carrier);
+        ret[--k] = (lp[i] ^ p[1]) ^ carrier;
         carrier = ((lp[i] && p[1]) || (lp[i] && carrier)) || (p[1] && carrier);
     }
     //-------------------------------
@@ -2306,7 +3186,7 @@ vector<bool> mps::binaryOffsetAddition(const vector<bool>& lp, const vector<bool
     for(auto i = lp.size()-off_set; i > 0;){
         i--;
         j--;
-        ret.insert(ret.begin(), (lp[i] ^ rp[j]) ^ carrier);
+        ret[--k] = (lp[i] ^ rp[j]) ^ carrier;
         carrier = ((lp[i] && rp[j]) || (lp[i] && carrier)) || (rp[j] && carrier);
     }
     //-------------------------------
@@ -2316,7 +3196,7 @@ vector<bool> mps::binaryOffsetAddition(const vector<bool>& lp, const vector<bool
 
         // calculate the left parts hidden digit.
         j--;
-        ret.insert(ret.begin(), (hd[0] ^ rp[j]) ^ carrier);
+        ret[--k] = (hd[0] ^ rp[j]) ^ carrier;
         carrier = ((hd[0] && rp[j]) || (hd[0] && carrier)) || (rp[j] && carrier);
 
 
@@ -2326,23 +3206,28 @@ vector<bool> mps::binaryOffsetAddition(const vector<bool>& lp, const vector<bool
             j--;
             //ret.insert(ret.begin(), rp[j] ^ carrier);
             //carrier = (rp[j] && carrier);
-            ret.insert(ret.begin(), (p[0] ^ rp[j]) ^ carrier);
+            ret[--k] = (p[0] ^ rp[j]) ^ carrier;
             carrier = ((p[0] && rp[j]) || (p[0] && carrier)) || (rp[j] && carrier);
         }
         //-------------------------------
 
 
         // calculate right parts hidden digit
-        ret.insert(ret.begin(), (p[0] ^ hd[1]) ^ carrier);
+        ret[--k] = (p[0] ^ hd[1]) ^ carrier;
         carrier = ((p[0]  && hd[1]) || (p[0]  && carrier)) || (hd[1] && carrier);
 
     } else {
 
         // calculate the hidden digit of both variables
-        ret.insert(ret.begin(), (hd[0] ^ hd[1]) ^ carrier);
+        ret[--k] = (hd[0] ^ hd[1]) ^ carrier;
         carrier = ((hd[0] && hd[1]) || (hd[0] && carrier)) || (hd[1] && carrier);
     }
 
+    mps_counters::addFullAdders(ret.size());
+    if(off_set > 0){
+        mps_counters::addShifts(1);     // alignment of the operands
+    }
+
     // perform carrier step if wanted.
     if(c && carrier){
         ret.insert(ret.begin(), true);
@@ -2367,13 +3252,14 @@ vector<bool> mps::binaryOffsetAddition(const vector<bool>& lp, const vector<bool
  * @param mantissa_len The length to which the mantissa should be rounded
  * @return if an overflow happened.
  */
-bool mps::round(vector<bool> *mantissa, unsigned long mantissa_len) {
+bool mps::round(packed_bits *mantissa, unsigned long mantissa_len) {
 
     bool ret = false;
 
     if(mantissa->size() > mantissa_len){
         bool tmp = false;
         for(auto i = mantissa_len+1 ; i < mantissa->size(); i++){
+            mps_counters::addBitComparisons(1);
             if ((*mantissa)[i]){
                 tmp = true;
                 break;
@@ -2406,7 +3292,7 @@ bool mps::round(vector<bool> *mantissa, unsigned long mantissa_len) {
  * @param vector vector containing the binary number
  * @return the binary number as an integer
  */
-unsigned long mps::binaryToInt(vector<bool> vector){
+unsigned long mps::binaryToInt(packed_bits vector){
 
     unsigned long ret = 0;
 
@@ -2426,12 +3312,18 @@ unsigned long mps::binaryToInt(vector<bool> vector){
  * @param value the value of the integer
  * @return the value as a binary number
  */
-vector<bool> mps::intToBinary(unsigned long value) {
+packed_bits mps::intToBinary(unsigned long value) {
 
-    vector<bool> ret;
+    unsigned long length = 0;
+    for(auto tmp = value; tmp >= 1; tmp /= 2){
+        length++;
+    }
 
-    while (value >= 1){
-        ret.insert(ret.begin(), value%2);
+    // the bits are written from the last to the first
+    packed_bits ret(length);
+    for(auto i = length; i > 0;){
+        i--;
+        ret[i] = value%2;
         value /= 2;
     }
 
@@ -2465,10 +3357,11 @@ long mps::getBias() const{
  * @param division_case whether the division case is wanted or not
  * @return 1 if a > b, 0 if a == b, -1 if a < b
  */
-char mps::larger(const vector<bool>& a, const vector<bool>& b, const bool division_case){
+char mps::larger(const packed_bits& a, const packed_bits& b, const bool division_case){
 
     if(!division_case){
         for(unsigned long i = 0; i < a.size(); i++){
+            mps_counters::addBitComparisons(1);
             if(a[i] && !b[i]) { return 1;}
             else if(b[i] && !a[i]) {return -1;}
         }
@@ -2481,6 +3374,7 @@ char mps::larger(const vector<bool>& a, const vector<bool>& b, const bool divisi
         }
 
         for(unsigned long i = 0; i < b.size(); i++){
+            mps_counters::addBitComparisons(1);
             if(a[i+2] && !b[i]) { return 1;}
             else if(b[i] && !a[i+2]) {return -1;}
         }
@@ -2500,11 +3394,12 @@ char mps::larger(const vector<bool>& a, const vector<bool>& b, const bool divisi
  * @param vector pointer to the vector containing the binary number where one should be added
  * @return true if a carrier bit was present in the last iteration, false otherwise
  */
-bool mps::addOneToBinary(vector<bool>* vector){
+bool mps::addOneToBinary(packed_bits* vector){
 
     for(auto i = vector->size(); i > 0;){
         i--;
         (*vector)[i] = !(*vector)[i];
+        mps_counters::addHalfAdders(1);
         if((*vector)[i]){
             return false;
         }
@@ -2520,11 +3415,12 @@ bool mps::addOneToBinary(vector<bool>* vector){
  * @param vector pointer to the vector containing the binary number where one should be subtracted
  * @return true if a carrier bit was present in the last iteration, false otherwise
  */
-bool mps::subtractOneFromBinary(vector<bool> *vector){
+bool mps::subtractOneFromBinary(packed_bits *vector){
 
     for(auto i = vector->size(); i > 0;){
         i--;
         (*vector)[i] = !(*vector)[i];
+        mps_counters::addHalfAdders(1);
         if(!(*vector)[i]){
             return false;
         }
@@ -2540,9 +3436,9 @@ bool mps::subtractOneFromBinary(vector<bool> *vector){
  * @param carrie pointer to a boolean value, which will be set to true if a carrier bit is present at the end
  * @return the resulting copied and tempered vector
  */
-vector<bool> mps::invertAndAddOne(const vector<bool> &vec, bool *carrie, const bool division_case){
+packed_bits mps::invertAndAddOne(const packed_bits &vec, bool *carrie, const bool division_case){
 
-    vector<bool> ret;
+    packed_bits ret;
 
     if(!division_case){
         ret.reserve(vec.size());
@@ -2575,8 +3471,8 @@ vector<bool> mps::invertAndAddOne(const vector<bool> &vec, bool *carrie, const b
  * @param vector reference to the vector, which should be checked
  * @return true if all entries of the vector are true
  */
-[[nodiscard]] bool mps::allTrue(const vector<bool>& vector) {
-    return std::all_of(vector.begin(), vector.end(), [](bool i){return i;});
+[[nodiscard]] bool mps::allTrue(const packed_bits& vector) {
+    return vector.allSet();
 }
 
 /**
@@ -2585,8 +3481,8 @@ vector<bool> mps::invertAndAddOne(const vector<bool> &vec, bool *carrie, const b
  * @param vector reference to the vector, which should be checked
  * @return true if all entries of the vector are false
  */
-[[nodiscard]] bool mps::allFalse(const vector<bool>& vector) {
-    return std::all_of(vector.begin(), vector.end(), [](bool i){return !i;});
+[[nodiscard]] bool mps::allFalse(const packed_bits& vector) {
+    return vector.noneSet();
 }
 
 /**
@@ -2594,8 +3490,9 @@ vector<bool> mps::invertAndAddOne(const vector<bool> &vec, bool *carrie, const b
  *
  * @param vector pointer to the vector, which should be shifted to the left
  */
-void mps::shiftLeft(vector<bool>* vec){
+void mps::shiftLeft(packed_bits* vec){
 
+    mps_counters::addShifts(1);
     vec->erase(vec->begin());
     vec->push_back(false);
 }
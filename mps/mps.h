@@ -4,6 +4,9 @@
 #include <vector>
 #include <cmath>
 #include <string>
+#include <atomic>
+
+#include "packed_bits.h"
 
 using namespace std;
 
@@ -21,17 +24,53 @@ private:
     // the actual bit array
     //-------------------------------
     bool sign;
-    vector<bool> exponent;
-    vector<bool> mantissa;
+    packed_bits exponent;
+    packed_bits mantissa;
+    //-------------------------------
+
+
+    // class of the value (kept up to date with the bit array, so the special values are checked in O(1))
+    //-------------------------------
+    enum class value_class : unsigned char { normal, zero, inf, nan };
+    value_class classification;
+    //-------------------------------
+
+
+    // formats fixed at compile time (mps_t.h) convert directly from and to the bit array
+    //-------------------------------
+    template<unsigned long M, unsigned long E> friend class mps_t;
+
+    // arrays stored as bit planes (mps_sliced.h) transpose directly from and to the bit array
+    friend class mps_sliced;
     //-------------------------------
 
 
 public:
+    // arithmetic engines
+    //-------------------------------
+    enum class engine {
+        reference,      // bit level algorithms (simulated hardware)
+        packed,         // word level algorithms on the packed storage (same results)
+        native,         // hardware float/double for binary32/binary64 (same results, the rest is left to packed)
+        sliced,         // bit level algorithms, vector operations of ira batched on bit planes (mps_sliced.h)
+        analytic        // results of the packed engine, counters charged with the cost of the reference engine
+    };
+
+    static void setEngine(engine new_engine);
+    [[nodiscard]] static engine getEngine();
+
+    static void setKaratsubaThreshold(unsigned long threshold);
+    [[nodiscard]] static unsigned long getKaratsubaThreshold();
+    static void setNewtonThreshold(unsigned long threshold);
+    [[nodiscard]] static unsigned long getNewtonThreshold();
+
     // constructors and destructor
     //-------------------------------
     mps(unsigned long mantissa_length, unsigned long exponent_length, double value);
     mps(unsigned long mantissa_length, unsigned long exponent_length);
     mps();
+    mps(const mps& other);
+    mps(mps&& other) noexcept;
     ~mps();
 
     // getter methods
@@ -40,6 +79,9 @@ public:
     [[nodiscard]] vector<bool> getMantissa() const;
     [[nodiscard]] vector<bool> getExponent() const;
     [[nodiscard]] vector<bool> getBitArray() const;
+    [[nodiscard]] bits_view getMantissaView() const;
+    [[nodiscard]] bits_view getExponentView() const;
+    void getBitArray(unsigned char* out, unsigned char zero = 0) const;
 
     [[nodiscard]] unsigned long getMantisseLength() const;
     [[nodiscard]] unsigned long getExponentLength() const;
@@ -78,15 +120,57 @@ public:
     //-------------------------------
     void cast(unsigned long new_mantissa_size, unsigned long new_exponent_size);
 
+    // batch conversion (arrays of values, the mps objects must exist already)
+    //-------------------------------
+    static void fromDoubles(const double* values, size_t n, mps* out, unsigned long mantissa_length, unsigned long exponent_length);
+    static void fromFloats(const float* values, size_t n, mps* out, unsigned long mantissa_length, unsigned long exponent_length);
+    static void toDoubles(const mps* values, size_t n, double* out);
+    static void toFloats(const mps* values, size_t n, float* out);
+    static void toBitArrays(const mps* values, size_t n, unsigned char* out);
+
     // operators
     //-------------------------------
     mps& operator=(const mps& other);
+    mps& operator=(mps&& other);
     mps& operator|=(const mps& other);
+    mps& operator|=(mps&& other);
     mps& operator=(double value);
     mps operator+(const mps& other) const;
     mps operator-(const mps& other) const;
     mps operator*(const mps& other) const;
     mps operator/(const mps& other) const;
+    mps& operator+=(const mps& other);
+    mps& operator-=(const mps& other);
+    mps& operator*=(const mps& other);
+    mps& operator/=(const mps& other);
+
+    // temporary operands are reused for the result
+    friend mps operator+(mps&& one, const mps& two);
+    friend mps operator-(mps&& one, const mps& two);
+    friend mps operator*(mps&& one, const mps& two);
+    friend mps operator/(mps&& one, const mps& two);
+    friend mps operator+(const mps& one, mps&& two);
+    friend mps operator-(const mps& one, mps&& two);
+    friend mps operator*(const mps& one, mps&& two);
+    friend mps operator/(const mps& one, mps&& two);
+    friend mps operator+(mps&& one, mps&& two);
+    friend mps operator-(mps&& one, mps&& two);
+    friend mps operator*(mps&& one, mps&& two);
+    friend mps operator/(mps&& one, mps&& two);
+
+    // fused multiply-add (single rounding)
+    //-------------------------------
+    [[nodiscard]] static mps fma(const mps& a, const mps& b, const mps& c);
+    mps& addProduct(const mps& a, const mps& b);
+    mps& subtractProduct(const mps& a, const mps& b);
+
+    // operations with a target format (operands in other formats are cast internally)
+    //-------------------------------
+    [[nodiscard]] static mps add(const mps& one, const mps& two, unsigned long mantissa_length, unsigned long exponent_length);
+    [[nodiscard]] static mps subtract(const mps& minuend, const mps& subtrahend, unsigned long mantissa_length, unsigned long exponent_length);
+    [[nodiscard]] static mps multiply(const mps& one, const mps& two, unsigned long mantissa_length, unsigned long exponent_length);
+    [[nodiscard]] static mps divide(const mps& dividend, const mps& divisor, unsigned long mantissa_length, unsigned long exponent_length);
+    [[nodiscard]] static mps fma(const mps& a, const mps& b, const mps& c, unsigned long mantissa_length, unsigned long exponent_length);
 
     // comparators
     //-------------------------------
@@ -100,10 +184,21 @@ public:
 
 private:
 
+    // selected arithmetic engine (the same for all objects)
+    //-------------------------------
+    static std::atomic<engine> arithmetic_engine;
+    static std::atomic<unsigned long> karatsuba_threshold;     // limbs (packed engine)
+    static std::atomic<unsigned long> newton_threshold;        // limbs (packed engine)
+
     // helper for cast
     //-------------------------------
     void resize_mps_object(unsigned long new_mantissa_size, unsigned long new_exponent_size);
 
+    // helper for the classification
+    //-------------------------------
+    void updateClassification();
+    [[nodiscard]] static mps classified(mps value);
+
     // helper for operators
     //-------------------------------
     void setValue(double value);
@@ -111,6 +206,10 @@ private:
     [[nodiscard]] static mps subtraction(const mps& minued, const mps& subtrahend, bool set_sign) ;
     [[nodiscard]] static mps multiplication(const mps& minued, const mps& subtrahend, bool set_sign) ;
     [[nodiscard]] static mps division(const mps& dividend, const mps& divisor, bool set_sign) ;
+    [[nodiscard]] static mps fusedOperation(const mps& a, const mps& b, const mps& c, bool negate_product) ;
+    [[nodiscard]] static mps fusedMultiplyAdd(const mps& a, const mps& b, const mps& c, bool negate_product) ;
+    static void calculateInto(const mps& one, const mps& two, char operation, mps* ret);
+    [[nodiscard]] static const mps& inFormat(const mps& value, unsigned long mantissa_length, unsigned long exponent_length, unsigned char slot) ;
 
     // helper for comparators
     //-------------------------------
@@ -123,26 +222,66 @@ private:
 
     [[nodiscard]] static char compare(const mps& one, const mps& two) ;
 
+    // packed engine (mps_packed.cpp)
+    //-------------------------------
+    [[nodiscard]] static bool packedSupported(const mps& one);
+    [[nodiscard]] static mps packedAddition(const mps& one, const mps& two, bool set_sign) ;
+    [[nodiscard]] static mps packedSubtraction(const mps& minued, const mps& subtrahend, bool set_sign) ;
+    [[nodiscard]] static mps packedMultiplication(const mps& one, const mps& two, bool set_sign) ;
+    [[nodiscard]] static mps packedDivision(const mps& dividend, const mps& divisor, bool set_sign) ;
+    static void packedAddition(const mps& one, const mps& two, bool set_sign, mps* ret) ;
+    static void packedSubtraction(const mps& minued, const mps& subtrahend, bool set_sign, mps* ret) ;
+    static void packedMultiplication(const mps& one, const mps& two, bool set_sign, mps* ret) ;
+    static void packedDivision(const mps& dividend, const mps& divisor, bool set_sign, mps* ret) ;
+    [[nodiscard]] static char packedCompare(const mps& one, const mps& two) ;
+    [[nodiscard]] static mps packedFusedMultiplyAdd(const mps& a, const mps& b, const mps& c, bool negate_product) ;
+
+    // integer kernels of the packed engine (mps_integer.cpp)
+    //-------------------------------
+    [[nodiscard]] static bool integerSupported(const mps& one);
+    static void integerAddition(const mps& one, const mps& two, bool set_sign, mps* ret) ;
+    static void integerSubtraction(const mps& minued, const mps& subtrahend, bool set_sign, mps* ret) ;
+    static void integerMultiplication(const mps& one, const mps& two, bool set_sign, mps* ret) ;
+    static void integerDivision(const mps& dividend, const mps& divisor, bool set_sign, mps* ret) ;
+
+    // cost model of the reference engine for the analytic and the sliced engine (mps_cost.cpp)
+    //-------------------------------
+    [[nodiscard]] static bool costSupported(const mps& one);
+    static void chargeAddition(const mps& one, const mps& two);
+    static void chargeSubtraction(const mps& minued, const mps& subtrahend);
+    static void chargeMultiplication(const mps& one, const mps& two);
+    static void chargeDivision(const mps& dividend, const mps& divisor);
+    static void chargeFusedMultiplyAdd(const mps& a, const mps& b, const mps& c, bool negate_product);
+    static void chargeOperator(const mps& one, const mps& two, char operation);
+
+    // native engine (mps_native.cpp)
+    //-------------------------------
+    [[nodiscard]] static bool nativeSupported(const mps& one, const mps& two, char operation);
+    [[nodiscard]] static mps nativeCalculation(const mps& one, const mps& two, bool set_sign, char operation) ;
+
     // general helper functions
     //-------------------------------
-    [[nodiscard]] static vector<bool> binaryAddition(const vector<bool>& one, const vector<bool>& two, bool* carrier_return = nullptr);
-    [[nodiscard]] static vector<bool> binarySubtraction(const vector<bool>& minuend, const vector<bool>& subtrahend);
+    void checkAssignment(const mps& other);
+    void clear() noexcept;
+    [[nodiscard]] static packed_bits binaryAddition(const packed_bits& one, const packed_bits& two, bool* carrier_return = nullptr);
+    [[nodiscard]] static packed_bits binarySubtraction(const packed_bits& minuend, const packed_bits& subtrahend);
 
-    static void binarySummation(vector<bool>* summand, const vector<bool>& addend, bool = false);
-    static vector<bool> binaryOffsetAddition(const vector<bool>& lp, const vector<bool>& rp, unsigned long off_set, bool c, const bool p[2], const bool hd[2],  bool* cr = nullptr);
-    static inline bool round(vector<bool>* mantissa, unsigned long mantissa_len);
+    static void binarySummation(packed_bits* summand, const packed_bits& addend, bool = false);
+    [[nodiscard]] static packed_bits boothMultiplication(const packed_bits& one, const packed_bits& two);
+    static packed_bits binaryOffsetAddition(const packed_bits& lp, const packed_bits& rp, unsigned long off_set, bool c, const bool p[2], const bool hd[2],  bool* cr = nullptr);
+    static inline bool round(packed_bits* mantissa, unsigned long mantissa_len);
 
-    [[nodiscard]] static unsigned long binaryToInt(vector<bool> bit_vector);
-    [[nodiscard]] static vector<bool> intToBinary(unsigned long value);
+    [[nodiscard]] static unsigned long binaryToInt(packed_bits bit_vector);
+    [[nodiscard]] static packed_bits intToBinary(unsigned long value);
 
     [[nodiscard]] long getBias() const;
-    [[nodiscard]] static char larger(const vector<bool>& a, const vector<bool>& b, bool division_case = false);
-    static void shiftLeft(vector<bool>* vec);
-    static bool addOneToBinary(vector<bool>* vector);
-    static bool subtractOneFromBinary(vector<bool>* vector);
-    [[nodiscard]] static vector<bool> invertAndAddOne(const vector<bool> &vec, bool *carrie = nullptr, bool division_case = false);
-    [[nodiscard]] static bool allTrue(const vector<bool>& vector);
-    [[nodiscard]] static bool allFalse(const vector<bool>& vector);
+    [[nodiscard]] static char larger(const packed_bits& a, const packed_bits& b, bool division_case = false);
+    static void shiftLeft(packed_bits* vec);
+    static bool addOneToBinary(packed_bits* vector);
+    static bool subtractOneFromBinary(packed_bits* vector);
+    [[nodiscard]] static packed_bits invertAndAddOne(const packed_bits &vec, bool *carrie = nullptr, bool division_case = false);
+    [[nodiscard]] static bool allTrue(const packed_bits& vector);
+    [[nodiscard]] static bool allFalse(const packed_bits& vector);
 };
 
 
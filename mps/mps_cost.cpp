@@ -0,0 +1,761 @@
+//
+// Cost model of the reference engine (analytic engine).
+//
+// The analytic engine computes the results with the packed engine and charges the counters (mps_counters.h) with the
+// work that the bit level algorithms of the reference engine (mps.cpp) do for the same operands. This work only depends
+// on a few quantities of the operands and the exact result: the alignment distance, the transitions of the Booth
+// multiplier, the leading zeros before the normalisation, the trailing ones of incremented numbers and the position of
+// the first sticky bit. They are computed here with 64/128-bit integers (256 bits for the registers of the fused
+// multiply-add), step for step in the order of the reference algorithms. The calibration tests (unit_tests/mps_counters.cpp) compare the charged counts with the counted ones.
+//
+// The sliced engine (mps_sliced.h) charges the same cost for every lane (chargeOperator).
+//
+
+#include "mps.h"
+#include "mps_counters.h"
+
+#include <algorithm>
+
+namespace {
+
+    typedef unsigned __int128 uint128;
+
+    uint64_t mask(unsigned long length){
+        return length >= 64 ? ~0ULL : (1ULL << length) - 1;
+    }
+
+    uint128 mask128(unsigned long length){
+        return length >= 128 ? ~(uint128) 0 : ((uint128) 1 << length) - 1;
+    }
+
+    unsigned long highestBit(uint128 value){
+        auto high = (uint64_t) (value >> 64);
+        return high ? 127 - __builtin_clzll(high) : 63 - __builtin_clzll((uint64_t) value);
+    }
+
+    /**
+     * Bits compared by mps::larger and mps::compare (from the most significant bit to the first different one).
+     */
+    unsigned long comparedBits(uint64_t a, uint64_t b, unsigned long length){
+        return a == b ? length : length - highestBit(a ^ b);
+    }
+
+    /**
+     * Half adders of mps::addOneToBinary (up to the first zero from the right).
+     */
+    unsigned long incrementCost(uint64_t value, unsigned long length){
+        return std::min<unsigned long>(__builtin_ctzll(~value) + 1, length);
+    }
+
+    /**
+     * Half adders of mps::subtractOneFromBinary and mps::invertAndAddOne (up to the first one from the right).
+     */
+    unsigned long decrementCost(uint64_t value, unsigned long length){
+        return 0 == value ? length : std::min<unsigned long>(__builtin_ctzll(value) + 1, length);
+    }
+
+    /**
+     * Charges mps::addOneToBinary on an exponent and increments it.
+     */
+    void chargeIncrement(uint64_t* exponent, unsigned long length){
+        mps_counters::addHalfAdders(incrementCost(*exponent, length));
+        *exponent = (*exponent + 1) & mask(length);
+    }
+
+    /**
+     * Charges mps::binarySubtraction (the subtrahend is inverted and incremented, then added unless it was zero).
+     */
+    void chargeBinarySubtraction(uint64_t subtrahend, unsigned long length){
+        mps_counters::addHalfAdders(decrementCost(subtrahend, length));
+        if(0 != subtrahend){
+            mps_counters::addFullAdders(length);
+        }
+    }
+
+    /**
+     * Charges mps::round on a mantissa of the given length (the hidden digit is already removed).
+     *
+     * @param value the bits of the mantissa
+     * @param length the length of the mantissa
+     * @param mantissa_length the length to which it is rounded
+     * @return true if the rounding overflowed (the exponent must be incremented)
+     */
+    bool chargeRound(uint128 value, unsigned long length, unsigned long mantissa_length){
+
+        if(length <= mantissa_length){
+            return false;
+        }
+
+        // sticky bits: scanned up to the first one
+        auto sticky_length = length - mantissa_length - 1;
+        auto sticky = value & mask128(sticky_length);
+        mps_counters::addBitComparisons(sticky ? sticky_length - highestBit(sticky) : sticky_length);
+
+        auto head = (uint64_t) (value >> (sticky_length + 1));
+        bool round_bit = (value >> sticky_length) & 1;
+        if(round_bit && (sticky || (head & 1))){
+            mps_counters::addHalfAdders(incrementCost(head, mantissa_length));
+            return head == mask(mantissa_length);
+        }
+
+        return false;
+    }
+
+    /**
+     * Charges mps::boothMultiplication: one summation per transition of the multiplier (M + 2 bits with the hidden
+     * digit).
+     *
+     * @return the exact product of the significands
+     */
+    uint128 chargeBooth(uint64_t m1, uint64_t m2, unsigned long M){
+
+        mps_counters::addHalfAdders(decrementCost(m1, M));
+
+        const uint64_t multiplier = (1ULL << M) | m2;
+        const auto transitions = (unsigned long) __builtin_popcountll((multiplier ^ (multiplier << 1)) & mask(M + 2));
+        mps_counters::addFullAdders(transitions * (M + 2));
+        mps_counters::addShifts(M + 2);
+
+        return (uint128) ((1ULL << M) | m1) * multiplier;
+    }
+
+    /**
+     * Unsigned integer of 256 bits (little endian words) for the registers of the fused multiply-add (up to 3M + 13
+     * bits).
+     */
+    struct wide {
+
+        uint64_t words[4] = {0, 0, 0, 0};
+
+        [[nodiscard]] bool bit(unsigned long idx) const {
+            return (words[idx / 64] >> (idx % 64)) & 1;
+        }
+
+        // position of the highest one (the value must not be zero)
+        [[nodiscard]] unsigned long highestBit() const {
+            for(unsigned long i = 4; i > 0;){
+                i--;
+                if(words[i]){
+                    return 64 * i + 63 - __builtin_clzll(words[i]);
+                }
+            }
+            return 0;
+        }
+
+        // position of the lowest one (the value must not be zero)
+        [[nodiscard]] unsigned long lowestBit() const {
+            for(unsigned long i = 0; i < 4; i++){
+                if(words[i]){
+                    return 64 * i + __builtin_ctzll(words[i]);
+                }
+            }
+            return 0;
+        }
+
+        // the bits [first, first + length) (length <= 64)
+        [[nodiscard]] uint64_t bits(unsigned long first, unsigned long length) const {
+
+            uint64_t ret = words[first / 64] >> (first % 64);
+            if(first % 64 && first / 64 < 3){
+                ret |= words[first / 64 + 1] << (64 - first % 64);
+            }
+            return ret & mask(length);
+        }
+
+        // the bits below idx
+        [[nodiscard]] wide below(unsigned long idx) const {
+            wide ret;
+            for(unsigned long i = 0; i < 4; i++){
+                if(64 * (i + 1) <= idx){
+                    ret.words[i] = words[i];
+                } else if(64 * i < idx){
+                    ret.words[i] = words[i] & mask(idx % 64);
+                }
+            }
+            return ret;
+        }
+
+        [[nodiscard]] bool isZero() const {
+            return 0 == (words[0] | words[1] | words[2] | words[3]);
+        }
+
+        [[nodiscard]] char compare(const wide& other) const {
+            for(unsigned long i = 4; i > 0;){
+                i--;
+                if(words[i] != other.words[i]){
+                    return words[i] > other.words[i] ? 1 : -1;
+                }
+            }
+            return 0;
+        }
+
+        [[nodiscard]] wide operator^(const wide& other) const {
+            wide ret;
+            for(unsigned long i = 0; i < 4; i++){
+                ret.words[i] = words[i] ^ other.words[i];
+            }
+            return ret;
+        }
+
+        [[nodiscard]] wide operator+(const wide& other) const {
+            wide ret;
+            uint128 carrier = 0;
+            for(unsigned long i = 0; i < 4; i++){
+                carrier += (uint128) words[i] + other.words[i];
+                ret.words[i] = (uint64_t) carrier;
+                carrier >>= 64;
+            }
+            return ret;
+        }
+
+        [[nodiscard]] wide operator-(const wide& other) const {
+            wide ret;
+            uint64_t borrow = 0;
+            for(unsigned long i = 0; i < 4; i++){
+                auto tmp = words[i] - other.words[i];
+                ret.words[i] = tmp - borrow;
+                borrow = (words[i] < other.words[i] || tmp < borrow) ? 1 : 0;
+            }
+            return ret;
+        }
+    };
+
+    /**
+     * Places a significand into a register of the fused multiply-add like mps::fusedMultiplyAdd: its first bit goes to
+     * the index offset (counted from the most significant bit), the bits behind the register are collected in its last
+     * bit.
+     *
+     * @param value the significand
+     * @param length the number of bits of the significand
+     * @param offset the index of its first bit
+     * @param W the length of the register
+     */
+    wide place(uint128 value, unsigned long length, unsigned long offset, unsigned long W){
+
+        wide ret;
+        auto end = offset + length;
+
+        if(end <= W){
+            // shift to the left
+            auto count = W - end;
+            uint64_t parts[2] = {(uint64_t) value, (uint64_t) (value >> 64)};
+            for(unsigned long i = 0; i < 2; i++){
+                auto idx = i + count / 64;
+                if(idx < 4){
+                    ret.words[idx] |= parts[i] << (count % 64);
+                }
+                if(count % 64 && idx + 1 < 4){
+                    ret.words[idx + 1] |= parts[i] >> (64 - count % 64);
+                }
+            }
+        } else {
+            // shift to the right, the shifted out bits are collected in the last bit
+            auto count = end - W;
+            uint128 shifted = count >= 128 ? 0 : value >> count;
+            if(count >= 128 || (value & mask128(count))){
+                shifted |= 1;
+            }
+            ret.words[0] = (uint64_t) shifted;
+            ret.words[1] = (uint64_t) (shifted >> 64);
+        }
+
+        return ret;
+    }
+}
+
+
+/**
+ * Checks whether the cost model covers the format (significands of up to 63 bits, so that products fit in 128 bits).
+ *
+ * @param one an operand
+ * @return true if the cost can be charged by the model
+ */
+bool mps::costSupported(const mps& one){
+    return packedSupported(one) && one.mantissa_length <= 62;
+}
+
+/**
+ * Charges the cost of mps::addition (operands with the same sign).
+ *
+ * @param one reference to the first addend
+ * @param two reference to the second addend
+ */
+void mps::chargeAddition(const mps& one, const mps& two){
+
+    if(!mps_counters::enabled){
+        return;
+    }
+
+    const auto M = one.mantissa_length;
+    const auto E = one.exponent_length;
+    uint64_t e1 = one.exponent.toInt(), e2 = two.exponent.toInt();
+    uint64_t m1 = one.mantissa.toInt(), m2 = two.mantissa.toInt();
+
+    // exponents (the operand with the larger exponent is the first one, the algorithm is symmetric)
+    //-------------------------------
+    mps_counters::addBitComparisons(comparedBits(e1, e2, E));
+    if(e1 < e2){
+        std::swap(e1, e2);
+        std::swap(m1, m2);
+    }
+
+    unsigned long diff = e1 - e2;
+    if(0 != diff){
+        chargeBinarySubtraction(e2, E);
+
+        if(diff > M){
+            if(diff == M + 1 && (m1 & 1) && 0 == m2){
+                mps_counters::addHalfAdders(incrementCost(m1, M));
+                if(m1 == mask(M)){
+                    chargeIncrement(&e1, E);
+                }
+            }
+            return;
+        }
+    }
+    //-------------------------------
+
+    // offset addition, rounding and carrier
+    //-------------------------------
+    mps_counters::addFullAdders(M + diff + 1);
+    if(diff > 0){
+        mps_counters::addShifts(1);
+    }
+
+    uint128 sum = ((((uint128) 1 << M) | m1) << diff) + (((uint128) 1 << M) | m2);
+    bool carrier = (sum >> (M + diff + 1)) & 1;
+    unsigned long length = M + diff + (carrier ? 1 : 0);
+
+    if(chargeRound(sum & mask128(length), length, M)){
+        chargeIncrement(&e1, E);
+    }
+    if(carrier){
+        chargeIncrement(&e1, E);
+    }
+    //-------------------------------
+}
+
+/**
+ * Charges the cost of mps::subtraction (operands with the same sign).
+ *
+ * @param minued reference to the minued number
+ * @param subtrahend reference to the subtracted number
+ */
+void mps::chargeSubtraction(const mps& minued, const mps& subtrahend){
+
+    if(!mps_counters::enabled){
+        return;
+    }
+
+    const auto M = minued.mantissa_length;
+    const auto E = minued.exponent_length;
+    uint64_t e1 = minued.exponent.toInt(), e2 = subtrahend.exponent.toInt();
+    uint64_t m1 = minued.mantissa.toInt(), m2 = subtrahend.mantissa.toInt();
+
+    // exponents (the operand with the larger magnitude is the first one)
+    //-------------------------------
+    mps_counters::addBitComparisons(comparedBits(e1, e2, E));
+
+    unsigned long diff = 0;
+    if(e1 == e2){
+        mps_counters::addBitComparisons(comparedBits(m1, m2, M));
+        if(m1 == m2){
+            return;
+        }
+        if(m1 < m2){
+            std::swap(m1, m2);
+        }
+    } else {
+        if(e1 < e2){
+            std::swap(e1, e2);
+            std::swap(m1, m2);
+        }
+        chargeBinarySubtraction(e2, E);
+
+        diff = e1 - e2;
+        if(diff > M){
+            if(diff == M + 1){
+                if(0 == m1){
+                    mps_counters::addHalfAdders(decrementCost(e1, E));
+                }
+                mps_counters::addHalfAdders(decrementCost(m1, M));
+            }
+            return;
+        }
+    }
+    //-------------------------------
+
+    // offset addition of the two's complement
+    //-------------------------------
+    mps_counters::addHalfAdders(decrementCost(m2, M));
+    mps_counters::addFullAdders(M + diff + 1);
+    if(diff > 0){
+        mps_counters::addShifts(1);
+    }
+
+    uint128 difference = ((((uint128) 1 << M) | m1) << diff) - (((uint128) 1 << M) | m2);
+    //-------------------------------
+
+    // normalisation and rounding
+    //-------------------------------
+    unsigned long length = M + diff;
+    unsigned long leading_zeros = length - highestBit(difference);
+    mps_counters::addBitComparisons(leading_zeros + 1);
+    mps_counters::addShifts(1);
+
+    chargeBinarySubtraction(leading_zeros, E);
+    e1 = (e1 - leading_zeros) & mask(E);
+
+    if(chargeRound((difference << leading_zeros) & mask128(length), length, M)){
+        chargeIncrement(&e1, E);
+    }
+    //-------------------------------
+}
+
+/**
+ * Charges the cost of mps::multiplication.
+ *
+ * @param one reference to the first multiplicand
+ * @param two reference to the second multiplicand
+ */
+void mps::chargeMultiplication(const mps& one, const mps& two){
+
+    if(!mps_counters::enabled){
+        return;
+    }
+
+    const auto M = one.mantissa_length;
+    const auto E = one.exponent_length;
+    const uint64_t top = 1ULL << (E - 1);
+    const uint64_t e1 = one.exponent.toInt(), e2 = two.exponent.toInt();
+    const uint64_t m1 = one.mantissa.toInt(), m2 = two.mantissa.toInt();
+
+    // exponent
+    //-------------------------------
+    uint64_t exponent;
+    if((e1 & top) && (e2 & top)){
+
+        uint64_t addend = e2 ^ top;
+        chargeIncrement(&addend, E);
+        mps_counters::addFullAdders(E);
+
+        exponent = e1 + addend;
+        if((exponent >> E) && !(addend & top)){
+            return;     // overflow
+        }
+        exponent &= mask(E);
+
+    } else {
+
+        uint64_t subtrahend;
+        if(e1 & top){
+            chargeBinarySubtraction(e1, E);
+            subtrahend = (top - 1 - e1) & mask(E);
+            chargeBinarySubtraction(subtrahend, E);
+            exponent = (e2 - subtrahend) & mask(E);
+        } else {
+            chargeBinarySubtraction(e2, E);
+            subtrahend = (top - 1 - e2) & mask(E);
+
+            if(!(e2 & top)){
+                mps_counters::addBitComparisons(comparedBits(subtrahend, e1, E));
+                if(subtrahend > e1){
+                    return;     // underflow
+                }
+            }
+
+            chargeBinarySubtraction(subtrahend, E);
+            exponent = (e1 - subtrahend) & mask(E);
+        }
+    }
+    //-------------------------------
+
+    // Booth multiplication
+    //-------------------------------
+    const uint128 product = chargeBooth(m1, m2, M);
+    //-------------------------------
+
+    // normalisation and rounding
+    //-------------------------------
+    unsigned long leading_zeros = 2 * M + 2 - highestBit(product);
+    mps_counters::addBitComparisons(leading_zeros + 1);
+
+    unsigned long length = 2 * M + 2 - leading_zeros;
+    if(chargeRound(product & mask128(length), length, M)){
+        chargeIncrement(&exponent, E);
+    }
+    if(leading_zeros <= 1){
+        chargeIncrement(&exponent, E);
+    }
+    //-------------------------------
+}
+
+/**
+ * Charges the cost of mps::division.
+ *
+ * @param dividend reference to the dividend of the division
+ * @param divisor reference to the divisor of the division
+ */
+void mps::chargeDivision(const mps& dividend, const mps& divisor){
+
+    if(!mps_counters::enabled){
+        return;
+    }
+
+    const auto M = dividend.mantissa_length;
+    const auto E = dividend.exponent_length;
+    const uint64_t top = 1ULL << (E - 1);
+    const uint64_t e1 = dividend.exponent.toInt(), e2 = divisor.exponent.toInt();
+    const uint64_t m1 = dividend.mantissa.toInt(), m2 = divisor.mantissa.toInt();
+
+    // exponent
+    //-------------------------------
+    if(e2 & top){
+
+        uint64_t subtrahend = e2 ^ top;
+        chargeIncrement(&subtrahend, E);
+        chargeBinarySubtraction(subtrahend, E);
+
+        uint64_t exponent = (e1 - subtrahend) & mask(E);
+        mps_counters::addBitComparisons(comparedBits(exponent, e1, E));
+        if(exponent > e1){
+            return;     // underflow
+        }
+
+    } else {
+
+        chargeBinarySubtraction(e2, E);
+        mps_counters::addFullAdders(E);
+
+        uint64_t exponent = e1 + ((top - 1 - e2) & mask(E));
+        if((exponent >> E) || (exponent & mask(E)) == mask(E)){
+            return;     // overflow
+        }
+    }
+    //-------------------------------
+
+    // restoring division on a remainder of M + 3 bits
+    //-------------------------------
+    mps_counters::addHalfAdders(1 + (0 == m2 ? M + 1 : decrementCost(m2, M)));
+
+    const uint128 remainder_mask = mask128(M + 3);
+    const uint128 divisor_bits = (uint128) ((1ULL << M) | m2) << 1;
+    uint128 remainder = (1ULL << M) | m1;
+
+    // shift, compare (mps::larger in the division case) and subtract if the divisor fits
+    auto step = [&](bool subtract) -> bool {
+
+        mps_counters::addShifts(1);
+        remainder = (remainder << 1) & remainder_mask;
+
+        if(!((remainder >> (M + 2)) & 1) && ((remainder >> (M + 1)) & 1)){
+            mps_counters::addBitComparisons(comparedBits((uint64_t) (remainder >> 1) & mask(M), m2, M));
+        }
+
+        if(remainder < divisor_bits){
+            return false;
+        }
+        if(subtract){
+            mps_counters::addFullAdders(M + 3);
+            remainder = (remainder - divisor_bits) & remainder_mask;
+        }
+        return true;
+    };
+
+    uint64_t quotient = 0;
+    for(unsigned long i = 0; i < M; i++){
+        quotient = (quotient << 1) | step(true);
+    }
+    //-------------------------------
+
+    // normalisation (the loop of the reference engine runs while the index is smaller than the shrinking quotient)
+    //-------------------------------
+    unsigned long length = M;
+    unsigned long count = 0;
+    uint64_t count_vec = 0;
+    for(unsigned long i = 0; i < length; i++){
+        mps_counters::addBitComparisons(1);
+
+        bool leading = (quotient >> (length - 1)) & 1;
+        length--;
+        quotient &= mask(length);
+        count++;
+
+        if(leading){
+            break;
+        }
+        chargeIncrement(&count_vec, E);
+    }
+
+    for(unsigned long i = 0; i < count; i++){
+        quotient = (quotient << 1) | step(true);
+        length++;
+    }
+
+    chargeBinarySubtraction(count_vec, E);
+    //-------------------------------
+
+    // rounding
+    //-------------------------------
+    if(step(false)){
+        mps_counters::addHalfAdders(incrementCost(quotient, length));
+    }
+    //-------------------------------
+}
+
+/**
+ * Charges the cost of mps::fusedMultiplyAdd.
+ *
+ * @param a reference to the first factor
+ * @param b reference to the second factor
+ * @param c reference to the summand
+ * @param negate_product true to subtract the product from c
+ */
+void mps::chargeFusedMultiplyAdd(const mps& a, const mps& b, const mps& c, bool negate_product){
+
+    if(!mps_counters::enabled){
+        return;
+    }
+
+    const auto M = a.mantissa_length;
+    const auto E = a.exponent_length;
+    const auto W = 3 * M + 13;
+    const long bias = (1L << (E - 1)) - 1;
+
+    auto unbiased = [bias](const mps& x) -> long { return (long) x.exponent.toInt() - bias; };
+
+    // exact product
+    //-------------------------------
+    const uint128 product = chargeBooth(a.mantissa.toInt(), b.mantissa.toInt(), M);
+    mps_counters::addFullAdders(2 * (E + 2));
+    //-------------------------------
+
+    // addition of c
+    //-------------------------------
+    wide sum;
+
+    if(c.isZero()){
+        sum = place(product, 2 * M + 2, 1, W);
+    } else {
+
+        long top_product = unbiased(a) + unbiased(b) + 1;
+        long top_summand = unbiased(c);
+        long top = std::max(top_product, top_summand);
+        mps_counters::addFullAdders(E + 2);
+
+        auto X = place(product, 2 * M + 2, 1 + std::min((unsigned long) (top - top_product), W), W);
+        auto Y = place(((uint128) 1 << M) | c.mantissa.toInt(), M + 1, 1 + std::min((unsigned long) (top - top_summand), W), W);
+        if(top_product != top_summand){
+            mps_counters::addShifts(1);
+        }
+
+        if(((a.sign != b.sign) != negate_product) == c.sign){
+            mps_counters::addFullAdders(W);
+            sum = X + Y;
+        } else {
+
+            auto larger_tmp = X.compare(Y);
+            mps_counters::addBitComparisons(0 == larger_tmp ? W : W - (X ^ Y).highestBit());
+            if(0 == larger_tmp){
+                return;
+            }
+
+            const auto& subtrahend = larger_tmp > 0 ? Y : X;
+            mps_counters::addHalfAdders(subtrahend.lowestBit() + 1);
+            mps_counters::addFullAdders(W);
+            sum = larger_tmp > 0 ? X - Y : Y - X;
+        }
+    }
+    //-------------------------------
+
+    // normalisation and rounding (like chargeRound)
+    //-------------------------------
+    unsigned long leading_zeros = W - 1 - sum.highestBit();
+    mps_counters::addBitComparisons(leading_zeros + 1);
+    mps_counters::addShifts(1);
+    mps_counters::addFullAdders(E + 2);
+
+    unsigned long length = W - 1 - leading_zeros;
+    if(length > M){
+
+        // sticky bits: scanned up to the first one
+        auto sticky_length = length - M - 1;
+        auto sticky = sum.below(sticky_length);
+        mps_counters::addBitComparisons(sticky.isZero() ? sticky_length : sticky_length - sticky.highestBit());
+
+        auto head = sum.bits(sticky_length + 1, M);
+        if(sum.bit(sticky_length) && (!sticky.isZero() || (head & 1))){
+            mps_counters::addHalfAdders(incrementCost(head, M));
+        }
+    }
+    //-------------------------------
+}
+
+/**
+ * Charges the cost of an operator (+, -, * or /) of the reference engine for values that were computed by another
+ * engine (the lanes of mps_sliced.h). The operands are dispatched like in the operators: special values do not reach
+ * the kernels and cost nothing, the signs select mps::addition or mps::subtraction. Formats that the model does not
+ * cover run the kernel itself (the bit level algorithms, unless the packed engine is selected).
+ *
+ * @param one the first operand
+ * @param two the second operand
+ * @param operation '+', '-', '*' or '/'
+ */
+void mps::chargeOperator(const mps& one, const mps& two, char operation){
+
+    if(!mps_counters::enabled){
+        return;
+    }
+    if(one.isNaN() || two.isNaN() || one.isInf() || two.isInf() || one.isZero() || two.isZero()){
+        return;
+    }
+
+    const auto model = costSupported(one);
+
+    auto add = [&](const mps& x, const mps& y, bool set_sign){
+        if(model){
+            chargeAddition(x, y);
+        } else {
+            static_cast<void>(addition(x, y, set_sign));
+        }
+    };
+    auto subtract = [&](const mps& minued, const mps& subtrahend, bool set_sign){
+        if(model){
+            chargeSubtraction(minued, subtrahend);
+        } else {
+            static_cast<void>(subtraction(minued, subtrahend, set_sign));
+        }
+    };
+
+    if('+' == operation){
+
+        if(one.isPositive() == two.isPositive()){
+            add(one, two, !one.isPositive());
+        } else if(!one.isPositive()){
+            subtract(two, one, false);
+        } else {
+            subtract(one, two, false);
+        }
+
+    } else if('-' == operation){
+
+        if(one.isPositive() == two.isPositive()){
+            subtract(one, two, !one.isPositive());
+        } else {
+            add(one, two, !one.isPositive());
+        }
+
+    } else if('*' == operation){
+
+        if(model){
+            chargeMultiplication(one, two);
+        } else {
+            static_cast<void>(multiplication(one, two, one.sign != two.sign));
+        }
+
+    } else if(model){
+        chargeDivision(one, two);
+    } else {
+        static_cast<void>(division(one, two, one.sign != two.sign));
+    }
+}
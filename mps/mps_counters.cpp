@@ -0,0 +1,281 @@
+//
+// mps_counters => per thread counter blocks and their aggregation.
+//
+
+#include "mps_counters.h"
+
+#ifdef MPS_COUNTERS
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#endif
+
+
+// snapshot
+//-------------------------------
+
+/**
+ * Returns the number of operations of a type (all formats).
+ *
+ * @param type the type of the operation
+ * @return the number of operations
+ */
+unsigned long long mps_counters::snapshot::operationCount(operation type) const {
+
+    unsigned long long ret = 0;
+    for(const auto& entry : operations){
+        ret += entry.second[(unsigned long) type];
+    }
+
+    return ret;
+}
+
+/**
+ * Returns the number of operations of a type in one format.
+ *
+ * @param type the type of the operation
+ * @param mantissa_length the mantissa length of the format
+ * @param exponent_length the exponent length of the format
+ * @return the number of operations
+ */
+unsigned long long mps_counters::snapshot::operationCount(operation type, unsigned long mantissa_length, unsigned long exponent_length) const {
+
+    auto entry = operations.find({mantissa_length, exponent_length});
+    if(entry == operations.end()){
+        return 0;
+    }
+
+    return entry->second[(unsigned long) type];
+}
+
+mps_counters::snapshot& mps_counters::snapshot::operator+=(const snapshot& other) {
+
+    full_adders += other.full_adders;
+    half_adders += other.half_adders;
+    shifts += other.shifts;
+    bit_comparisons += other.bit_comparisons;
+
+    for(const auto& entry : other.operations){
+        auto& counts = operations[entry.first];
+        for(unsigned long i = 0; i < operation_types; i++){
+            counts[i] += entry.second[i];
+        }
+    }
+
+    return *this;
+}
+
+/**
+ * Subtracts an earlier snapshot (the difference is the work done in between). Formats without operations are removed.
+ */
+mps_counters::snapshot& mps_counters::snapshot::operator-=(const snapshot& other) {
+
+    if(this == &other){
+        return *this = snapshot{};
+    }
+
+    full_adders -= other.full_adders;
+    half_adders -= other.half_adders;
+    shifts -= other.shifts;
+    bit_comparisons -= other.bit_comparisons;
+
+    for(const auto& entry : other.operations){
+        auto& counts = operations[entry.first];
+        bool empty = true;
+        for(unsigned long i = 0; i < operation_types; i++){
+            counts[i] -= entry.second[i];
+            empty = empty && 0 == counts[i];
+        }
+        if(empty){
+            operations.erase(entry.first);
+        }
+    }
+
+    return *this;
+}
+
+mps_counters::snapshot mps_counters::snapshot::operator+(const snapshot& other) const {
+    auto ret = *this;
+    return ret += other;
+}
+
+mps_counters::snapshot mps_counters::snapshot::operator-(const snapshot& other) const {
+    auto ret = *this;
+    return ret -= other;
+}
+
+bool mps_counters::snapshot::operator==(const snapshot& other) const {
+    return full_adders == other.full_adders && half_adders == other.half_adders && shifts == other.shifts
+        && bit_comparisons == other.bit_comparisons && operations == other.operations;
+}
+
+bool mps_counters::snapshot::operator!=(const snapshot& other) const {
+    return !(*this == other);
+}
+//-------------------------------
+
+
+#ifdef MPS_COUNTERS
+
+namespace {
+
+    // number of formats a thread counts individually (the last entry collects all further formats)
+    constexpr unsigned long format_slots = 64;
+
+    /**
+     * Counters of one thread. Only the owning thread writes them (relaxed load and store, no read-modify-write),
+     * read() may load them at any time from another thread.
+     */
+    struct counter_block {
+        std::atomic<unsigned long long> gates[4] = {};
+
+        // format key: (mantissa length << 32 | exponent length) + 1, 0 for an unused entry
+        std::atomic<unsigned long long> keys[format_slots] = {};
+        std::atomic<unsigned long long> operations[format_slots][mps_counters::operation_types] = {};
+
+        void collect(mps_counters::snapshot& sum) const {
+
+            sum.full_adders += gates[0].load(std::memory_order_relaxed);
+            sum.half_adders += gates[1].load(std::memory_order_relaxed);
+            sum.shifts += gates[2].load(std::memory_order_relaxed);
+            sum.bit_comparisons += gates[3].load(std::memory_order_relaxed);
+
+            for(unsigned long i = 0; i < format_slots; i++){
+                auto key = keys[i].load(std::memory_order_acquire);
+                if(0 == key){
+                    break;
+                }
+                mps_counters::format format{0, 0};
+                if(i + 1 < format_slots){
+                    format = {(key - 1) >> 32, (key - 1) & 0xffffffff};
+                }
+                auto& counts = sum.operations[format];
+                for(unsigned long j = 0; j < mps_counters::operation_types; j++){
+                    counts[j] += operations[i][j].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    /**
+     * All counter blocks. The mutex is only taken when a thread starts or stops counting and by read() and reset().
+     */
+    struct counter_registry {
+        std::mutex lock;
+        std::vector<counter_block*> live;
+        mps_counters::snapshot retired;     // counts of the finished threads
+        mps_counters::snapshot baseline;    // counts at the last reset
+
+        [[nodiscard]] mps_counters::snapshot total() const {
+            auto ret = retired;
+            for(auto block : live){
+                block->collect(ret);
+            }
+            return ret;
+        }
+    };
+
+    counter_registry& registry(){
+        // never destroyed, so threads finishing during the static destruction can still hand in their counts
+        static auto* ret = new counter_registry;
+        return *ret;
+    }
+
+    /**
+     * Registers the counter block of a thread on first use and hands in its counts when the thread finishes.
+     */
+    struct counter_owner {
+        counter_block* block;
+
+        counter_owner() : block(new counter_block) {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> guard(reg.lock);
+            reg.live.push_back(block);
+        }
+
+        ~counter_owner() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> guard(reg.lock);
+            block->collect(reg.retired);
+            reg.live.erase(std::find(reg.live.begin(), reg.live.end(), block));
+            delete block;
+        }
+    };
+
+    counter_block& local(){
+        thread_local counter_owner owner;
+        return *owner.block;
+    }
+
+    void increment(std::atomic<unsigned long long>& counter, unsigned long long count){
+        counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+}
+
+void mps_counters::add(unsigned char slot, unsigned long long count) {
+    increment(local().gates[slot], count);
+}
+
+/**
+ * Counts operations of a format.
+ *
+ * @param type the type of the operation
+ * @param mantissa_length the mantissa length of the format
+ * @param exponent_length the exponent length of the format
+ * @param count the number of operations
+ */
+void mps_counters::countOperation(operation type, unsigned long mantissa_length, unsigned long exponent_length, unsigned long long count) {
+
+    auto& block = local();
+    const unsigned long long key = (((unsigned long long) mantissa_length << 32) | exponent_length) + 1;
+
+    unsigned long i = 0;
+    for(; i + 1 < format_slots; i++){
+        auto current = block.keys[i].load(std::memory_order_relaxed);
+        if(current == key){
+            break;
+        }
+        if(0 == current){
+            block.keys[i].store(key, std::memory_order_release);
+            break;
+        }
+    }
+    if(i + 1 == format_slots && 0 == block.keys[i].load(std::memory_order_relaxed)){
+        block.keys[i].store(key, std::memory_order_release);
+    }
+
+    increment(block.operations[i][(unsigned long) type], count);
+}
+
+/**
+ * Returns the counts of all threads since the last reset.
+ *
+ * @return the aggregated counts
+ */
+mps_counters::snapshot mps_counters::read() {
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    return reg.total() - reg.baseline;
+}
+
+/**
+ * Sets all counts to zero. The threads keep counting into their blocks, only the baseline of read() is moved.
+ */
+void mps_counters::reset() {
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.baseline = reg.total();
+}
+
+#else
+
+mps_counters::snapshot mps_counters::read() {
+    return {};
+}
+
+void mps_counters::reset() {}
+
+#endif
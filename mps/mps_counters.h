@@ -0,0 +1,94 @@
+//
+// mps_counters => gate level operation counters (deterministic cost metric).
+//
+// The bit level algorithms (reference engine) count the evaluated full adders and half adders, the shifts of their
+// registers and the compared bits. Additionally, every arithmetic operation is counted per type and per format
+// (for all engines). Unlike a stopwatch, the counts do not depend on the machine or its load.
+//
+// Every thread counts into its own block, which only this thread writes (no locks, no atomic read-modify-write).
+// The blocks are aggregated on demand by read(). Counting is compiled in with the CMake option MPS_COUNTERS. Without
+// it the hooks are empty inline functions and read() returns an empty snapshot.
+//
+
+#ifndef MPS_MPS_COUNTERS_H
+#define MPS_MPS_COUNTERS_H
+
+#include <array>
+#include <map>
+#include <utility>
+
+class mps_counters {
+
+public:
+
+    // arithmetic operations that are counted per format
+    //-------------------------------
+    enum class operation : unsigned char { addition, subtraction, multiplication, division, fma };
+    static constexpr unsigned long operation_types = 5;
+
+    // format of the counted operations: (mantissa length, exponent length)
+    using format = std::pair<unsigned long, unsigned long>;
+
+#ifdef MPS_COUNTERS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    // aggregated counts
+    //-------------------------------
+    struct snapshot {
+        unsigned long long full_adders = 0;         // evaluated full adders (one per bit of an addition)
+        unsigned long long half_adders = 0;         // evaluated half adders (increments and decrements by one)
+        unsigned long long shifts = 0;              // register shifts (by one or more positions)
+        unsigned long long bit_comparisons = 0;     // compared bits (comparisons, sticky bits, normalisation)
+
+        // operations per format. Formats beyond the per thread table are counted as format (0, 0).
+        std::map<format, std::array<unsigned long long, operation_types>> operations;
+
+        [[nodiscard]] unsigned long long operationCount(operation type) const;
+        [[nodiscard]] unsigned long long operationCount(operation type, unsigned long mantissa_length, unsigned long exponent_length) const;
+
+        snapshot& operator+=(const snapshot& other);
+        snapshot& operator-=(const snapshot& other);
+        snapshot operator+(const snapshot& other) const;
+        snapshot operator-(const snapshot& other) const;
+        bool operator==(const snapshot& other) const;
+        bool operator!=(const snapshot& other) const;
+    };
+    //-------------------------------
+
+
+    // sum of all threads (also the finished ones) since the last reset
+    [[nodiscard]] static snapshot read();
+    static void reset();
+
+
+    // hooks used by the kernels
+    //-------------------------------
+#ifdef MPS_COUNTERS
+    static void addFullAdders(unsigned long long count) { add(full_adder_slot, count); }
+    static void addHalfAdders(unsigned long long count) { add(half_adder_slot, count); }
+    static void addShifts(unsigned long long count) { add(shift_slot, count); }
+    static void addBitComparisons(unsigned long long count) { add(bit_comparison_slot, count); }
+    static void countOperation(operation type, unsigned long mantissa_length, unsigned long exponent_length, unsigned long long count = 1);
+#else
+    static void addFullAdders(unsigned long long) {}
+    static void addHalfAdders(unsigned long long) {}
+    static void addShifts(unsigned long long) {}
+    static void addBitComparisons(unsigned long long) {}
+    static void countOperation(operation, unsigned long, unsigned long, unsigned long long = 1) {}
+#endif
+    //-------------------------------
+
+
+private:
+
+#ifdef MPS_COUNTERS
+    enum : unsigned char { full_adder_slot, half_adder_slot, shift_slot, bit_comparison_slot };
+    static void add(unsigned char slot, unsigned long long count);
+#endif
+};
+
+
+#endif //MPS_MPS_COUNTERS_H
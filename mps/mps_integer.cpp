@@ -0,0 +1,555 @@
+//
+// Integer kernels of the packed engine.
+//
+// For formats whose significand (hidden one and mantissa) has at most 113 bits, the packed engine computes with
+// uint64_t / unsigned __int128 integers instead of limb arrays (like softfloat): the smaller operand is aligned with a
+// right shift that keeps a sticky bit, the result is normalised with __builtin_clzll and rounded to nearest even using a
+// guard bit and the sticky bits. The results are exactly the same as the ones of the limb kernels in mps_packed.cpp
+// (and therefore the same as the ones of the bit level algorithms).
+//
+
+#include "mps.h"
+
+namespace {
+
+    typedef unsigned __int128 uint128;
+
+    constexpr unsigned long word_size = 64;
+    constexpr unsigned long extra_bits = 3;       // guard bit and two sticky bits below the mantissa
+
+    /**
+     * Returns the value of a bit field with at most 128 bits (first bit = most significant bit).
+     */
+    uint128 fieldValue(const packed_bits& field){
+
+        auto words = field.data();
+        auto s = field.wordCount() * word_size - field.size();
+
+        if(1 == field.wordCount()){
+            return words[0] >> s;
+        }
+        return ((((uint128) words[0]) << word_size) | words[1]) >> s;
+    }
+
+    /**
+     * Writes the lowest field.size() bits of value into a bit field with at most 128 bits.
+     */
+    void setFieldValue(packed_bits& field, uint128 value){
+
+        auto words = field.data();
+        auto s = field.wordCount() * word_size - field.size();
+
+        if(1 == field.wordCount()){
+            words[0] = ((uint64_t) value) << s;
+            return;
+        }
+        value <<= s;
+        words[0] = (uint64_t) (value >> word_size);
+        words[1] = (uint64_t) value;
+    }
+
+    /**
+     * Returns the number of bits needed to represent the value (0 for zero).
+     */
+    template<typename S>
+    unsigned long bitLength(S value){
+
+        if constexpr (sizeof(S) > sizeof(uint64_t)){
+            auto high = (uint64_t) (value >> word_size);
+            if(high){
+                return 2 * word_size - __builtin_clzll(high);
+            }
+        }
+
+        auto low = (uint64_t) value;
+        return low ? word_size - __builtin_clzll(low) : 0;
+    }
+
+    /**
+     * Shifts the value to the right. If any of the shifted out bits is set, the lowest bit of the result is set.
+     */
+    template<typename S>
+    S shiftRightJam(S value, unsigned long count){
+
+        constexpr unsigned long width = sizeof(S) * 8;
+
+        if(0 == count){
+            return value;
+        } else if(count >= width){
+            return value != 0;
+        }
+        return (value >> count) | ((value << (width - count)) != 0);
+    }
+
+    /**
+     * Moves the leading one of the value (at position lead) to the position M + extra_bits.
+     * Bits shifted out to the right are kept as sticky bit.
+     */
+    template<typename S>
+    S normalise(S value, unsigned long lead, unsigned long M){
+
+        if(lead >= M + extra_bits){
+            return shiftRightJam(value, lead - (M + extra_bits));
+        }
+        return value << (M + extra_bits - lead);
+    }
+
+    /**
+     * Rounds a normalised significand (leading one at position M + extra_bits) to nearest, ties to even.
+     *
+     * @param overflow set to true if rounding up overflowed (the result is zero in this case)
+     * @return the mantissa (without the leading one)
+     */
+    template<typename S>
+    S roundSignificand(S value, unsigned long M, bool* overflow){
+
+        S mask = (((S) 1) << M) - 1;
+        S ret = (value >> extra_bits) & mask;
+        bool guard = (value >> (extra_bits - 1)) & 1;
+        bool sticky = (value & ((((S) 1) << (extra_bits - 1)) - 1)) != 0;
+
+        *overflow = false;
+        if(guard && (sticky || (ret & 1))){
+            ret = (ret + 1) & mask;
+            *overflow = 0 == ret;
+        }
+
+        return ret;
+    }
+
+    /**
+     * Adds two significands (large >= small in exponent) whose exponents differ by exponent_diff <= M.
+     *
+     * @param carrier set to true if the sum is larger than or equal to two
+     * @param overflow set to true if rounding up overflowed
+     * @return the rounded mantissa
+     */
+    template<typename S>
+    S addSignificands(S large, S small, unsigned long exponent_diff, unsigned long M, bool* carrier, bool* overflow){
+
+        S sum = (large << extra_bits) + shiftRightJam<S>(small << extra_bits, exponent_diff);
+
+        *carrier = (sum >> (M + extra_bits + 1)) != 0;
+        if(*carrier){
+            sum = shiftRightJam<S>(sum, 1);
+        }
+
+        return roundSignificand(sum, M, overflow);
+    }
+
+    /**
+     * Subtracts two significands (large > small in magnitude) whose exponents differ by exponent_diff <= M.
+     *
+     * @param exponent_shift set to the number of positions the result was shifted to the left
+     * @param overflow set to true if rounding up overflowed
+     * @return the rounded mantissa
+     */
+    template<typename S>
+    S subtractSignificands(S large, S small, unsigned long exponent_diff, unsigned long M,
+                           unsigned long* exponent_shift, bool* overflow){
+
+        S diff = (large << extra_bits) - shiftRightJam<S>(small << extra_bits, exponent_diff);
+
+        // Jamming keeps the lowest bit of the difference set whenever bits were lost, so it cannot change the rounding.
+        *exponent_shift = M + extra_bits + 1 - bitLength(diff);
+        diff <<= *exponent_shift;
+
+        return roundSignificand(diff, M, overflow);
+    }
+
+    /**
+     * Multiplies two 128-bit integers.
+     *
+     * @param high set to the upper 128 bits of the product
+     * @return the lower 128 bits of the product
+     */
+    uint128 multiplyWide(uint128 a, uint128 b, uint128* high){
+
+        auto a0 = (uint64_t) a, a1 = (uint64_t) (a >> word_size);
+        auto b0 = (uint64_t) b, b1 = (uint64_t) (b >> word_size);
+
+        uint128 p00 = (uint128) a0 * b0;
+        uint128 p01 = (uint128) a0 * b1;
+        uint128 p10 = (uint128) a1 * b0;
+        uint128 p11 = (uint128) a1 * b1;
+
+        uint128 middle = (p00 >> word_size) + (uint64_t) p01 + (uint64_t) p10;
+        *high = p11 + (p01 >> word_size) + (p10 >> word_size) + (middle >> word_size);
+
+        return (uint64_t) p00 | (middle << word_size);
+    }
+}
+
+/**
+ * Returns true if the significands of the format fit into the integer kernels (at most 113 bits).
+ *
+ * @param one reference to the mps object
+ * @return true if supported
+ */
+bool mps::integerSupported(const mps& one){
+    return one.mantissa_length <= 112;
+}
+
+/**
+ * Performs an addition on two mps objects that have the same sign (integer kernel of the packed engine).
+ *
+ * @param one reference to the first addend
+ * @param two reference to the second addend
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::integerAddition(const mps &one, const mps &two, const bool set_sign, mps* ret) {
+
+    // Set up the return object.
+    //-------------------------------
+    ret->exponent_length = one.exponent_length;
+    ret->mantissa_length = one.mantissa_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = one.mantissa_length;
+    const uint64_t mask = (((uint64_t) 1) << one.exponent_length) - 1;
+    //-------------------------------
+
+
+    // order the operands by exponent
+    //-------------------------------
+    auto e_one = one.exponent.toInt();
+    auto e_two = two.exponent.toInt();
+
+    const mps& large = e_one >= e_two ? one : two;
+    const mps& small = e_one >= e_two ? two : one;
+    auto e = e_one >= e_two ? e_one : e_two;
+    auto exponent_diff = e_one >= e_two ? e_one - e_two : e_two - e_one;
+
+    auto m_large = fieldValue(large.mantissa);
+    auto m_small = fieldValue(small.mantissa);
+
+    if(exponent_diff > M){
+
+        // special case where the rounding distance is the same, and the rounded number, therefore, must be even.
+        if(exponent_diff == M + 1 && (m_large & 1) && 0 == m_small){
+            m_large = (m_large + 1) & ((((uint128) 1) << M) - 1);
+            if(0 == m_large){
+                e = (e + 1) & mask;
+            }
+        }
+
+        setFieldValue(ret->mantissa, m_large);
+        ret->exponent.fromInt(e);
+        return;
+    }
+    //-------------------------------
+
+
+    // sum and rounding
+    //-------------------------------
+    auto hidden = ((uint128) 1) << M;
+    bool carrier, overflow;
+    uint128 mantissa;
+
+    if(M + extra_bits + 2 <= word_size){
+        mantissa = addSignificands<uint64_t>((uint64_t) (m_large | hidden), (uint64_t) (m_small | hidden),
+                                             exponent_diff, M, &carrier, &overflow);
+    } else {
+        mantissa = addSignificands<uint128>(m_large | hidden, m_small | hidden, exponent_diff, M, &carrier, &overflow);
+    }
+    setFieldValue(ret->mantissa, mantissa);
+
+    if(overflow){
+        e = (e + 1) & mask;
+    }
+    //-------------------------------
+
+    if(carrier){
+        e = (e + 1) & mask;
+        if(e == mask){
+            ret->setInf(set_sign);
+            return;
+        }
+    }
+
+    ret->exponent.fromInt(e);
+}
+
+/**
+ * Performs a subtraction on two mps objects that have the same sign (integer kernel of the packed engine).
+ *
+ * @param minued reference to the minued number
+ * @param subtrahend reference to the subtracted number
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::integerSubtraction(const mps &minued, const mps &subtrahend, bool set_sign, mps* ret) {
+
+    // Set up the return object.
+    //-------------------------------
+    ret->exponent_length = minued.exponent_length;
+    ret->mantissa_length = minued.mantissa_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = minued.mantissa_length;
+    const uint64_t mask = (((uint64_t) 1) << minued.exponent_length) - 1;
+    //-------------------------------
+
+
+    // order the operands by magnitude
+    //-------------------------------
+    auto e_minued = minued.exponent.toInt();
+    auto e_subtrahend = subtrahend.exponent.toInt();
+    auto m_minued = fieldValue(minued.mantissa);
+    auto m_subtrahend = fieldValue(subtrahend.mantissa);
+
+    if(e_minued == e_subtrahend && m_minued == m_subtrahend){
+        ret->setZero();
+        return;
+    }
+
+    bool minued_larger = e_minued > e_subtrahend || (e_minued == e_subtrahend && m_minued > m_subtrahend);
+    auto e = minued_larger ? e_minued : e_subtrahend;
+    auto exponent_diff = minued_larger ? e_minued - e_subtrahend : e_subtrahend - e_minued;
+    auto m_large = minued_larger ? m_minued : m_subtrahend;
+    auto m_small = minued_larger ? m_subtrahend : m_minued;
+    if(!minued_larger){
+        ret->sign = !ret->sign; // flip sign
+    }
+
+    if(exponent_diff > M){
+
+        if(exponent_diff == M + 1){
+            if(0 == m_large){
+                e = (e - 1) & mask;
+            }
+            m_large = (m_large - 1) & ((((uint128) 1) << M) - 1);
+        }
+
+        setFieldValue(ret->mantissa, m_large);
+        ret->exponent.fromInt(e);
+        return;
+    }
+    //-------------------------------
+
+
+    // difference, normalisation and rounding
+    //-------------------------------
+    auto hidden = ((uint128) 1) << M;
+    unsigned long exponent_shift;
+    bool overflow;
+    uint128 mantissa;
+
+    if(M + extra_bits + 2 <= word_size){
+        mantissa = subtractSignificands<uint64_t>((uint64_t) (m_large | hidden), (uint64_t) (m_small | hidden),
+                                                  exponent_diff, M, &exponent_shift, &overflow);
+    } else {
+        mantissa = subtractSignificands<uint128>(m_large | hidden, m_small | hidden, exponent_diff, M,
+                                                 &exponent_shift, &overflow);
+    }
+    setFieldValue(ret->mantissa, mantissa);
+
+    e = (e - exponent_shift) & mask;
+    if(overflow){
+        e = (e + 1) & mask;
+    }
+    //-------------------------------
+
+    ret->exponent.fromInt(e);
+}
+
+/**
+ * Performs a multiplication on two mps objects (integer kernel of the packed engine).
+ *
+ * @param one reference to the first multiplicand
+ * @param two reference to the second multiplicand
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::integerMultiplication(const mps& one, const mps& two, bool set_sign, mps* ret) {
+
+    // Set up the return object.
+    //-------------------------------
+    ret->exponent_length = one.exponent_length;
+    ret->mantissa_length = one.mantissa_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = one.mantissa_length;
+    const auto E = one.exponent_length;
+    const uint64_t mask = (((uint64_t) 1) << E) - 1;
+    const uint64_t top = ((uint64_t) 1) << (E - 1);
+    const uint64_t bias = top - 1;
+    //-------------------------------
+
+
+    // Calculate the exponent (see packedMultiplication)
+    //-------------------------------
+    auto e_one = one.exponent.toInt();
+    auto e_two = two.exponent.toInt();
+    uint64_t e;
+
+    if((e_one & top) && (e_two & top)){ // Both exponents are positive.
+
+        uint64_t addend = ((e_two ^ top) + 1) & mask;
+        e = e_one + addend;
+
+        // Check if the number will be more than the maximal allowed value.
+        if(e > mask && !(addend & top)){
+            ret->setInf(ret->sign);
+            return;
+        }
+        e &= mask;
+
+    } else if(e_one & top){
+        e = (e_two - ((bias - e_one) & mask)) & mask;
+    } else {
+        uint64_t subtrahend = (bias - e_two) & mask;
+
+        if(!(e_two & top) && subtrahend > e_one){
+            ret->setZero();
+            return;
+        }
+
+        e = (e_one - subtrahend) & mask;
+    }
+    //-------------------------------
+
+
+    // Calculate the mantissa
+    //-------------------------------
+    auto hidden = ((uint128) 1) << M;
+    auto a = fieldValue(one.mantissa) | hidden;
+    auto b = fieldValue(two.mantissa) | hidden;
+
+    // The product of the significands has 2M+1 or 2M+2 bits.
+    bool large;
+    uint128 product;
+
+    if(M < word_size){
+        product = a * b;
+        large = (product >> (2 * M + 1)) != 0;
+        product = normalise(product, 2 * M + large, M);
+    } else {
+        uint128 high;
+        uint128 low = multiplyWide(a, b, &high);
+        auto lead = 2 * M + 1 - 2 * word_size;      // position of the bit 2M+1 in the upper half
+        large = (high >> lead) != 0;
+
+        // (high, low) >> count, the shifted out bits are kept as sticky bit
+        auto count = 2 * M + large - (M + extra_bits);
+        auto sticky = (low << (2 * word_size - count)) != 0;
+        product = (high << (2 * word_size - count)) | (low >> count) | sticky;
+    }
+
+    bool overflow;
+    setFieldValue(ret->mantissa, roundSignificand(product, M, &overflow));
+    //-------------------------------
+
+    if(overflow){
+        e = (e + 1) & mask;
+    }
+    if(large){
+        e = (e + 1) & mask;
+    }
+
+    ret->exponent.fromInt(e);
+}
+
+/**
+ * Performs a division on two mps objects (integer kernel of the packed engine).
+ *
+ * @param dividend reference to the dividend of the division
+ * @param divisor reference to the divisor of the division
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::integerDivision(const mps& dividend, const mps& divisor, bool set_sign, mps* ret) {
+
+    // Set up the return object.
+    //-------------------------------
+    ret->mantissa_length = dividend.mantissa_length;
+    ret->exponent_length = dividend.exponent_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = dividend.mantissa_length;
+    const auto E = dividend.exponent_length;
+    const uint64_t mask = (((uint64_t) 1) << E) - 1;
+    const uint64_t top = ((uint64_t) 1) << (E - 1);
+    const uint64_t bias = top - 1;
+    //-------------------------------
+
+
+    // Calculate the exponent (see packedDivision)
+    //-------------------------------
+    auto e_dividend = dividend.exponent.toInt();
+    auto e_divisor = divisor.exponent.toInt();
+    uint64_t e;
+
+    if(e_divisor & top){
+
+        e = (e_dividend - (((e_divisor ^ top) + 1) & mask)) & mask;
+
+        if(e > e_dividend){
+            ret->setZero();
+            return;
+        }
+
+    } else {
+
+        e = e_dividend + ((bias - e_divisor) & mask);
+
+        if(e >= mask){
+            ret->setInf(ret->sign);
+            return;
+        }
+    }
+    //-------------------------------
+
+
+    // Division
+    //-------------------------------
+    auto hidden = ((uint128) 1) << M;
+    auto R = fieldValue(dividend.mantissa) | hidden;
+    auto D = fieldValue(divisor.mantissa) | hidden;
+
+    // quotient bits with the weights 2^0 to 2^-(M+2), i.e. floor(R * 2^(M+2) / D)
+    uint128 Q = 0;
+    if(2 * M + 3 <= 2 * word_size){
+        Q = (R << (M + 2)) / D;
+    } else {
+        for(auto i = M + 3; i > 0;){
+            i--;
+            if(R >= D){
+                R -= D;
+                Q |= ((uint128) 1) << i;
+            }
+            R <<= 1;
+        }
+    }
+
+    // normalisation (see packedDivision)
+    bool leading = (Q >> (M + 2)) & 1;
+    unsigned long count = (leading || M < 3) ? 1 : 2;
+    if(!leading){
+        e = (e - 1) & mask;
+    }
+
+    auto mantissa_mask = hidden - 1;
+    auto mantissa = (Q >> (3 - count)) & mantissa_mask;
+    //-------------------------------
+
+
+    // rounding
+    //-------------------------------
+    if((Q >> (2 - count)) & 1){
+        mantissa = (mantissa + 1) & mantissa_mask;
+    }
+    //-------------------------------
+
+    setFieldValue(ret->mantissa, mantissa);
+    ret->exponent.fromInt(e);
+}
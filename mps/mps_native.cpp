@@ -0,0 +1,176 @@
+//
+// Native engine of the mps class.
+//
+// Operations on the formats binary32 (23, 8) and binary64 (52, 11) are computed with the hardware float and double
+// arithmetic. The bits are moved between the packed storage and the hardware values with a few shifts. The results are
+// the same as the ones of the reference engine, so everything the hardware computes differently is left to the packed
+// engine: operands that the hardware interprets differently than mps (exponent 00...0 or 11...1), additions and
+// subtractions of operands whose exponents differ by more than the mantissa length (the reference engine returns the
+// larger operand without rounding), results at the limits of the normal range (the reference engine decides overflow
+// and underflow before the normalisation and wraps the exponent instead of returning a subnormal number) and all other
+// formats.
+//
+
+#include "mps.h"
+
+#include <cstring>
+#include <limits>
+
+namespace {
+
+    template<typename T> struct native_format;
+
+    template<> struct native_format<float> {
+        typedef uint32_t bits;
+        static constexpr unsigned long mantissa_length = 23;
+        static constexpr unsigned long exponent_length = 8;
+    };
+
+    template<> struct native_format<double> {
+        typedef uint64_t bits;
+        static constexpr unsigned long mantissa_length = 52;
+        static constexpr unsigned long exponent_length = 11;
+    };
+
+    /**
+     * Returns the magnitude of a number given by its bit fields as hardware value.
+     */
+    template<typename T>
+    T toNative(const packed_bits& exponent, const packed_bits& mantissa){
+
+        typedef typename native_format<T>::bits bits;
+        constexpr auto M = native_format<T>::mantissa_length;
+
+        bits value = ((bits) exponent.toInt() << M) | (bits) mantissa.toInt();
+
+        T ret;
+        std::memcpy(&ret, &value, sizeof ret);
+        return ret;
+    }
+
+    /**
+     * Writes the bits of a positive normal hardware value into the bit fields.
+     */
+    template<typename T>
+    void fromNative(T value, packed_bits& exponent, packed_bits& mantissa){
+
+        typedef typename native_format<T>::bits bits;
+        constexpr auto M = native_format<T>::mantissa_length;
+
+        bits tmp;
+        std::memcpy(&tmp, &value, sizeof tmp);
+
+        exponent.fromInt(tmp >> M);
+        mantissa.fromInt(tmp & ((((bits) 1) << M) - 1));
+    }
+
+    template<typename T>
+    T calculate(T one, T two, char operation){
+
+        switch(operation){
+            case '+': return one + two;
+            case '-': return one - two;
+            case '*': return one * two;
+            default:  return one / two;
+        }
+    }
+
+    /**
+     * Performs the operation on the magnitudes of two numbers and writes the result into the bit fields of the result.
+     *
+     * @param sign pointer to the sign of the result (turned if the result of a subtraction is negative)
+     * @return false if the result is not a normal number or has the lowest or highest exponent (nothing is written)
+     */
+    template<typename T>
+    bool nativeResult(const packed_bits& e_one, const packed_bits& m_one, const packed_bits& e_two,
+                      const packed_bits& m_two, char operation, bool* sign, packed_bits& exponent, packed_bits& mantissa){
+
+        auto value = calculate(toNative<T>(e_one, m_one), toNative<T>(e_two, m_two), operation);
+
+        if(value < 0){
+            *sign = !*sign;
+            value = -value;
+        }
+
+        // zero, subnormal numbers, infinity and the lowest and highest exponent (the reference engine checks the range
+        // before the result is normalised)
+        if(!(value >= 2 * std::numeric_limits<T>::min() && value <= std::numeric_limits<T>::max() / 2)){
+            return false;
+        }
+
+        fromNative(value, exponent, mantissa);
+        return true;
+    }
+}
+
+/**
+ * Returns true if the operation on the two mps objects can be computed by the hardware.
+ * The format must be binary32 or binary64, and both exponents must be different from 00...0 and 11...1. For additions
+ * and subtractions the exponents must not differ by more than the mantissa length.
+ *
+ * @param one reference to the first operand
+ * @param two reference to the second operand
+ * @param operation the operation ('+', '-', '*' or '/')
+ * @return true if supported
+ */
+bool mps::nativeSupported(const mps& one, const mps& two, char operation){
+
+    bool binary32 = 23 == one.mantissa_length && 8 == one.exponent_length;
+    bool binary64 = 52 == one.mantissa_length && 11 == one.exponent_length;
+    if(!binary32 && !binary64){
+        return false;
+    }
+
+    // The hardware reads these exponents as subnormal numbers or as infinity and NaN.
+    auto mask = (((uint64_t) 1) << one.exponent_length) - 1;
+    auto e_one = one.exponent.toInt();
+    auto e_two = two.exponent.toInt();
+
+    if(0 == e_one || mask == e_one || 0 == e_two || mask == e_two){
+        return false;
+    }
+
+    // The reference engine returns the larger operand if the smaller one is shifted out completely.
+    auto difference = e_one > e_two ? e_one - e_two : e_two - e_one;
+    return ('+' != operation && '-' != operation) || difference <= one.mantissa_length;
+}
+
+/**
+ * Performs an operation on the magnitudes of two mps objects with the hardware (native engine).
+ * The kernels call it with the same arguments as the corresponding algorithms. Results that are not normal numbers are
+ * computed again by the packed engine.
+ *
+ * @param one reference to the first operand
+ * @param two reference to the second operand
+ * @param set_sign the sign to which the final result should be set (turned if a subtraction is negative)
+ * @param operation the operation ('+', '-', '*' or '/')
+ * @return the resulting mps object
+ */
+[[nodiscard]] mps mps::nativeCalculation(const mps& one, const mps& two, bool set_sign, char operation) {
+
+    mps ret;
+    ret.mantissa_length = one.mantissa_length;
+    ret.exponent_length = one.exponent_length;
+    ret.sign = set_sign;
+    ret.exponent.resize(ret.exponent_length);
+    ret.mantissa.resize(ret.mantissa_length);
+
+    bool normal;
+    if(52 == one.mantissa_length){
+        normal = nativeResult<double>(one.exponent, one.mantissa, two.exponent, two.mantissa, operation,
+                                      &ret.sign, ret.exponent, ret.mantissa);
+    } else {
+        normal = nativeResult<float>(one.exponent, one.mantissa, two.exponent, two.mantissa, operation,
+                                     &ret.sign, ret.exponent, ret.mantissa);
+    }
+    if(normal){
+        return ret;
+    }
+
+    switch(operation){
+        case '+': return packedAddition(one, two, set_sign);
+        case '-': return packedSubtraction(one, two, set_sign);
+        case '*': return packedMultiplication(one, two, set_sign);
+        default:  return packedDivision(one, two, set_sign);
+    }
+}
@@ -0,0 +1,1100 @@
+//
+// Packed engine of the mps class.
+//
+// The algorithms in this file operate on the 64-bit words of the packed storage instead of single bits.
+// They produce exactly the same bit patterns as the bit level algorithms in mps.cpp, including the handling of
+// wrapping exponents and the special cases for large exponent differences. The significands (hidden one and mantissa)
+// are handled as little endian arrays of 64-bit limbs. For formats up to binary128 no heap memory is used, longer limb
+// arrays (also the temporaries of the Karatsuba multiplication) reuse the blocks cached per thread (scratch_arena.h).
+// Significands with at most 113 bits are computed by the integer kernels in mps_integer.cpp. Wide quotients are
+// computed with a Newton-Raphson reciprocal and a final correction, so they are the same as with long division.
+// The fused multiply-add (mps::fma) gives the same results as its bit level counterpart in mps.cpp.
+//
+
+#include "mps.h"
+
+#ifndef MPS_KARATSUBA_THRESHOLD
+#define MPS_KARATSUBA_THRESHOLD 32
+#endif
+
+#ifndef MPS_NEWTON_THRESHOLD
+#define MPS_NEWTON_THRESHOLD 2
+#endif
+
+namespace {
+
+    typedef uint64_t limb;
+    typedef inline_vector<limb, 5> limbs;     // enough for the exact results of formats up to binary128
+
+    constexpr unsigned long limb_size = 64;
+
+    /**
+     * Returns the value of a bit field (first bit = most significant bit) as little endian limbs.
+     *
+     * @param field reference to the bit field
+     * @return the value of the field
+     */
+    limbs fieldToLimbs(const packed_bits& field){
+
+        auto n = field.wordCount();
+        auto s = n * limb_size - field.size();
+        auto words = field.data();
+
+        limbs ret(n);
+        for(unsigned long k = 0; k < n; k++){
+            ret[k] = words[n-1-k] >> s;
+            if(s && k + 1 < n){
+                ret[k] |= words[n-2-k] << (limb_size - s);
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * Writes the lowest field.size() bits of value into the field.
+     *
+     * @param value reference to the value
+     * @param field reference to the bit field (the size is kept)
+     */
+    void limbsToField(const limbs& value, packed_bits& field){
+
+        auto n = field.wordCount();
+        auto s = n * limb_size - field.size();
+        auto words = field.data();
+
+        auto get = [&value](unsigned long k) -> limb { return k < value.size() ? value[k] : 0; };
+
+        for(unsigned long j = 0; j < n; j++){
+            auto k = n-1-j;
+            words[j] = get(k) << s;
+            if(s && k > 0){
+                words[j] |= get(k-1) >> (limb_size - s);
+            }
+        }
+    }
+
+    /**
+     * Returns the number of bits needed to represent the value (0 for zero).
+     */
+    unsigned long bitLength(const limbs& value){
+
+        for(auto k = value.size(); k > 0;){
+            k--;
+            if(value[k]){
+                return k * limb_size + limb_size - __builtin_clzll(value[k]);
+            }
+        }
+
+        return 0;
+    }
+
+    bool testBit(const limbs& value, unsigned long idx){
+        auto k = idx / limb_size;
+        return k < value.size() && ((value[k] >> (idx % limb_size)) & 1);
+    }
+
+    void setBit(limbs& value, unsigned long idx){
+        auto k = idx / limb_size;
+        if(k >= value.size()){
+            value.resize(k + 1, 0);
+        }
+        value[k] |= ((limb) 1) << (idx % limb_size);
+    }
+
+    /**
+     * Returns true if any of the bits below idx is set.
+     */
+    bool anyBitBelow(const limbs& value, unsigned long idx){
+
+        auto full = std::min<unsigned long>(idx / limb_size, value.size());
+        for(unsigned long k = 0; k < full; k++){
+            if(value[k]){
+                return true;
+            }
+        }
+
+        auto rest = idx % limb_size;
+        if(rest && full < value.size() && full == idx / limb_size){
+            return (value[full] & ((((limb) 1) << rest) - 1)) != 0;
+        }
+
+        return false;
+    }
+
+    /**
+     * Keeps only the lowest n bits.
+     */
+    void truncate(limbs& value, unsigned long n){
+
+        auto k = (n + limb_size - 1) / limb_size;
+        if(value.size() > k){
+            value.resize(k);
+        }
+        if(n % limb_size && k == value.size() && k > 0){
+            value[k-1] &= (((limb) 1) << (n % limb_size)) - 1;
+        }
+    }
+
+    limbs limbShiftLeft(const limbs& value, unsigned long count){
+
+        auto word_shift = count / limb_size;
+        auto bit_shift = count % limb_size;
+
+        limbs ret(value.size() + word_shift + 1, 0);
+        for(unsigned long k = 0; k < value.size(); k++){
+            ret[k + word_shift] |= value[k] << bit_shift;
+            if(bit_shift){
+                ret[k + word_shift + 1] |= value[k] >> (limb_size - bit_shift);
+            }
+        }
+
+        return ret;
+    }
+
+    limbs limbShiftRight(const limbs& value, unsigned long count){
+
+        auto word_shift = count / limb_size;
+        auto bit_shift = count % limb_size;
+
+        if(word_shift >= value.size()){
+            return {0};
+        }
+
+        limbs ret(value.size() - word_shift, 0);
+        for(unsigned long k = 0; k < ret.size(); k++){
+            ret[k] = value[k + word_shift] >> bit_shift;
+            if(bit_shift && k + word_shift + 1 < value.size()){
+                ret[k] |= value[k + word_shift + 1] << (limb_size - bit_shift);
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * Shifts the value to the right. If any of the shifted out bits is set, the lowest bit is set (sticky bit).
+     */
+    limbs limbShiftRightJam(const limbs& value, unsigned long count){
+
+        auto ret = limbShiftRight(value, count);
+        if(anyBitBelow(value, count)){
+            setBit(ret, 0);
+        }
+
+        return ret;
+    }
+
+    /**
+     * Adds two values. The result has one limb more than the larger operand.
+     */
+    limbs limbAdd(const limbs& a, const limbs& b){
+
+        auto n = std::max(a.size(), b.size());
+        limbs ret(n + 1, 0);
+
+        limb carrier = 0;
+        for(unsigned long k = 0; k < n; k++){
+            limb x = k < a.size() ? a[k] : 0;
+            limb y = k < b.size() ? b[k] : 0;
+            limb s = x + y;
+            limb c1 = s < x;
+            ret[k] = s + carrier;
+            carrier = c1 | (ret[k] < s);
+        }
+        ret[n] = carrier;
+
+        return ret;
+    }
+
+    /**
+     * Subtracts b from a. Requires a >= b.
+     */
+    limbs limbSubtract(const limbs& a, const limbs& b){
+
+        limbs ret(a.size(), 0);
+
+        limb borrow = 0;
+        for(unsigned long k = 0; k < a.size(); k++){
+            limb y = k < b.size() ? b[k] : 0;
+            limb d = a[k] - y;
+            limb b1 = a[k] < y;
+            ret[k] = d - borrow;
+            borrow = b1 | (d < borrow);
+        }
+
+        return ret;
+    }
+
+    /**
+     * Compares two values.
+     *
+     * @return 1 if a > b, 0 if a == b, -1 if a < b
+     */
+    char limbCompare(const limbs& a, const limbs& b){
+
+        auto n = std::max(a.size(), b.size());
+        for(auto k = n; k > 0;){
+            k--;
+            limb x = k < a.size() ? a[k] : 0;
+            limb y = k < b.size() ? b[k] : 0;
+            if(x != y){
+                return x > y ? 1 : -1;
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * Multiplies a[0, na) and b[0, nb) (schoolbook multiplication). ret must have na + nb limbs.
+     */
+    void multiplySchoolbook(const limb* a, unsigned long na, const limb* b, unsigned long nb, limb* ret){
+
+        std::fill(ret, ret + na + nb, 0);
+
+        for(unsigned long i = 0; i < na; i++){
+            limb carrier = 0;
+            for(unsigned long j = 0; j < nb; j++){
+                unsigned __int128 t = (unsigned __int128) a[i] * b[j] + ret[i+j] + carrier;
+                ret[i+j] = (limb) t;
+                carrier = (limb) (t >> limb_size);
+            }
+            ret[i + nb] = carrier;
+        }
+    }
+
+    /**
+     * Adds x[0, nx) to r[0, nr) (nr >= nx).
+     *
+     * @return the carrier bit of the last limb
+     */
+    limb addInto(limb* r, unsigned long nr, const limb* x, unsigned long nx){
+
+        limb carrier = 0;
+        for(unsigned long k = 0; k < nr && (k < nx || carrier); k++){
+            limb y = k < nx ? x[k] : 0;
+            limb s = r[k] + y;
+            limb c1 = s < y;
+            r[k] = s + carrier;
+            carrier = c1 | (r[k] < s);
+        }
+
+        return carrier;
+    }
+
+    /**
+     * Subtracts x[0, nx) from r[0, nr) (nr >= nx, r >= x).
+     */
+    void subtractFrom(limb* r, unsigned long nr, const limb* x, unsigned long nx){
+
+        limb borrow = 0;
+        for(unsigned long k = 0; k < nr && (k < nx || borrow); k++){
+            limb y = k < nx ? x[k] : 0;
+            limb d = r[k] - y;
+            limb b1 = r[k] < y;
+            r[k] = d - borrow;
+            borrow = b1 | (d < borrow);
+        }
+    }
+
+    /**
+     * Multiplies a[0, n) and b[0, n) with the Karatsuba algorithm. ret must have 2n limbs.
+     *
+     * a = a1 * B^h + a0, b = b1 * B^h + b0
+     * a * b = z2 * B^2h + ((a0 + a1) * (b0 + b1) - z2 - z0) * B^h + z0 with z0 = a0 * b0, z2 = a1 * b1
+     *
+     * @param threshold below this number of limbs the schoolbook multiplication is used
+     */
+    void multiplyKaratsuba(const limb* a, const limb* b, unsigned long n, limb* ret, unsigned long threshold){
+
+        // (the recursion needs at least four limbs to get smaller)
+        if(n < threshold || n < 4){
+            multiplySchoolbook(a, n, b, n, ret);
+            return;
+        }
+
+        auto h = n / 2;         // limbs of the lower halves
+        auto l = n - h;         // limbs of the upper halves (l >= h)
+
+        // z0 and z2 directly into the result
+        multiplyKaratsuba(a, b, h, ret, threshold);
+        limbs z2(2 * l);
+        multiplyKaratsuba(a + h, b + h, l, z2.data(), threshold);
+        std::copy(z2.begin(), z2.end(), ret + 2 * h);
+
+        // sums of the halves (l + 1 limbs)
+        limbs sa(l + 1), sb(l + 1);
+        std::copy(a + h, a + n, sa.data());
+        std::copy(b + h, b + n, sb.data());
+        sa[l] = addInto(sa.data(), l, a, h);
+        sb[l] = addInto(sb.data(), l, b, h);
+
+        // middle part z1 = sa * sb - z0 - z2
+        limbs z1(2 * (l + 1));
+        multiplyKaratsuba(sa.data(), sb.data(), l + 1, z1.data(), threshold);
+        subtractFrom(z1.data(), z1.size(), ret, 2 * h);
+        subtractFrom(z1.data(), z1.size(), z2.data(), z2.size());
+
+        // z1 < 2^(64 * 2l + 1), therefore the limbs above 2l + 1 are zero
+        addInto(ret + h, 2 * n - h, z1.data(), std::min(z1.size(), 2 * n - h));
+    }
+
+    /**
+     * Multiplies two values. Above the threshold (limbs of the smaller operand) the Karatsuba algorithm is used.
+     */
+    limbs limbMultiply(const limbs& a, const limbs& b, unsigned long threshold){
+
+        limbs ret(a.size() + b.size(), 0);
+
+        if(std::min(a.size(), b.size()) < threshold){
+            multiplySchoolbook(a.data(), a.size(), b.data(), b.size(), ret.data());
+            return ret;
+        }
+
+        // Karatsuba works on operands of the same length.
+        auto n = std::max(a.size(), b.size());
+        limbs x(a), y(b);
+        x.resize(n, 0);
+        y.resize(n, 0);
+
+        limbs product(2 * n, 0);
+        multiplyKaratsuba(x.data(), y.data(), n, product.data(), threshold);
+        std::copy(product.begin(), product.begin() + ret.size(), ret.begin());
+
+        return ret;
+    }
+
+    /**
+     * Removes leading zero limbs (at least one limb is kept).
+     */
+    void trim(limbs& value){
+
+        auto n = value.size();
+        while(n > 1 && !value[n-1]){
+            n--;
+        }
+        value.resize(n);
+    }
+
+    /**
+     * Returns an approximation of 2^(2k) / D with an error of a few units, where k is the bit length of D.
+     * The Newton-Raphson iteration V' = V + V (2^(2p) - D V) / 2^(2p) is started with 32 bits and (almost) doubles
+     * the precision p in every step. Only the leading p bits of D are used in a step.
+     */
+    limbs reciprocal(const limbs& D, unsigned long threshold){
+
+        auto k = bitLength(D);
+        unsigned long p = std::min<unsigned long>(k, 32);
+
+        auto d = limbShiftRight(D, k - p)[0];
+        limbs V = {p < 32 ? (((limb) 1) << (2 * p)) / d : ~((limb) 0) / d};
+
+        while(p < k){
+
+            // two bits less than double to absorb the truncation of D and of the correction
+            auto q = std::min(2 * p - 2, k);
+            auto W = limbShiftLeft(V, q - p);
+            auto P = limbMultiply(limbShiftRight(D, k - q), W, threshold);
+
+            limbs scale;
+            setBit(scale, 2 * q);
+
+            // the error 2^(2q) - D W has only about 2q - p bits
+            limbs error;
+            bool below = limbCompare(P, scale) <= 0;
+            error = below ? limbSubtract(scale, P) : limbSubtract(P, scale);
+            trim(error);
+            trim(W);
+
+            auto correction = limbShiftRight(limbMultiply(W, error, threshold), 2 * q);
+            V = below ? limbAdd(W, correction) : limbSubtract(W, correction);
+            trim(V);
+            p = q;
+        }
+
+        return V;
+    }
+
+    /**
+     * Returns floor(R 2^shift / D) by restoring division, one quotient bit at a time. Requires R < 2 D.
+     */
+    limbs restoringQuotient(limbs R, const limbs& D, unsigned long shift){
+
+        limbs Q((shift + limb_size) / limb_size, 0);
+        auto width = bitLength(D) + 2;
+
+        for(auto i = shift + 1; i > 0;){
+            i--;
+
+            if(limbCompare(R, D) >= 0){
+                R = limbSubtract(R, D);
+                setBit(Q, i);
+            }
+            R = limbShiftLeft(R, 1);
+            truncate(R, width);
+        }
+
+        return Q;
+    }
+
+    /**
+     * Returns floor(R 2^shift / D) with a reciprocal of D (Newton-Raphson). The approximated quotient is corrected
+     * with the remainder, so the result is exact. Requires 2 bitLength(D) >= shift.
+     */
+    limbs newtonQuotient(const limbs& R, const limbs& D, unsigned long shift, unsigned long threshold){
+
+        auto k = bitLength(D);
+        auto Q = limbShiftRight(limbMultiply(R, reciprocal(D, threshold), threshold), 2 * k - shift);
+        trim(Q);
+
+        // correction: the remainder R 2^shift - Q D must lie in [0, D)
+        auto N = limbShiftLeft(R, shift);
+        auto P = limbMultiply(Q, D, threshold);
+
+        while(limbCompare(P, N) > 0){
+            Q = limbSubtract(Q, {1});
+            P = limbSubtract(P, D);
+        }
+
+        auto remainder = limbSubtract(N, P);
+        while(limbCompare(remainder, D) >= 0){
+            Q = limbAdd(Q, {1});
+            remainder = limbSubtract(remainder, D);
+        }
+
+        return Q;
+    }
+
+    /**
+     * Returns the significand (hidden one followed by the mantissa) as integer.
+     */
+    limbs significand(const packed_bits& mantissa){
+
+        auto ret = fieldToLimbs(mantissa);
+        setBit(ret, mantissa.size());
+        return ret;
+    }
+
+    /**
+     * Rounds a fraction with length bits to mantissa_len bits (round to nearest, ties to even).
+     * This is the word level version of mps::round.
+     *
+     * @param fraction reference to the bits of the fraction (without leading one)
+     * @param length the number of bits of the fraction
+     * @param mantissa_len the length to which the fraction should be rounded
+     * @param overflow set to true if rounding up overflowed (the result is zero in this case)
+     * @return the rounded fraction
+     */
+    limbs roundFraction(const limbs& fraction, unsigned long length, unsigned long mantissa_len, bool* overflow){
+
+        *overflow = false;
+
+        if(length <= mantissa_len){
+            return limbShiftLeft(fraction, mantissa_len - length);
+        }
+
+        auto cut = length - mantissa_len;
+        auto ret = limbShiftRight(fraction, cut);
+
+        if(testBit(fraction, cut-1) && (anyBitBelow(fraction, cut-1) || testBit(ret, 0))){
+            ret = limbAdd(ret, {1});
+            if(testBit(ret, mantissa_len)){
+                *overflow = true;
+            }
+            truncate(ret, mantissa_len);
+        }
+
+        return ret;
+    }
+}
+
+// multiplication threshold
+//-------------------------------
+std::atomic<unsigned long> mps::karatsuba_threshold(MPS_KARATSUBA_THRESHOLD);
+
+/**
+ * Sets the number of 64-bit limbs of the significands from which on the packed engine multiplies with the Karatsuba
+ * algorithm instead of the schoolbook multiplication. The results are the same. The default is set by the build
+ * (MPS_KARATSUBA_THRESHOLD).
+ *
+ * @param threshold the new threshold in limbs
+ */
+void mps::setKaratsubaThreshold(unsigned long threshold){
+    karatsuba_threshold.store(threshold, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of limbs from which on the Karatsuba algorithm is used.
+ *
+ * @return the threshold
+ */
+unsigned long mps::getKaratsubaThreshold(){
+    return karatsuba_threshold.load(std::memory_order_relaxed);
+}
+//-------------------------------
+
+
+// division threshold
+//-------------------------------
+std::atomic<unsigned long> mps::newton_threshold(MPS_NEWTON_THRESHOLD);
+
+/**
+ * Sets the number of 64-bit limbs of the significands from which on the packed engine divides with a Newton-Raphson
+ * reciprocal instead of the restoring division. The results are the same. The default is set by the build
+ * (MPS_NEWTON_THRESHOLD).
+ *
+ * @param threshold the new threshold in limbs
+ */
+void mps::setNewtonThreshold(unsigned long threshold){
+    newton_threshold.store(threshold, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of limbs from which on the division uses a Newton-Raphson reciprocal.
+ *
+ * @return the threshold
+ */
+unsigned long mps::getNewtonThreshold(){
+    return newton_threshold.load(std::memory_order_relaxed);
+}
+//-------------------------------
+
+
+/**
+ * Returns true if the format of the mps object can be handled by the packed engine.
+ * The exponent is processed as a single 64-bit integer, the mantissa can have any length.
+ *
+ * @param one reference to the mps object
+ * @return true if supported
+ */
+bool mps::packedSupported(const mps& one){
+    return one.exponent_length <= 62;
+}
+
+/**
+ * Kernels of the packed engine that return the result in a new mps object (see the kernels below, which store it in a
+ * given object).
+ */
+[[nodiscard]] mps mps::packedAddition(const mps& one, const mps& two, bool set_sign) {
+    mps ret;
+    packedAddition(one, two, set_sign, &ret);
+    return ret;
+}
+
+[[nodiscard]] mps mps::packedSubtraction(const mps& minued, const mps& subtrahend, bool set_sign) {
+    mps ret;
+    packedSubtraction(minued, subtrahend, set_sign, &ret);
+    return ret;
+}
+
+[[nodiscard]] mps mps::packedMultiplication(const mps& one, const mps& two, bool set_sign) {
+    mps ret;
+    packedMultiplication(one, two, set_sign, &ret);
+    return ret;
+}
+
+[[nodiscard]] mps mps::packedDivision(const mps& dividend, const mps& divisor, bool set_sign) {
+    mps ret;
+    packedDivision(dividend, divisor, set_sign, &ret);
+    return ret;
+}
+
+/**
+ * Performs an addition on two mps objects that have the same sign (packed engine).
+ *
+ * @param one reference to the first addend
+ * @param two reference to the second addend
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::packedAddition(const mps &one, const mps &two, const bool set_sign, mps* ret) {
+
+    if(integerSupported(one)){
+        integerAddition(one, two, set_sign, ret);
+        return;
+    }
+
+    // Set up the return object.
+    //-------------------------------
+    ret->exponent_length = one.exponent_length;
+    ret->mantissa_length = one.mantissa_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = one.mantissa_length;
+    const uint64_t mask = (((uint64_t) 1) << one.exponent_length) - 1;
+    //-------------------------------
+
+
+    // order the operands by exponent
+    //-------------------------------
+    auto e_one = one.exponent.toInt();
+    auto e_two = two.exponent.toInt();
+
+    const mps& large = e_one >= e_two ? one : two;
+    const mps& small = e_one >= e_two ? two : one;
+    auto e = e_one >= e_two ? e_one : e_two;
+    auto exponent_diff = e_one >= e_two ? e_one - e_two : e_two - e_one;
+
+    if(exponent_diff > M){
+
+        // special case where the rounding distance is the same, and the rounded number, therefore, must be even.
+        // (checked before the result is written, ret may be the smaller operand)
+        bool even = exponent_diff == M + 1 && large.mantissa.back() && small.mantissa.noneSet();
+
+        ret->mantissa = large.mantissa;
+        if(even){
+            if(addOneToBinary(&ret->mantissa)){
+                e = (e + 1) & mask;
+            }
+        }
+
+        ret->exponent.fromInt(e);
+        return;
+    }
+    //-------------------------------
+
+
+    // exact sum and rounding
+    //-------------------------------
+    auto sum = limbAdd(limbShiftLeft(significand(large.mantissa), exponent_diff), significand(small.mantissa));
+
+    auto length = M + exponent_diff;
+    bool carrier = testBit(sum, length + 1);
+    if(carrier){
+        length++;
+    }
+    truncate(sum, length);      // remove the leading one
+
+    bool overflow;
+    limbsToField(roundFraction(sum, length, M, &overflow), ret->mantissa);
+
+    if(overflow){
+        e = (e + 1) & mask;
+    }
+    //-------------------------------
+
+    if(carrier){
+        e = (e + 1) & mask;
+        if(e == mask){
+            ret->setInf(set_sign);
+            return;
+        }
+    }
+
+    ret->exponent.fromInt(e);
+}
+
+/**
+ * Performs a subtraction on two mps objects that have the same sign (packed engine).
+ *
+ * @param minued reference to the minued number
+ * @param subtrahend reference to the subtracted number
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::packedSubtraction(const mps &minued, const mps &subtrahend, bool set_sign, mps* ret) {
+
+    if(integerSupported(minued)){
+        integerSubtraction(minued, subtrahend, set_sign, ret);
+        return;
+    }
+
+    // Set up the return object.
+    //-------------------------------
+    ret->exponent_length = minued.exponent_length;
+    ret->mantissa_length = minued.mantissa_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = minued.mantissa_length;
+    const uint64_t mask = (((uint64_t) 1) << minued.exponent_length) - 1;
+    //-------------------------------
+
+
+    // order the operands by magnitude
+    //-------------------------------
+    auto e_minued = minued.exponent.toInt();
+    auto e_subtrahend = subtrahend.exponent.toInt();
+
+    char larger_tmp = e_minued > e_subtrahend ? 1 : (e_minued < e_subtrahend ? -1 : 0);
+    if(0 == larger_tmp){
+        larger_tmp = limbCompare(fieldToLimbs(minued.mantissa), fieldToLimbs(subtrahend.mantissa));
+        if(0 == larger_tmp){
+            ret->setZero();
+            return;
+        }
+    }
+
+    const mps& large = 1 == larger_tmp ? minued : subtrahend;
+    const mps& small = 1 == larger_tmp ? subtrahend : minued;
+    auto e = large.exponent.toInt();
+    auto exponent_diff = e - small.exponent.toInt();
+    if(-1 == larger_tmp){
+        ret->sign = !ret->sign; // flip sign
+    }
+
+    if(exponent_diff > M){
+
+        ret->mantissa = large.mantissa;
+
+        if(exponent_diff == M + 1){
+            if(ret->mantissa.noneSet()){
+                e = (e - 1) & mask;
+            }
+            subtractOneFromBinary(&ret->mantissa);
+        }
+
+        ret->exponent.fromInt(e);
+        return;
+    }
+    //-------------------------------
+
+
+    // exact difference, normalisation and rounding
+    //-------------------------------
+    auto diff = limbSubtract(limbShiftLeft(significand(large.mantissa), exponent_diff), significand(small.mantissa));
+
+    auto length = M + exponent_diff;
+    auto exponent_shift = length + 1 - bitLength(diff);
+
+    diff = limbShiftLeft(diff, exponent_shift);
+    truncate(diff, length);     // remove the leading one
+    e = (e - exponent_shift) & mask;
+
+    bool overflow;
+    limbsToField(roundFraction(diff, length, M, &overflow), ret->mantissa);
+
+    if(overflow){
+        e = (e + 1) & mask;
+    }
+    //-------------------------------
+
+    ret->exponent.fromInt(e);
+}
+
+/**
+ * Performs a multiplication on two mps objects that have the same sign (packed engine).
+ *
+ * @param one reference to the first multiplicand
+ * @param two reference to the second multiplicand
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::packedMultiplication(const mps& one, const mps& two, bool set_sign, mps* ret) {
+
+    if(integerSupported(one)){
+        integerMultiplication(one, two, set_sign, ret);
+        return;
+    }
+
+    // Set up the return object.
+    //-------------------------------
+    ret->exponent_length = one.exponent_length;
+    ret->mantissa_length = one.mantissa_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = one.mantissa_length;
+    const auto E = one.exponent_length;
+    const uint64_t mask = (((uint64_t) 1) << E) - 1;
+    const uint64_t top = ((uint64_t) 1) << (E - 1);
+    const uint64_t bias = top - 1;
+    //-------------------------------
+
+
+    // Calculate the exponent
+    //-------------------------------
+    auto e_one = one.exponent.toInt();
+    auto e_two = two.exponent.toInt();
+    uint64_t e;
+
+    if((e_one & top) && (e_two & top)){ // Both exponents are positive.
+
+        uint64_t addend = ((e_two ^ top) + 1) & mask;
+        e = e_one + addend;
+
+        // Check if the number will be more than the maximal allowed value.
+        if(e > mask && !(addend & top)){
+            ret->setInf(ret->sign);
+            return;
+        }
+        e &= mask;
+
+    } else if(e_one & top){
+        e = (e_two - ((bias - e_one) & mask)) & mask;
+    } else {
+        uint64_t subtrahend = (bias - e_two) & mask;
+
+        if(!(e_two & top) && subtrahend > e_one){
+            ret->setZero();
+            return;
+        }
+
+        e = (e_one - subtrahend) & mask;
+    }
+    //-------------------------------
+
+
+    // Calculate the mantissa
+    //-------------------------------
+    auto product = limbMultiply(significand(one.mantissa), significand(two.mantissa), getKaratsubaThreshold());
+
+    auto length = 2 * M;
+    bool large = testBit(product, length + 1);
+    if(large){
+        length++;
+    }
+    truncate(product, length);      // remove the leading one
+
+    bool overflow;
+    limbsToField(roundFraction(product, length, M, &overflow), ret->mantissa);
+    //-------------------------------
+
+    if(overflow){
+        e = (e + 1) & mask;
+    }
+    if(large){
+        e = (e + 1) & mask;
+    }
+
+    ret->exponent.fromInt(e);
+}
+
+/**
+ * Performs a division on two mps objects that have the same sign (packed engine).
+ *
+ * @param dividend reference to the dividend of the division
+ * @param divisor reference to the divisor of the division
+ * @param set_sign the sign to which the final result should be set
+ * @param ret the mps object in which the result is stored (its storage is reused, it may be one of the operands)
+ */
+void mps::packedDivision(const mps& dividend, const mps& divisor, bool set_sign, mps* ret) {
+
+    if(integerSupported(dividend)){
+        integerDivision(dividend, divisor, set_sign, ret);
+        return;
+    }
+
+    // Set up the return object.
+    //-------------------------------
+    ret->mantissa_length = dividend.mantissa_length;
+    ret->exponent_length = dividend.exponent_length;
+    ret->sign = set_sign;
+    ret->exponent.resize(ret->exponent_length);
+    ret->mantissa.resize(ret->mantissa_length);
+
+    const auto M = dividend.mantissa_length;
+    const auto E = dividend.exponent_length;
+    const uint64_t mask = (((uint64_t) 1) << E) - 1;
+    const uint64_t top = ((uint64_t) 1) << (E - 1);
+    const uint64_t bias = top - 1;
+    //-------------------------------
+
+
+    // Calculate the exponent
+    //-------------------------------
+    auto e_dividend = dividend.exponent.toInt();
+    auto e_divisor = divisor.exponent.toInt();
+    uint64_t e;
+
+    if(e_divisor & top){
+
+        e = (e_dividend - (((e_divisor ^ top) + 1) & mask)) & mask;
+
+        if(e > e_dividend){
+            ret->setZero();
+            return;
+        }
+
+    } else {
+
+        e = e_dividend + ((bias - e_divisor) & mask);
+
+        if(e >= mask){
+            ret->setInf(ret->sign);
+            return;
+        }
+    }
+    //-------------------------------
+
+
+    // Division
+    //-------------------------------
+
+    // the quotient bits with the weights 2^0 to 2^-(M+2)
+    auto R = significand(dividend.mantissa);
+    auto D = significand(divisor.mantissa);
+    auto Q = D.size() >= getNewtonThreshold() ? newtonQuotient(R, D, M + 2, getKaratsubaThreshold())
+                                              : restoringQuotient(R, D, M + 2);
+
+    // normalisation: The bit level algorithm removes one leading bit if the quotient starts with a one and two
+    // otherwise. For mantissas shorter than three bits it only removes one bit in either case.
+    bool leading = testBit(Q, M + 2);
+    unsigned long count = (leading || M < 3) ? 1 : 2;
+    if(!leading){
+        e = (e - 1) & mask;
+    }
+
+    auto mantissa = limbShiftRight(Q, 3 - count);
+    truncate(mantissa, M);
+    //-------------------------------
+
+
+    // rounding
+    //-------------------------------
+    if(testBit(Q, 2 - count)){
+        mantissa = limbAdd(mantissa, {1});
+        truncate(mantissa, M);
+    }
+    //-------------------------------
+
+    limbsToField(mantissa, ret->mantissa);
+    ret->exponent.fromInt(e);
+}
+
+/**
+ * Compares two mps objects word by word (packed engine).
+ *
+ * Info: Does not check for correct input or special values.
+ *
+ * @param one first mps object
+ * @param two second mps object
+ * @return 1: first is larger; 0: both are the same; -1: second is larger
+ */
+[[nodiscard]] char mps::packedCompare(const mps& one, const mps& two){
+
+    auto compareWords = [](const packed_bits& a, const packed_bits& b) -> char {
+        for(unsigned long i = 0; i < a.wordCount(); i++){
+            if(a.data()[i] != b.data()[i]){
+                return a.data()[i] > b.data()[i] ? 1 : -1;
+            }
+        }
+        return 0;
+    };
+
+    auto ret = compareWords(one.exponent, two.exponent);
+    if(0 != ret){
+        return ret;
+    }
+
+    return compareWords(one.mantissa, two.mantissa);
+}
+
+/**
+ * Computes a * b + c (or c - a * b) with a single rounding (round to nearest, ties to even) (packed engine).
+ * The product is kept exactly. Of the sum only a window of 3M + 11 bits below the leading bit is kept, the bits below
+ * are collected in a sticky bit, which does not change the rounding. Results with a biased exponent of 11...1 or
+ * larger are infinite, results below the smallest normal number are flushed to (positive) zero.
+ *
+ * Info: Does not check for correct input or special values. a and b must be finite and not zero, c must be finite.
+ *
+ * @param a reference to the first factor
+ * @param b reference to the second factor
+ * @param c reference to the summand
+ * @param negate_product true to subtract the product from c
+ * @return the resulting mps object
+ */
+[[nodiscard]] mps mps::packedFusedMultiplyAdd(const mps& a, const mps& b, const mps& c, bool negate_product) {
+
+    // Set up the return object.
+    //-------------------------------
+    mps ret;
+    ret.mantissa_length = a.mantissa_length;
+    ret.exponent_length = a.exponent_length;
+    ret.exponent.resize(ret.exponent_length);
+    ret.mantissa.resize(ret.mantissa_length);
+
+    const auto M = a.mantissa_length;
+    const long mask = (1L << a.exponent_length) - 1;
+    const long bias = (1L << (a.exponent_length - 1)) - 1;
+
+    auto unbiased = [bias](const mps& x) -> long { return (long) x.exponent.toInt() - bias; };
+    //-------------------------------
+
+
+    // exact product: P * 2^scale
+    //-------------------------------
+    auto Z = limbMultiply(significand(a.mantissa), significand(b.mantissa), getKaratsubaThreshold());
+    trim(Z);
+    long scale = unbiased(a) + unbiased(b) - 2 * (long) M;
+    ret.sign = (a.sign != b.sign) != negate_product;
+    //-------------------------------
+
+
+    // addition of c
+    //-------------------------------
+    if(!c.isZero()){
+
+        auto C = significand(c.mantissa);
+        long c_scale = unbiased(c) - (long) M;
+
+        long top = std::max(scale + (long) bitLength(Z) - 1, c_scale + (long) M);
+        long low = top - (long) (3 * M + 11);
+
+        auto align = [low](const limbs& x, long x_scale) -> limbs {
+            return x_scale >= low ? limbShiftLeft(x, x_scale - low) : limbShiftRightJam(x, low - x_scale);
+        };
+        auto X = align(Z, scale);
+        auto Y = align(C, c_scale);
+        scale = low;
+
+        if(ret.sign == c.sign){
+            Z = limbAdd(X, Y);
+        } else {
+            auto larger_tmp = limbCompare(X, Y);
+            if(0 == larger_tmp){
+                ret.setZero();
+                return ret;
+            }
+            Z = larger_tmp > 0 ? limbSubtract(X, Y) : limbSubtract(Y, X);
+            ret.sign = larger_tmp > 0 ? ret.sign : c.sign;
+        }
+    }
+    //-------------------------------
+
+
+    // rounding to M + 1 significant bits
+    //-------------------------------
+    auto n = bitLength(Z);
+    long e = scale + (long) n - 1;
+    limbs mantissa;
+
+    if(n > M + 1){
+        auto cut = n - (M + 1);
+        mantissa = limbShiftRight(Z, cut);
+
+        if(testBit(Z, cut - 1) && (anyBitBelow(Z, cut - 1) || testBit(mantissa, 0))){
+            mantissa = limbAdd(mantissa, {1});
+            if(testBit(mantissa, M + 1)){
+                mantissa = limbShiftRight(mantissa, 1);
+                e++;
+            }
+        }
+    } else {
+        mantissa = limbShiftLeft(Z, M + 1 - n);
+    }
+    truncate(mantissa, M);
+    //-------------------------------
+
+
+    // exponent range
+    //-------------------------------
+    if(e + bias >= mask){
+        ret.setInf(ret.sign);
+        return ret;
+    }
+    if(e + bias <= 0){
+        ret.setZero();
+        return ret;
+    }
+    //-------------------------------
+
+    limbsToField(mantissa, ret.mantissa);
+    ret.exponent.fromInt(e + bias);
+    return ret;
+}
@@ -0,0 +1,1021 @@
+//
+// Bit-sliced arithmetic on arrays of mps values (see mps_sliced.h).
+//
+// A plane of a block is a group of MPS_SLICE_WORDS 64-bit words (the lanes). The gates below are bitwise operations on
+// whole planes; the compiler vectorizes them (SSE2, or AVX2/AVX-512 with MPS_SLICED_NATIVE_ARCH). Numbers are bit-sliced
+// unsigned integers: a vector of planes, lowest bit first.
+//
+// The kernels mirror the integer kernels of the packed engine (mps_integer.cpp) step by step, not the bit level
+// algorithms of the reference engine (no Booth multiplication, the alignment is a barrel shifter instead of
+// binaryOffsetAddition). Every branch of these kernels becomes a mask, both sides are computed for all lanes and the
+// mask selects the result.
+//
+
+#include "mps_sliced.h"
+#include "mps_counters.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+#ifndef MPS_SLICE_WORDS
+#define MPS_SLICE_WORDS 4
+#endif
+
+namespace {
+
+    constexpr unsigned long slice_words = MPS_SLICE_WORDS;
+    constexpr unsigned long word_size = 64;
+    constexpr unsigned long extra_bits = 3;       // guard bit and two sticky bits below the mantissa
+
+    static_assert(slice_words >= 1, "MPS_SLICE_WORDS must be at least 1");
+
+
+    // lanes and gates
+    //-------------------------------
+    struct lanes {
+        uint64_t w[slice_words];
+    };
+
+    lanes all(bool value){
+        lanes ret{};
+        for(auto& word : ret.w){
+            word = value ? ~((uint64_t) 0) : 0;
+        }
+        return ret;
+    }
+
+    lanes operator&(const lanes& a, const lanes& b){
+        lanes ret;
+        for(unsigned long i = 0; i < slice_words; i++){ ret.w[i] = a.w[i] & b.w[i]; }
+        return ret;
+    }
+
+    lanes operator|(const lanes& a, const lanes& b){
+        lanes ret;
+        for(unsigned long i = 0; i < slice_words; i++){ ret.w[i] = a.w[i] | b.w[i]; }
+        return ret;
+    }
+
+    lanes operator^(const lanes& a, const lanes& b){
+        lanes ret;
+        for(unsigned long i = 0; i < slice_words; i++){ ret.w[i] = a.w[i] ^ b.w[i]; }
+        return ret;
+    }
+
+    lanes operator~(const lanes& a){
+        lanes ret;
+        for(unsigned long i = 0; i < slice_words; i++){ ret.w[i] = ~a.w[i]; }
+        return ret;
+    }
+
+    /**
+     * Returns the number of set lanes.
+     */
+    unsigned long long population(const lanes& a){
+        unsigned long long ret = 0;
+        for(auto word : a.w){
+            ret += (unsigned long long) __builtin_popcountll(word);
+        }
+        return ret;
+    }
+
+    /**
+     * Returns a mask of the first n lanes.
+     */
+    lanes firstLanes(unsigned long n){
+        lanes ret{};
+        for(unsigned long i = 0; i < slice_words; i++){
+            if(n >= (i + 1) * word_size){
+                ret.w[i] = ~((uint64_t) 0);
+            } else if(n > i * word_size){
+                ret.w[i] = (((uint64_t) 1) << (n - i * word_size)) - 1;
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * Multiplexer: a where the mask is set, b elsewhere.
+     */
+    lanes select(const lanes& mask, const lanes& a, const lanes& b){
+        return (mask & a) | (~mask & b);
+    }
+    //-------------------------------
+
+
+    // bit-sliced integers
+    //-------------------------------
+    typedef std::vector<lanes> sliced;
+
+    /**
+     * Returns the smallest number of shift stages k with 2^k > value.
+     */
+    unsigned long stages(unsigned long value){
+        unsigned long ret = 0;
+        while(ret < word_size && (value >> ret) != 0){
+            ret++;
+        }
+        return ret;
+    }
+
+    sliced constant(unsigned long width, unsigned long value){
+        sliced ret(width, all(false));
+        for(unsigned long i = 0; i < width && i < word_size; i++){
+            ret[i] = all((value >> i) & 1);
+        }
+        return ret;
+    }
+
+    // the bias 2^(E-1) - 1
+    sliced bias(unsigned long width){
+        sliced ret(width, all(true));
+        ret[width - 1] = all(false);
+        return ret;
+    }
+
+    lanes anySet(const sliced& x, unsigned long first, unsigned long last){
+        auto ret = all(false);
+        for(auto i = first; i < last; i++){
+            ret = ret | x[i];
+        }
+        return ret;
+    }
+
+    lanes noneSet(const sliced& x){
+        return ~anySet(x, 0, x.size());
+    }
+
+    lanes allSet(const sliced& x){
+        auto ret = all(true);
+        for(const auto& plane : x){
+            ret = ret & plane;
+        }
+        return ret;
+    }
+
+    sliced select(const lanes& mask, const sliced& a, const sliced& b){
+        sliced ret(a.size());
+        for(unsigned long i = 0; i < a.size(); i++){
+            ret[i] = select(mask, a[i], b[i]);
+        }
+        return ret;
+    }
+
+    /**
+     * x = y where the mask is set.
+     */
+    void assign(sliced& x, const lanes& mask, const sliced& y){
+        for(unsigned long i = 0; i < x.size(); i++){
+            x[i] = select(mask, y[i], x[i]);
+        }
+    }
+
+    /**
+     * x += y + carry (ripple carry adder over the planes of x, y is extended with zeros).
+     *
+     * @return the carry out of the highest plane
+     */
+    lanes add(sliced& x, const sliced& y, lanes carry){
+        for(unsigned long i = 0; i < x.size(); i++){
+            auto a = x[i];
+            auto b = i < y.size() ? y[i] : all(false);
+            auto half = a ^ b;
+            x[i] = half ^ carry;
+            carry = (a & b) | (half & carry);
+        }
+        return carry;
+    }
+
+    /**
+     * x -= y (two's complement: x + ~y + 1).
+     *
+     * @return the lanes without borrow (x >= y)
+     */
+    lanes subtract(sliced& x, const sliced& y){
+        auto carry = all(true);
+        for(unsigned long i = 0; i < x.size(); i++){
+            auto b = i < y.size() ? ~y[i] : all(true);
+            auto half = x[i] ^ b;
+            auto sum = half ^ carry;
+            carry = (x[i] & b) | (half & carry);
+            x[i] = sum;
+        }
+        return carry;
+    }
+
+    /**
+     * x += 1 in the lanes of the mask (half adders).
+     *
+     * @return the carry out of the highest plane
+     */
+    lanes increment(sliced& x, lanes carry){
+        for(auto& plane : x){
+            auto sum = plane ^ carry;
+            carry = plane & carry;
+            plane = sum;
+        }
+        return carry;
+    }
+
+    /**
+     * x -= 1 in the lanes of the mask.
+     *
+     * @return the lanes with borrow (x was zero)
+     */
+    lanes decrement(sliced& x, lanes borrow){
+        for(auto& plane : x){
+            auto diff = plane ^ borrow;
+            borrow = ~plane & borrow;
+            plane = diff;
+        }
+        return borrow;
+    }
+
+    lanes equal(const sliced& a, const sliced& b){
+        auto ret = all(true);
+        for(unsigned long i = 0; i < a.size(); i++){
+            ret = ret & ~(a[i] ^ b[i]);
+        }
+        return ret;
+    }
+
+    // a > b
+    lanes greater(const sliced& a, const sliced& b){
+        auto tmp = b;
+        return ~subtract(tmp, a);
+    }
+
+    lanes greaterConstant(const sliced& x, unsigned long value){
+        if(stages(value) > x.size()){
+            return all(false);
+        }
+        return greater(x, constant(x.size(), value));
+    }
+
+    lanes equalConstant(const sliced& x, unsigned long value){
+        if(stages(value) > x.size()){
+            return all(false);
+        }
+        return equal(x, constant(x.size(), value));
+    }
+
+    /**
+     * Shifts to the right by a constant (result with width planes). If any of the shifted out bits is set, the lowest
+     * bit of the result is set.
+     */
+    sliced shiftRightJam(const sliced& x, unsigned long count, unsigned long width){
+        sliced ret(width, all(false));
+        for(unsigned long i = 0; i < width && i + count < x.size(); i++){
+            ret[i] = x[i + count];
+        }
+        if(0 != width){
+            ret[0] = ret[0] | anySet(x, 0, std::min<unsigned long>(count, x.size()));
+        }
+        return ret;
+    }
+
+    /**
+     * Shifts to the left by a constant (result with width planes).
+     */
+    sliced shiftLeft(const sliced& x, unsigned long count, unsigned long width){
+        sliced ret(width, all(false));
+        for(unsigned long i = count; i < width && i - count < x.size(); i++){
+            ret[i] = x[i - count];
+        }
+        return ret;
+    }
+
+    /**
+     * Barrel shifter: shifts every lane to the right by its amount (< 2^number_of_stages) and keeps a sticky bit.
+     */
+    sliced shiftRightJam(sliced x, const sliced& amount, unsigned long number_of_stages){
+        for(unsigned long k = 0; k < number_of_stages && k < amount.size(); k++){
+            assign(x, amount[k], shiftRightJam(x, ((unsigned long) 1) << k, x.size()));
+        }
+        return x;
+    }
+
+    /**
+     * Moves the leading one of every (nonzero) lane to the highest plane.
+     *
+     * @param count set to the shift of every lane (number_of_stages planes)
+     */
+    void normaliseLeft(sliced& x, unsigned long number_of_stages, sliced* count){
+        count->assign(number_of_stages, all(false));
+        for(auto k = number_of_stages; k > 0;){
+            k--;
+            auto s = ((unsigned long) 1) << k;
+            if(s >= x.size()){
+                continue;
+            }
+            auto zero = ~anySet(x, x.size() - s, x.size());
+            assign(x, zero, shiftLeft(x, s, x.size()));
+            (*count)[k] = zero;
+        }
+    }
+
+    /**
+     * Hidden one and mantissa, shifted to the left by the extra bits (width planes).
+     */
+    sliced significand(const sliced& mantissa, unsigned long width){
+        sliced ret(width, all(false));
+        std::copy(mantissa.begin(), mantissa.end(), ret.begin() + extra_bits);
+        ret[mantissa.size() + extra_bits] = all(true);
+        return ret;
+    }
+
+    /**
+     * Rounds a normalised significand (leading one in the plane M + extra_bits) to nearest, ties to even.
+     *
+     * @param mantissa set to the rounded mantissa (without the leading one)
+     * @return the lanes in which rounding up overflowed (the mantissa is zero)
+     */
+    lanes roundSignificand(const sliced& value, unsigned long M, sliced* mantissa){
+        mantissa->assign(value.begin() + extra_bits, value.begin() + extra_bits + M);
+        auto guard = value[extra_bits - 1];
+        auto sticky = anySet(value, 0, extra_bits - 1);
+        return increment(*mantissa, guard & (sticky | (*mantissa)[0]));
+    }
+    //-------------------------------
+
+
+    // floating point values
+    //-------------------------------
+    struct fields {
+        lanes sign;
+        sliced exponent;
+        sliced mantissa;
+    };
+
+    struct classes {
+        lanes zero, inf, nan;
+    };
+
+    classes classify(const fields& x){
+        auto M = x.mantissa.size();
+        auto exponent_set = allSet(x.exponent);
+        auto mantissa_zero = noneSet(x.mantissa);
+        auto mantissa_nan = x.mantissa[M - 1] & ~anySet(x.mantissa, 0, M - 1);
+        return {noneSet(x.exponent) & mantissa_zero, exponent_set & mantissa_zero, exponent_set & mantissa_nan};
+    }
+
+    fields special(unsigned long M, unsigned long E, const lanes& sign, bool exponent_set, bool nan){
+        fields ret{sign, sliced(E, all(exponent_set)), sliced(M, all(false))};
+        if(nan){
+            ret.mantissa[M - 1] = all(true);
+        }
+        return ret;
+    }
+
+    /**
+     * x = y where the mask is set.
+     */
+    void assign(fields& x, const lanes& mask, const fields& y){
+        x.sign = select(mask, y.sign, x.sign);
+        assign(x.exponent, mask, y.exponent);
+        assign(x.mantissa, mask, y.mantissa);
+    }
+    //-------------------------------
+
+
+    // kernels (see the integer kernels of the packed engine)
+    //-------------------------------
+    /**
+     * Adds the magnitudes of two values.
+     */
+    fields addition(const fields& one, const fields& two, const lanes& set_sign){
+
+        const auto M = one.mantissa.size();
+        const auto E = one.exponent.size();
+
+        // order the operands by exponent
+        auto diff_one = one.exponent;
+        auto one_larger = subtract(diff_one, two.exponent);
+        auto diff_two = two.exponent;
+        subtract(diff_two, one.exponent);
+
+        auto e = select(one_larger, one.exponent, two.exponent);
+        auto exponent_diff = select(one_larger, diff_one, diff_two);
+        auto m_large = select(one_larger, one.mantissa, two.mantissa);
+        auto m_small = select(one_larger, two.mantissa, one.mantissa);
+
+        // exponent difference larger than M (the smaller operand only rounds)
+        auto far = greaterConstant(exponent_diff, M);
+        auto even = equalConstant(exponent_diff, M + 1) & m_large[0] & noneSet(m_small);
+        auto m_far = m_large;
+        auto e_far = e;
+        increment(e_far, increment(m_far, even));
+
+        // sum and rounding
+        auto sum = significand(m_large, M + extra_bits + 2);
+        add(sum, shiftRightJam(significand(m_small, M + extra_bits + 2), exponent_diff, stages(M)), all(false));
+
+        auto carrier = sum[M + extra_bits + 1];
+        assign(sum, carrier, shiftRightJam(sum, 1, sum.size()));
+
+        sliced m_near;
+        auto overflow = roundSignificand(sum, M, &m_near);
+        auto e_near = e;
+        increment(e_near, overflow);
+        increment(e_near, carrier);
+        auto inf = ~far & carrier & allSet(e_near);
+
+        fields ret{set_sign, select(far, e_far, e_near), select(far, m_far, m_near)};
+        assign(ret, inf, special(M, E, set_sign, true, false));
+        return ret;
+    }
+
+    /**
+     * Subtracts the magnitude of the subtrahend from the magnitude of the minued.
+     */
+    fields subtraction(const fields& minued, const fields& subtrahend, const lanes& set_sign){
+
+        const auto M = minued.mantissa.size();
+        const auto E = minued.exponent.size();
+
+        // order the operands by magnitude (exponent and mantissa as one number)
+        auto same = equal(minued.exponent, subtrahend.exponent) & equal(minued.mantissa, subtrahend.mantissa);
+
+        sliced magnitude_minued = minued.mantissa, magnitude_subtrahend = subtrahend.mantissa;
+        magnitude_minued.insert(magnitude_minued.end(), minued.exponent.begin(), minued.exponent.end());
+        magnitude_subtrahend.insert(magnitude_subtrahend.end(), subtrahend.exponent.begin(), subtrahend.exponent.end());
+        auto minued_larger = greater(magnitude_minued, magnitude_subtrahend);
+
+        auto diff_minued = minued.exponent;
+        subtract(diff_minued, subtrahend.exponent);
+        auto diff_subtrahend = subtrahend.exponent;
+        subtract(diff_subtrahend, minued.exponent);
+
+        auto e = select(minued_larger, minued.exponent, subtrahend.exponent);
+        auto exponent_diff = select(minued_larger, diff_minued, diff_subtrahend);
+        auto m_large = select(minued_larger, minued.mantissa, subtrahend.mantissa);
+        auto m_small = select(minued_larger, subtrahend.mantissa, minued.mantissa);
+        auto sign = set_sign ^ ~minued_larger;
+
+        // exponent difference larger than M
+        auto far = greaterConstant(exponent_diff, M);
+        auto next = equalConstant(exponent_diff, M + 1);
+        auto e_far = e;
+        decrement(e_far, next & noneSet(m_large));
+        auto m_far = m_large;
+        decrement(m_far, next);
+
+        // difference, normalisation and rounding
+        auto diff = significand(m_large, M + extra_bits + 2);
+        subtract(diff, shiftRightJam(significand(m_small, M + extra_bits + 2), exponent_diff, stages(M)));
+        diff.pop_back();
+
+        sliced exponent_shift;
+        normaliseLeft(diff, stages(M + extra_bits), &exponent_shift);
+
+        sliced m_near;
+        auto overflow = roundSignificand(diff, M, &m_near);
+        auto e_near = e;
+        subtract(e_near, exponent_shift);
+        increment(e_near, overflow);
+
+        fields ret{sign, select(far, e_far, e_near), select(far, m_far, m_near)};
+        assign(ret, same, special(M, E, all(false), false, false));
+        return ret;
+    }
+
+    /**
+     * Multiplies two values (array multiplier).
+     */
+    fields multiplication(const fields& one, const fields& two, const lanes& set_sign){
+
+        const auto M = one.mantissa.size();
+        const auto E = one.exponent.size();
+        const auto top = E - 1;
+
+        // exponent
+        auto addend = two.exponent;
+        addend[top] = ~addend[top];
+        increment(addend, all(true));
+        auto e_positive = one.exponent;
+        auto inf = add(e_positive, addend, all(false)) & ~addend[top];
+
+        auto subtrahend_one = bias(E);
+        subtract(subtrahend_one, one.exponent);
+        auto e_mixed = two.exponent;
+        subtract(e_mixed, subtrahend_one);
+
+        auto subtrahend_two = bias(E);
+        subtract(subtrahend_two, two.exponent);
+        auto zero = ~two.exponent[top] & greater(subtrahend_two, one.exponent);
+        auto e_negative = one.exponent;
+        subtract(e_negative, subtrahend_two);
+
+        auto both_positive = one.exponent[top] & two.exponent[top];
+        auto e = select(both_positive, e_positive, select(one.exponent[top], e_mixed, e_negative));
+        inf = inf & both_positive;
+        zero = zero & ~one.exponent[top];
+
+        // product of the significands (2M + 2 bits)
+        auto a = one.mantissa;
+        a.push_back(all(true));
+        auto b = two.mantissa;
+        b.push_back(all(true));
+
+        sliced product(2 * M + 2, all(false));
+        for(unsigned long j = 0; j <= M; j++){
+            auto carry = all(false);
+            for(unsigned long i = 0; i <= M; i++){
+                auto partial = a[i] & b[j];
+                auto half = product[i + j] ^ partial;
+                auto next = (product[i + j] & partial) | (half & carry);
+                product[i + j] = half ^ carry;
+                carry = next;
+            }
+            product[j + M + 1] = carry;
+        }
+
+        // normalisation (leading one in the plane 2M or 2M + 1) and rounding
+        auto large = product[2 * M + 1];
+        auto normalise = [&](unsigned long lead){
+            if(lead >= M + extra_bits){
+                return shiftRightJam(product, lead - (M + extra_bits), M + extra_bits + 1);
+            }
+            return shiftLeft(product, M + extra_bits - lead, M + extra_bits + 1);
+        };
+
+        sliced mantissa;
+        auto overflow = roundSignificand(select(large, normalise(2 * M + 1), normalise(2 * M)), M, &mantissa);
+        increment(e, overflow);
+        increment(e, large);
+
+        fields ret{set_sign, e, mantissa};
+        assign(ret, zero, special(M, E, all(false), false, false));
+        assign(ret, inf, special(M, E, set_sign, true, false));
+        return ret;
+    }
+
+    /**
+     * Divides two values (restoring division).
+     */
+    fields division(const fields& dividend, const fields& divisor, const lanes& set_sign){
+
+        const auto M = dividend.mantissa.size();
+        const auto E = dividend.exponent.size();
+        const auto top = E - 1;
+
+        // exponent
+        auto subtrahend = divisor.exponent;
+        subtrahend[top] = ~subtrahend[top];
+        increment(subtrahend, all(true));
+        auto e_positive = dividend.exponent;
+        auto zero = ~subtract(e_positive, subtrahend);
+
+        auto addend = bias(E);
+        subtract(addend, divisor.exponent);
+        auto e_negative = dividend.exponent;
+        auto inf = add(e_negative, addend, all(false));
+        inf = inf | allSet(e_negative);
+
+        auto e = select(divisor.exponent[top], e_positive, e_negative);
+        zero = zero & divisor.exponent[top];
+        inf = inf & ~divisor.exponent[top];
+
+        // quotient bits with the weights 2^0 to 2^-(M+2)
+        auto R = dividend.mantissa;
+        R.push_back(all(true));
+        R.push_back(all(false));
+        auto D = divisor.mantissa;
+        D.push_back(all(true));
+
+        sliced Q(M + 3), T;
+        for(auto i = M + 3; i > 0;){
+            i--;
+            T = R;
+            Q[i] = subtract(T, D);
+            assign(R, Q[i], T);
+            std::rotate(R.rbegin(), R.rbegin() + 1, R.rend());
+            R[0] = all(false);
+        }
+
+        // normalisation and rounding (see integerDivision)
+        auto leading = Q[M + 2];
+        sliced mantissa(Q.begin() + 2, Q.begin() + 2 + M);
+        auto round = Q[1];
+        if(M >= 3){
+            assign(mantissa, ~leading, sliced(Q.begin() + 1, Q.begin() + 1 + M));
+            round = select(leading, Q[1], Q[0]);
+        }
+        decrement(e, ~leading);
+        increment(mantissa, round);
+
+        fields ret{set_sign, e, mantissa};
+        assign(ret, zero, special(M, E, all(false), false, false));
+        assign(ret, inf, special(M, E, set_sign, true, false));
+        return ret;
+    }
+
+    /**
+     * Converts values to another format, like mps::cast (also its corner cases: values out of the range of the new
+     * exponent become +inf or +0, a mantissa that overflows in the rounding is not carried into the exponent).
+     * The counters are charged with the work of mps::round lane by lane: the scanned sticky bits and the half adders
+     * of the increment.
+     *
+     * @param valid the lanes that hold values
+     */
+    fields convert(const fields& x, unsigned long M, unsigned long E, const lanes& valid){
+
+        const auto M_old = x.mantissa.size();
+        const auto E_old = x.exponent.size();
+        const auto top = x.exponent[E_old - 1];
+        const auto c = classify(x);
+
+        fields ret{x.sign, sliced(E), sliced(M, all(false))};
+        auto out_of_range = all(false);
+        auto all_ones = all(false);
+
+        // exponent: the bits are inserted or removed below the highest bit
+        if(E >= E_old){
+            auto fill = ~top & ~c.zero;
+            for(unsigned long i = 0; i < E - 1; i++){
+                ret.exponent[i] = i < E_old - 1 ? x.exponent[i] : fill;
+            }
+        } else {
+            for(auto i = E - 1; i < E_old - 1; i++){
+                out_of_range = out_of_range | ~(x.exponent[i] ^ top);
+            }
+            out_of_range = out_of_range & ~c.zero;
+            all_ones = top & ~c.zero & allSet(sliced(x.exponent.begin(), x.exponent.begin() + (long) (E - 2)));
+            std::copy(x.exponent.begin(), x.exponent.begin() + (long) (E - 1), ret.exponent.begin());
+        }
+        ret.exponent[E - 1] = top;
+
+        // mantissa: extended with zeros or rounded to nearest, ties to even
+        if(M >= M_old){
+            std::copy(x.mantissa.begin(), x.mantissa.end(), ret.mantissa.begin() + (long) (M - M_old));
+        } else {
+            const auto cut = M_old - M;
+            std::copy(x.mantissa.begin() + (long) cut, x.mantissa.end(), ret.mantissa.begin());
+            auto carry = x.mantissa[cut - 1] & (anySet(x.mantissa, 0, cut - 1) | ret.mantissa[0]);
+
+            if(mps_counters::enabled){
+                auto scanning = valid & ~c.nan & ~c.inf & ~out_of_range & ~all_ones;
+                auto incrementing = scanning & carry;
+                for(auto i = cut - 1; i > 0;){
+                    i--;
+                    mps_counters::addBitComparisons(population(scanning));
+                    scanning = scanning & ~x.mantissa[i];
+                }
+                for(const auto& plane : ret.mantissa){
+                    mps_counters::addHalfAdders(population(incrementing));
+                    incrementing = incrementing & plane;
+                }
+            }
+            increment(ret.mantissa, carry);
+        }
+
+        assign(ret, all_ones | (out_of_range & top), special(M, E, all(false), true, false));
+        assign(ret, out_of_range & ~top, special(M, E, all(false), false, false));
+        assign(ret, c.inf, special(M, E, x.sign, true, false));
+        assign(ret, c.nan, special(M, E, all(false), true, true));
+        return ret;
+    }
+    //-------------------------------
+
+
+    // loading and storing blocks
+    //-------------------------------
+    fields load(const uint64_t* block, unsigned long M, unsigned long E){
+
+        auto plane = [&](unsigned long idx){
+            lanes ret;
+            std::copy(block + idx * slice_words, block + (idx + 1) * slice_words, ret.w);
+            return ret;
+        };
+
+        fields ret{plane(0), sliced(E), sliced(M)};
+        for(unsigned long i = 0; i < E; i++){
+            ret.exponent[i] = plane(1 + i);
+        }
+        for(unsigned long i = 0; i < M; i++){
+            ret.mantissa[i] = plane(1 + E + i);
+        }
+        return ret;
+    }
+
+    void store(uint64_t* block, const fields& value){
+
+        auto plane = [&](unsigned long idx, const lanes& bits){
+            std::copy(bits.w, bits.w + slice_words, block + idx * slice_words);
+        };
+
+        plane(0, value.sign);
+        for(unsigned long i = 0; i < value.exponent.size(); i++){
+            plane(1 + i, value.exponent[i]);
+        }
+        for(unsigned long i = 0; i < value.mantissa.size(); i++){
+            plane(1 + value.exponent.size() + i, value.mantissa[i]);
+        }
+    }
+    //-------------------------------
+}
+
+
+// constructors
+//-------------------------------
+/**
+ * Constructor for an array of values of the same format. All values are zero.
+ *
+ * @param mantissa_length the mantissa length of the values
+ * @param exponent_length the exponent length of the values
+ * @param size the number of values
+ */
+mps_sliced::mps_sliced(unsigned long mantissa_length, unsigned long exponent_length, size_t size) {
+
+    if (mantissa_length <= 0) {
+        throw std::invalid_argument("ERROR: in mps_sliced : mantissa size too small");
+    }
+    if (exponent_length <= 1) {
+        throw std::invalid_argument("ERROR: in mps_sliced : exponent size too small");
+    }
+
+    this->mantissa_length = mantissa_length;
+    this->exponent_length = exponent_length;
+    this->count = size;
+
+    auto blocks = (size + lanesPerBlock() - 1) / lanesPerBlock();
+    this->planes.assign(blocks * planesPerValue() * slice_words, 0);
+}
+
+/**
+ * Constructor that transposes a vector of mps objects into bit planes.
+ *
+ * Throws Exception:    When the vector is empty.
+ *                      When the formats of the values do not match.
+ *
+ * @param values the values
+ */
+mps_sliced::mps_sliced(const vector<mps>& values) {
+
+    if (values.empty()) {
+        throw std::invalid_argument("ERROR: in mps_sliced : values is empty");
+    }
+
+    *this = mps_sliced(values[0].getMantisseLength(), values[0].getExponentLength(), values.size());
+    for(size_t i = 0; i < values.size(); i++){
+        set(i, values[i]);
+    }
+}
+
+/**
+ * Returns the number of values processed at once (one bit per value in every word of a plane).
+ *
+ * @return values per block
+ */
+unsigned long mps_sliced::lanesPerBlock(){
+    return slice_words * word_size;
+}
+//-------------------------------
+
+
+// getter and setter methods
+//-------------------------------
+uint64_t* mps_sliced::block(size_t idx){
+    return this->planes.data() + idx * planesPerValue() * slice_words;
+}
+
+const uint64_t* mps_sliced::block(size_t idx) const{
+    return this->planes.data() + idx * planesPerValue() * slice_words;
+}
+
+/**
+ * Returns the value with the given index as mps object.
+ *
+ * @param idx index of the value
+ * @return the value
+ */
+mps mps_sliced::get(size_t idx) const {
+
+    if (idx >= this->count) {
+        throw std::invalid_argument("ERROR: in get : index out of range");
+    }
+
+    auto data = block(idx / lanesPerBlock());
+    auto lane = idx % lanesPerBlock();
+    auto bit = [&](unsigned long plane) -> bool {
+        return (data[plane * slice_words + lane / word_size] >> (lane % word_size)) & 1;
+    };
+
+    mps ret(this->mantissa_length, this->exponent_length);
+    ret.sign = bit(0);
+    for(unsigned long i = 0; i < this->exponent_length; i++){
+        ret.exponent[this->exponent_length - 1 - i] = bit(1 + i);
+    }
+    for(unsigned long i = 0; i < this->mantissa_length; i++){
+        ret.mantissa[this->mantissa_length - 1 - i] = bit(1 + this->exponent_length + i);
+    }
+    ret.updateClassification();
+
+    return ret;
+}
+
+/**
+ * Sets the value with the given index.
+ *
+ * Throws Exception:    When the index is out of range.
+ *                      When the format of the value does not match.
+ *
+ * @param idx index of the value
+ * @param value the new value
+ */
+void mps_sliced::set(size_t idx, const mps& value) {
+
+    if (idx >= this->count) {
+        throw std::invalid_argument("ERROR: in set : index out of range");
+    }
+    if (value.getExponentLength() != this->exponent_length) {
+        throw std::invalid_argument("ERROR: in set : Exponents do not match");
+    }
+    if (value.getMantisseLength() != this->mantissa_length) {
+        throw std::invalid_argument("ERROR: in set : Mantissas do not match");
+    }
+
+    auto data = block(idx / lanesPerBlock());
+    auto lane = idx % lanesPerBlock();
+    auto set_bit = [&](unsigned long plane, bool bit){
+        auto& word = data[plane * slice_words + lane / word_size];
+        auto mask = ((uint64_t) 1) << (lane % word_size);
+        word = bit ? word | mask : word & ~mask;
+    };
+
+    set_bit(0, value.sign);
+    for(unsigned long i = 0; i < this->exponent_length; i++){
+        set_bit(1 + i, value.exponent[this->exponent_length - 1 - i]);
+    }
+    for(unsigned long i = 0; i < this->mantissa_length; i++){
+        set_bit(1 + this->exponent_length + i, value.mantissa[this->mantissa_length - 1 - i]);
+    }
+}
+
+/**
+ * Returns all values as vector of mps objects.
+ *
+ * @return the values
+ */
+vector<mps> mps_sliced::toVector() const {
+
+    vector<mps> ret;
+    ret.reserve(this->count);
+    for(size_t i = 0; i < this->count; i++){
+        ret.push_back(get(i));
+    }
+
+    return ret;
+}
+//-------------------------------
+
+
+// cast
+//-------------------------------
+/**
+ * Casts all values to a new format. The result is the same as casting every value (mps::cast).
+ *
+ * Throws Exception:    When the new mantissa length is too small.
+ *                      When the new exponent length is too small.
+ *
+ * @param new_mantissa_size the new size of the mantissas
+ * @param new_exponent_size the new size of the exponents
+ */
+void mps_sliced::cast(unsigned long new_mantissa_size, unsigned long new_exponent_size) {
+
+    if (new_mantissa_size <= 0) {
+        throw std::invalid_argument("ERROR: in cast : new mantissa size too small");
+    }
+    if (new_exponent_size <= 1) {
+        throw std::invalid_argument("ERROR: in cast : new exponent size too small");
+    }
+
+    mps_sliced ret(new_mantissa_size, new_exponent_size, this->count);
+    auto blocks = (this->count + lanesPerBlock() - 1) / lanesPerBlock();
+
+    for(size_t idx = 0; idx < blocks; idx++){
+        auto valid = firstLanes(this->count - idx * lanesPerBlock());
+        auto value = load(block(idx), this->mantissa_length, this->exponent_length);
+        store(ret.block(idx), convert(value, new_mantissa_size, new_exponent_size, valid));
+    }
+
+    *this = std::move(ret);
+}
+//-------------------------------
+
+
+// operators
+//-------------------------------
+mps_sliced mps_sliced::operator+(const mps_sliced& other) const {
+    return calculate(other, '+');
+}
+
+mps_sliced mps_sliced::operator-(const mps_sliced& other) const {
+    return calculate(other, '-');
+}
+
+mps_sliced mps_sliced::operator*(const mps_sliced& other) const {
+    return calculate(other, '*');
+}
+
+mps_sliced mps_sliced::operator/(const mps_sliced& other) const {
+    return calculate(other, '/');
+}
+
+/**
+ * Computes an operation for all values, block by block. The special values are handled like in the operators of mps:
+ * the masks are applied from the lowest to the highest priority.
+ *
+ * Throws Exception:    When the formats do not match.
+ *                      When the sizes do not match.
+ *
+ * @param other the second operands
+ * @param operation '+', '-', '*' or '/'
+ * @return the results
+ */
+mps_sliced mps_sliced::calculate(const mps_sliced& other, char operation) const {
+
+    if (this->exponent_length != other.exponent_length) {
+        throw std::invalid_argument(std::string("ERROR: in ") + operation + " : Exponents do not match");
+    }
+    if (this->mantissa_length != other.mantissa_length) {
+        throw std::invalid_argument(std::string("ERROR: in ") + operation + " : Mantissas do not match");
+    }
+    if (this->count != other.count) {
+        throw std::invalid_argument(std::string("ERROR: in ") + operation + " : sizes do not match");
+    }
+
+    const auto M = this->mantissa_length;
+    const auto E = this->exponent_length;
+    mps_sliced ret(M, E, this->count);
+
+    const mps_counters::operation types[] = {mps_counters::operation::addition, mps_counters::operation::subtraction,
+                                             mps_counters::operation::multiplication, mps_counters::operation::division};
+    mps_counters::countOperation(types[std::string("+-*/").find(operation)], M, E, this->count);
+
+    // the gates of the planes are not the ones of the reference engine: every lane is charged with its cost instead
+    if(mps_counters::enabled){
+        for(size_t i = 0; i < this->count; i++){
+            mps::chargeOperator(get(i), other.get(i), operation);
+        }
+    }
+
+    const auto nan = special(M, E, all(false), true, true);
+    auto blocks = (this->count + lanesPerBlock() - 1) / lanesPerBlock();
+
+    for(size_t idx = 0; idx < blocks; idx++){
+
+        auto one = load(block(idx), M, E);
+        auto two = load(other.block(idx), M, E);
+        if('-' == operation){
+            two.sign = ~two.sign;   // a - b = a + (-b), also for the special values
+        }
+
+        auto c_one = classify(one);
+        auto c_two = classify(two);
+        auto different_signs = one.sign ^ two.sign;
+        fields result;
+
+        if('+' == operation || '-' == operation){
+
+            auto minued = one, subtrahend = two;
+            assign(minued, one.sign, two);
+            assign(subtrahend, one.sign, one);
+
+            result = addition(one, two, one.sign);
+            assign(result, different_signs, subtraction(minued, subtrahend, all(false)));
+
+            assign(result, c_two.zero, one);
+            assign(result, c_one.zero, two);
+            assign(result, c_two.inf, special(M, E, two.sign, true, false));
+            assign(result, c_one.inf, special(M, E, one.sign, true, false));
+            assign(result, c_one.inf & c_two.inf & different_signs, nan);
+
+        } else if('*' == operation){
+
+            result = multiplication(one, two, different_signs);
+
+            assign(result, c_one.zero | c_two.zero, special(M, E, all(false), false, false));
+            assign(result, c_two.inf, special(M, E, two.sign, true, false));
+            assign(result, c_one.inf, special(M, E, one.sign, true, false));
+            assign(result, c_one.inf & c_two.inf & ~different_signs, nan);
+
+        } else {
+
+            result = division(one, two, different_signs);
+
+            assign(result, c_two.zero, special(M, E, one.sign, true, false));
+            assign(result, c_one.zero, special(M, E, different_signs, false, false));
+            assign(result, c_two.inf, special(M, E, different_signs, false, false));
+            assign(result, c_one.inf, special(M, E, one.sign, true, false));
+            assign(result, c_one.inf & c_two.inf & ~different_signs, nan);
+        }
+
+        assign(result, c_one.nan | c_two.nan, nan);
+        store(ret.block(idx), result);
+    }
+
+    return ret;
+}
+//-------------------------------
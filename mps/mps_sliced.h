@@ -0,0 +1,84 @@
+//
+// mps_sliced => arrays of mps values of the same format, stored as bit planes.
+//
+// The values are grouped into blocks of lanesPerBlock() values. Inside a block, every bit of the floating point
+// representation (sign, exponent bit i, mantissa bit i) is stored as one plane: a row of 64-bit words in which bit k
+// belongs to the value k of the block. The arithmetic runs the integer kernels of the packed engine (ripple carry
+// adders, barrel shifters, array multiplier, restoring division) with bitwise operations on whole planes, so one gate
+// is evaluated for all values of a block at once. Decisions that depend on the value (alignment shift, normalisation,
+// rounding, special values) are computed as masks and select the result per lane.
+//
+// The results are bit for bit the same as the ones of the mps operators (reference and packed engine). The gates are
+// not the ones of the reference engine: it is a batched version of the packed engine, not a gate-level simulation.
+//
+
+#ifndef MPS_MPS_SLICED_H
+#define MPS_MPS_SLICED_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "mps.h"
+
+class mps_sliced {
+
+private:
+
+    // format and size
+    //-------------------------------
+    unsigned long mantissa_length;
+    unsigned long exponent_length;
+    size_t count;
+    //-------------------------------
+
+
+    // bit planes: block after block, inside a block the sign, the exponent and the mantissa planes (lowest bit first)
+    //-------------------------------
+    std::vector<uint64_t> planes;
+    //-------------------------------
+
+
+public:
+
+    // constructors
+    //-------------------------------
+    mps_sliced(unsigned long mantissa_length, unsigned long exponent_length, size_t size);
+    explicit mps_sliced(const vector<mps>& values);
+
+    // values per block (64 times the words of a plane, selected by MPS_SLICE_WORDS)
+    [[nodiscard]] static unsigned long lanesPerBlock();
+
+    // getter and setter methods
+    //-------------------------------
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] unsigned long getMantisseLength() const { return mantissa_length; }
+    [[nodiscard]] unsigned long getExponentLength() const { return exponent_length; }
+
+    [[nodiscard]] mps get(size_t idx) const;
+    void set(size_t idx, const mps& value);
+    [[nodiscard]] vector<mps> toVector() const;
+
+    // cast (element by element)
+    //-------------------------------
+    void cast(unsigned long mantissa_length, unsigned long exponent_length);
+
+    // operators (element by element)
+    //-------------------------------
+    mps_sliced operator+(const mps_sliced& other) const;
+    mps_sliced operator-(const mps_sliced& other) const;
+    mps_sliced operator*(const mps_sliced& other) const;
+    mps_sliced operator/(const mps_sliced& other) const;
+
+
+private:
+
+    [[nodiscard]] unsigned long planesPerValue() const { return 1 + exponent_length + mantissa_length; }
+    [[nodiscard]] uint64_t* block(size_t idx);
+    [[nodiscard]] const uint64_t* block(size_t idx) const;
+
+    [[nodiscard]] mps_sliced calculate(const mps_sliced& other, char operation) const;
+};
+
+
+#endif //MPS_MPS_SLICED_H
@@ -0,0 +1,1172 @@
+//
+// mps_t => floating point values of a format that is fixed at compile time.
+//
+// The format mps_t<M, E> has a mantissa with M bits and an exponent with E bits. The bias, the masks of the exponent,
+// the number of 64-bit limbs and the rounding positions are compile time constants, so the kernels below work on
+// fixed size arrays and the compiler can unroll (and vectorize) their loops. Operations between different formats do
+// not compile.
+//
+// The results are bit for bit the same as the ones of the mps class (for both arithmetic engines), including its
+// handling of special values and wrapping exponents. mps_t converts to and from mps, so it can be used together with
+// the existing code.
+//
+
+#ifndef MPS_MPS_T_H
+#define MPS_MPS_T_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+#include "mps.h"
+
+template<unsigned long M, unsigned long E>
+class mps_t {
+
+    static_assert(M >= 1, "mps_t: mantissa size too small");
+    static_assert(E >= 2, "mps_t: exponent size too small");
+    static_assert(E <= 62, "mps_t: exponent size too large (the exponent is stored in one 64-bit word)");
+
+public:
+
+    typedef uint64_t limb;
+
+    // properties of the format
+    //-------------------------------
+    static constexpr unsigned long mantissa_length = M;
+    static constexpr unsigned long exponent_length = E;
+
+    static constexpr uint64_t exponent_mask = (((uint64_t) 1) << E) - 1;
+    static constexpr uint64_t exponent_top = ((uint64_t) 1) << (E - 1);
+    static constexpr uint64_t bias = exponent_top - 1;
+
+    static constexpr unsigned long limb_size = 64;
+    static constexpr unsigned long mantissa_limbs = (M + limb_size - 1) / limb_size;
+    static constexpr unsigned long significand_limbs = M / limb_size + 1;                    // hidden one and mantissa
+    static constexpr unsigned long work_limbs = (2 * M + 4 + limb_size - 1) / limb_size;     // exact intermediate results
+
+    // mask of the used bits in the highest limb of the mantissa
+    static constexpr limb mantissa_high_mask = 0 == M % limb_size ? ~((limb) 0) : (((limb) 1) << (M % limb_size)) - 1;
+
+    // first bit below the mantissa of a quotient (M + 3 bits are computed)
+    static constexpr unsigned long quotient_rounding_position = 2;
+    //-------------------------------
+
+
+    // constructors
+    //-------------------------------
+    mps_t();
+    explicit mps_t(double value);
+    explicit mps_t(const mps& other);
+
+    // conversion
+    //-------------------------------
+    [[nodiscard]] mps toMps() const;
+    operator mps() const { return toMps(); }
+
+    // getter methods
+    //-------------------------------
+    [[nodiscard]] bool getSign() const { return sign; }
+    [[nodiscard]] double getValue() const { return toMps().getValue(); }
+
+    [[nodiscard]] bool isZero() const;
+    [[nodiscard]] bool isInf() const;
+    [[nodiscard]] bool isPositive() const { return !sign; }
+    [[nodiscard]] bool isNaN() const;
+
+    [[nodiscard]] std::string print() const { return toMps().print(); }
+    [[nodiscard]] std::string toString(int precision = -1) const { return toMps().toString(precision); }
+
+    // setter methods
+    //-------------------------------
+    void setInf(bool negative = false);
+    void setZero(bool negative = false);
+    void setNaN(bool negative = false);
+    void setSign(bool negative){ sign = negative; }
+
+    // operators
+    //-------------------------------
+    mps_t operator+(const mps_t& other) const;
+    mps_t operator-(const mps_t& other) const;
+    mps_t operator*(const mps_t& other) const;
+    mps_t operator/(const mps_t& other) const;
+    mps_t& operator+=(const mps_t& other){ return *this = *this + other; }
+    mps_t& operator-=(const mps_t& other){ return *this = *this - other; }
+    mps_t& operator*=(const mps_t& other){ return *this = *this * other; }
+    mps_t& operator/=(const mps_t& other){ return *this = *this / other; }
+
+    // comparators
+    //-------------------------------
+    bool operator==(const mps_t& other) const;
+    bool operator!=(const mps_t& other) const;
+    bool operator>(const mps_t& other) const;
+    bool operator<(const mps_t& other) const;
+    bool operator>=(const mps_t& other) const;
+    bool operator<=(const mps_t& other) const;
+
+
+private:
+
+    typedef std::array<limb, mantissa_limbs> field;     // mantissa as little endian integer
+    typedef std::array<limb, work_limbs> wide;          // significands and exact results
+
+    // the actual bit array
+    //-------------------------------
+    bool sign;
+    uint64_t exponent;
+    field mantissa;
+    //-------------------------------
+
+    // helper for operators
+    //-------------------------------
+    [[nodiscard]] static mps_t addition(const mps_t& one, const mps_t& two, bool set_sign);
+    [[nodiscard]] static mps_t subtraction(const mps_t& minued, const mps_t& subtrahend, bool set_sign);
+    [[nodiscard]] static mps_t multiplication(const mps_t& one, const mps_t& two, bool set_sign);
+    [[nodiscard]] static mps_t division(const mps_t& dividend, const mps_t& divisor, bool set_sign);
+    [[nodiscard]] static char compare(const mps_t& one, const mps_t& two);
+
+    // helper for the mantissa
+    //-------------------------------
+    [[nodiscard]] static bool noneSet(const field& value);
+    static bool addOne(field& value);
+    static void subtractOne(field& value);
+    [[nodiscard]] static wide significand(const field& value);
+    [[nodiscard]] static field lowBits(const wide& value);
+    [[nodiscard]] static field roundFraction(const wide& fraction, unsigned long length, bool* overflow);
+
+    // helper for the exact results
+    //-------------------------------
+    [[nodiscard]] static unsigned long bitLength(const wide& value);
+    [[nodiscard]] static bool testBit(const wide& value, unsigned long idx);
+    static void setBit(wide& value, unsigned long idx);
+    [[nodiscard]] static bool anyBitBelow(const wide& value, unsigned long idx);
+    static void truncate(wide& value, unsigned long n);
+    static void wideShiftLeft(wide& value, unsigned long count);
+    static void wideShiftRight(wide& value, unsigned long count);
+    static void wideAdd(wide& value, const wide& addend);
+    static void wideSubtract(wide& value, const wide& subtrahend);
+    [[nodiscard]] static char wideCompare(const wide& a, const wide& b);
+    [[nodiscard]] static wide wideMultiply(const wide& a, const wide& b);
+};
+
+
+// common formats
+//-------------------------------
+typedef mps_t<10, 5> mps_binary16;
+typedef mps_t<7, 8> mps_bfloat16;
+typedef mps_t<23, 8> mps_binary32;
+typedef mps_t<52, 11> mps_binary64;
+typedef mps_t<112, 15> mps_binary128;
+//-------------------------------
+
+
+// constructors
+//-------------------------------
+
+/**
+ * Constructor for a value of the format. The value is set to NAN (the same as for the mps class).
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E>::mps_t() : sign(false), exponent(0), mantissa() {
+    setNaN();
+}
+
+/**
+ * Constructor using a double value. The conversion is the same as the one of the mps class.
+ *
+ * @param value Value of the floating point number
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E>::mps_t(double value) : mps_t(mps(M, E, value)) {}
+
+/**
+ * Constructor converting an mps object.
+ *
+ * Throws Exception:    When the mantissas do not match.
+ *                      When the exponents do not match.
+ *
+ * @param other reference to the mps object
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E>::mps_t(const mps& other) : sign(other.sign), exponent(0), mantissa() {
+
+    if (E != other.exponent_length) {
+        throw std::invalid_argument("ERROR: in mps_t : Exponents do not match");
+    }
+    if (M != other.mantissa_length) {
+        throw std::invalid_argument("ERROR: in mps_t : Mantissas do not match");
+    }
+
+    exponent = other.exponent.toInt();
+
+    // The packed words are left aligned and start with the most significant bit.
+    constexpr auto s = mantissa_limbs * limb_size - M;
+    auto words = other.mantissa.data();
+    for(unsigned long k = 0; k < mantissa_limbs; k++){
+        mantissa[k] = words[mantissa_limbs-1-k] >> s;
+        if(s && k + 1 < mantissa_limbs){
+            mantissa[k] |= words[mantissa_limbs-2-k] << (limb_size - s);
+        }
+    }
+}
+//-------------------------------
+
+
+// conversion
+//-------------------------------
+
+/**
+ * Returns the value as mps object.
+ *
+ * @return the mps object with the same bits
+ */
+template<unsigned long M, unsigned long E>
+mps mps_t<M, E>::toMps() const {
+
+    mps ret(M, E);
+    ret.sign = sign;
+    ret.exponent.fromInt(exponent);
+
+    constexpr auto s = mantissa_limbs * limb_size - M;
+    auto words = ret.mantissa.data();
+    for(unsigned long j = 0; j < mantissa_limbs; j++){
+        auto k = mantissa_limbs-1-j;
+        words[j] = mantissa[k] << s;
+        if(s && k > 0){
+            words[j] |= mantissa[k-1] >> (limb_size - s);
+        }
+    }
+    ret.updateClassification();
+
+    return ret;
+}
+//-------------------------------
+
+
+// special values
+//-------------------------------
+
+/**
+ * Returns true if the value is positive or negative zero.
+ *
+ * @return true if zero
+ */
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::isZero() const {
+    return 0 == exponent && noneSet(mantissa);
+}
+
+/**
+ * Returns true if the value is positive or negative infinity.
+ *
+ * @return true if pos. or neg. infinity
+ */
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::isInf() const {
+    return exponent_mask == exponent && noneSet(mantissa);
+}
+
+/**
+ * Returns true if the value is NaN (exponent 11...1, mantissa 100...0).
+ *
+ * @return true if NaN
+ */
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::isNaN() const {
+
+    if(exponent_mask != exponent){
+        return false;
+    }
+
+    for(unsigned long k = 0; k + 1 < mantissa_limbs; k++){
+        if(mantissa[k]){
+            return false;
+        }
+    }
+
+    return mantissa[mantissa_limbs-1] == ((limb) 1) << ((M - 1) % limb_size);
+}
+
+/**
+ * Sets the value to infinity.
+ *
+ * @param negative set to true for negative infinity (default false)
+ */
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::setInf(bool negative) {
+    sign = negative;
+    exponent = exponent_mask;
+    mantissa.fill(0);
+}
+
+/**
+ * Sets the value to zero.
+ *
+ * @param negative set to true for negative zero (default false)
+ */
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::setZero(bool negative) {
+    sign = negative;
+    exponent = 0;
+    mantissa.fill(0);
+}
+
+/**
+ * Sets the value to NaN (not a number).
+ *
+ * @param negative sets the sign bit of the NaN value
+ */
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::setNaN(bool negative) {
+    sign = negative;
+    exponent = exponent_mask;
+    mantissa.fill(0);
+    mantissa[mantissa_limbs-1] = ((limb) 1) << ((M - 1) % limb_size);
+}
+//-------------------------------
+
+
+// operators
+//-------------------------------
+
+/**
+ * Performs an addition of two values. Handles the special values like mps::operator+.
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::operator+(const mps_t& other) const {
+
+    mps_t ret;
+
+    if(this->isNaN() || other.isNaN()){
+        ret.setNaN();
+        return ret;
+    } else if(this->isInf() && other.isInf()){
+        if(this->isPositive() == other.isPositive()){
+            ret.setInf(!this->isPositive());
+        } else {
+            ret.setNaN();
+        }
+        return ret;
+    } else if(this->isInf()){
+        ret.setInf(!this->isPositive());
+        return ret;
+    } else if(other.isInf()){
+        ret.setInf(!other.isPositive());
+        return ret;
+    } else if(this->isZero()){
+        return other;
+    } else if(other.isZero()){
+        return *this;
+    }
+
+    if(this->isPositive() && other.isPositive()){
+        return addition(*this, other, false);
+    } else if(!this->isPositive() && !other.isPositive()){
+        return addition(*this, other, true);
+    } else if(!this->isPositive()){
+        return subtraction(other, *this, false);
+    } else {
+        return subtraction(*this, other, false);
+    }
+}
+
+/**
+ * Performs a subtraction of two values. Handles the special values like mps::operator-.
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::operator-(const mps_t& other) const {
+
+    mps_t ret;
+
+    if(this->isNaN() || other.isNaN()){
+        ret.setNaN();
+        return ret;
+    } else if(this->isInf() && other.isInf()){
+        if(this->isPositive() == other.isPositive()){
+            ret.setNaN();
+        } else {
+            ret.setInf(!this->isPositive());
+        }
+        return ret;
+    } else if(this->isInf()){
+        ret.setInf(!this->isPositive());
+        return ret;
+    } else if(other.isInf()){
+        ret.setInf(other.isPositive());
+        return ret;
+    } else if(this->isZero()){
+        ret = other;
+        ret.sign = !ret.sign;
+        return ret;
+    } else if(other.isZero()){
+        return *this;
+    }
+
+    if(this->isPositive() && other.isPositive()){
+        return subtraction(*this, other, false);
+    } else if(!this->isPositive() && !other.isPositive()){
+        return subtraction(*this, other, true);
+    } else if(this->isPositive()){
+        return addition(*this, other, false);
+    } else {
+        return addition(*this, other, true);
+    }
+}
+
+/**
+ * Performs a multiplication of two values. Handles the special values like mps::operator*.
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::operator*(const mps_t& other) const {
+
+    mps_t ret;
+
+    if(this->isNaN() || other.isNaN()){
+        ret.setNaN();
+        return ret;
+    } else if(this->isInf() && other.isInf()){
+        if(this->isPositive() == other.isPositive()){
+            ret.setNaN();
+        } else {
+            ret.setInf(!this->isPositive());
+        }
+        return ret;
+    } else if(this->isInf()){
+        ret.setInf(!this->isPositive());
+        return ret;
+    } else if(other.isInf()){
+        ret.setInf(!other.isPositive());
+        return ret;
+    } else if(this->isZero() || other.isZero()){
+        ret.setZero();
+        return ret;
+    }
+
+    return multiplication(*this, other, this->sign != other.sign);
+}
+
+/**
+ * Performs a division of two values. Handles the special values like mps::operator/.
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::operator/(const mps_t& other) const {
+
+    mps_t ret;
+
+    if(this->isNaN() || other.isNaN()){
+        ret.setNaN();
+        return ret;
+    } else if(this->isInf() && other.isInf()){
+        if(this->isPositive() == other.isPositive()){
+            ret.setNaN();
+        } else {
+            ret.setInf(!this->isPositive());
+        }
+        return ret;
+    } else if(this->isInf()){
+        ret.setInf(!this->isPositive());
+        return ret;
+    } else if(other.isInf() || this->isZero()){
+        ret.setZero(this->isPositive() != other.isPositive());
+        return ret;
+    } else if(other.isZero()){
+        ret.setInf(!this->isPositive());
+        return ret;
+    }
+
+    return division(*this, other, this->sign != other.sign);
+}
+//-------------------------------
+
+
+// comparators
+//-------------------------------
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::operator==(const mps_t& other) const {
+
+    if(this->isNaN() || other.isNaN()){
+        return false;
+    }
+
+    return this->sign == other.sign && 0 == compare(*this, other);
+}
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::operator!=(const mps_t& other) const {
+
+    if(this->isNaN() || other.isNaN()){
+        return true;
+    }
+
+    return this->sign != other.sign || 0 != compare(*this, other);
+}
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::operator>(const mps_t& other) const {
+
+    if(this->isNaN() || other.isNaN()){
+        return false;
+    }
+
+    if(this->sign != other.sign){
+        return !this->sign;
+    }
+
+    return 1 == (this->sign ? compare(other, *this) : compare(*this, other));
+}
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::operator<(const mps_t& other) const {
+
+    if(this->isNaN() || other.isNaN()){
+        return false;
+    }
+
+    if(this->sign != other.sign){
+        return this->sign;
+    }
+
+    return -1 == (this->sign ? compare(other, *this) : compare(*this, other));
+}
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::operator>=(const mps_t& other) const {
+
+    if(this->isNaN() || other.isNaN()){
+        return false;
+    }
+
+    if(this->sign != other.sign){
+        return !this->sign;
+    }
+
+    return -1 != (this->sign ? compare(other, *this) : compare(*this, other));
+}
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::operator<=(const mps_t& other) const {
+
+    if(this->isNaN() || other.isNaN()){
+        return false;
+    }
+
+    if(this->sign != other.sign){
+        return this->sign;
+    }
+
+    return 1 != (this->sign ? compare(other, *this) : compare(*this, other));
+}
+//-------------------------------
+
+
+// kernels
+//-------------------------------
+
+/**
+ * Performs an addition on two values that have the same sign (see mps::packedAddition).
+ *
+ * @param one reference to the first addend
+ * @param two reference to the second addend
+ * @param set_sign the sign to which the final result should be set
+ * @return the resulting value
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::addition(const mps_t& one, const mps_t& two, bool set_sign) {
+
+    mps_t ret;
+    ret.sign = set_sign;
+
+    // order the operands by exponent
+    //-------------------------------
+    const mps_t& large = one.exponent >= two.exponent ? one : two;
+    const mps_t& small = one.exponent >= two.exponent ? two : one;
+    auto e = large.exponent;
+    auto exponent_diff = large.exponent - small.exponent;
+
+    if(exponent_diff > M){
+
+        ret.mantissa = large.mantissa;
+
+        // special case where the rounding distance is the same, and the rounded number, therefore, must be even.
+        if(exponent_diff == M + 1 && (large.mantissa[0] & 1) && noneSet(small.mantissa)){
+            if(addOne(ret.mantissa)){
+                e = (e + 1) & exponent_mask;
+            }
+        }
+
+        ret.exponent = e;
+        return ret;
+    }
+    //-------------------------------
+
+
+    // exact sum and rounding
+    //-------------------------------
+    auto sum = significand(large.mantissa);
+    wideShiftLeft(sum, exponent_diff);
+    wideAdd(sum, significand(small.mantissa));
+
+    auto length = M + exponent_diff;
+    bool carrier = testBit(sum, length + 1);
+    if(carrier){
+        length++;
+    }
+    truncate(sum, length);      // remove the leading one
+
+    bool overflow;
+    ret.mantissa = roundFraction(sum, length, &overflow);
+
+    if(overflow){
+        e = (e + 1) & exponent_mask;
+    }
+    //-------------------------------
+
+    if(carrier){
+        e = (e + 1) & exponent_mask;
+        if(e == exponent_mask){
+            ret.setInf(set_sign);
+            return ret;
+        }
+    }
+
+    ret.exponent = e;
+    return ret;
+}
+
+/**
+ * Performs a subtraction on two values that have the same sign (see mps::packedSubtraction).
+ *
+ * @param minued reference to the minued number
+ * @param subtrahend reference to the subtracted number
+ * @param set_sign the sign to which the final result should be set
+ * @return the resulting value
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::subtraction(const mps_t& minued, const mps_t& subtrahend, bool set_sign) {
+
+    mps_t ret;
+    ret.sign = set_sign;
+
+    // order the operands by magnitude
+    //-------------------------------
+    auto larger_tmp = compare(minued, subtrahend);
+    if(0 == larger_tmp){
+        ret.setZero();
+        return ret;
+    }
+
+    const mps_t& large = 1 == larger_tmp ? minued : subtrahend;
+    const mps_t& small = 1 == larger_tmp ? subtrahend : minued;
+    auto e = large.exponent;
+    auto exponent_diff = large.exponent - small.exponent;
+    if(-1 == larger_tmp){
+        ret.sign = !ret.sign; // flip sign
+    }
+
+    if(exponent_diff > M){
+
+        ret.mantissa = large.mantissa;
+
+        if(exponent_diff == M + 1){
+            if(noneSet(ret.mantissa)){
+                e = (e - 1) & exponent_mask;
+            }
+            subtractOne(ret.mantissa);
+        }
+
+        ret.exponent = e;
+        return ret;
+    }
+    //-------------------------------
+
+
+    // exact difference, normalisation and rounding
+    //-------------------------------
+    auto diff = significand(large.mantissa);
+    wideShiftLeft(diff, exponent_diff);
+    wideSubtract(diff, significand(small.mantissa));
+
+    auto length = M + exponent_diff;
+    auto exponent_shift = length + 1 - bitLength(diff);
+
+    wideShiftLeft(diff, exponent_shift);
+    truncate(diff, length);     // remove the leading one
+    e = (e - exponent_shift) & exponent_mask;
+
+    bool overflow;
+    ret.mantissa = roundFraction(diff, length, &overflow);
+
+    if(overflow){
+        e = (e + 1) & exponent_mask;
+    }
+    //-------------------------------
+
+    ret.exponent = e;
+    return ret;
+}
+
+/**
+ * Performs a multiplication on two values (see mps::packedMultiplication).
+ *
+ * @param one reference to the first multiplicand
+ * @param two reference to the second multiplicand
+ * @param set_sign the sign to which the final result should be set
+ * @return the resulting value
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::multiplication(const mps_t& one, const mps_t& two, bool set_sign) {
+
+    mps_t ret;
+    ret.sign = set_sign;
+
+    // Calculate the exponent
+    //-------------------------------
+    auto e_one = one.exponent;
+    auto e_two = two.exponent;
+    uint64_t e;
+
+    if((e_one & exponent_top) && (e_two & exponent_top)){ // Both exponents are positive.
+
+        uint64_t addend = ((e_two ^ exponent_top) + 1) & exponent_mask;
+        e = e_one + addend;
+
+        // Check if the number will be more than the maximal allowed value.
+        if(e > exponent_mask && !(addend & exponent_top)){
+            ret.setInf(ret.sign);
+            return ret;
+        }
+        e &= exponent_mask;
+
+    } else if(e_one & exponent_top){
+        e = (e_two - ((bias - e_one) & exponent_mask)) & exponent_mask;
+    } else {
+        uint64_t subtrahend = (bias - e_two) & exponent_mask;
+
+        if(!(e_two & exponent_top) && subtrahend > e_one){
+            ret.setZero();
+            return ret;
+        }
+
+        e = (e_one - subtrahend) & exponent_mask;
+    }
+    //-------------------------------
+
+
+    // Calculate the mantissa
+    //-------------------------------
+    auto product = wideMultiply(significand(one.mantissa), significand(two.mantissa));
+
+    auto length = 2 * M;
+    bool large = testBit(product, length + 1);
+    if(large){
+        length++;
+    }
+    truncate(product, length);      // remove the leading one
+
+    bool overflow;
+    ret.mantissa = roundFraction(product, length, &overflow);
+    //-------------------------------
+
+    if(overflow){
+        e = (e + 1) & exponent_mask;
+    }
+    if(large){
+        e = (e + 1) & exponent_mask;
+    }
+
+    ret.exponent = e;
+    return ret;
+}
+
+/**
+ * Performs a division on two values (see mps::packedDivision).
+ *
+ * @param dividend reference to the dividend of the division
+ * @param divisor reference to the divisor of the division
+ * @param set_sign the sign to which the final result should be set
+ * @return the resulting value
+ */
+template<unsigned long M, unsigned long E>
+mps_t<M, E> mps_t<M, E>::division(const mps_t& dividend, const mps_t& divisor, bool set_sign) {
+
+    mps_t ret;
+    ret.sign = set_sign;
+
+    // Calculate the exponent
+    //-------------------------------
+    auto e_dividend = dividend.exponent;
+    auto e_divisor = divisor.exponent;
+    uint64_t e;
+
+    if(e_divisor & exponent_top){
+
+        e = (e_dividend - (((e_divisor ^ exponent_top) + 1) & exponent_mask)) & exponent_mask;
+
+        if(e > e_dividend){
+            ret.setZero();
+            return ret;
+        }
+
+    } else {
+
+        e = e_dividend + ((bias - e_divisor) & exponent_mask);
+
+        if(e >= exponent_mask){
+            ret.setInf(ret.sign);
+            return ret;
+        }
+    }
+    //-------------------------------
+
+
+    // Division
+    //-------------------------------
+
+    // restoring division producing the quotient bits with the weights 2^0 to 2^-(M+2)
+    auto R = significand(dividend.mantissa);
+    auto D = significand(divisor.mantissa);
+    wide Q{};
+
+    for(auto i = M + 3; i > 0;){
+        i--;
+
+        if(wideCompare(R, D) >= 0){
+            wideSubtract(R, D);
+            setBit(Q, i);
+        }
+        wideShiftLeft(R, 1);
+        truncate(R, M + 3);
+    }
+
+    // normalisation (see mps::packedDivision)
+    bool leading = testBit(Q, M + 2);
+    unsigned long count = (leading || M < 3) ? 1 : 2;
+    if(!leading){
+        e = (e - 1) & exponent_mask;
+    }
+
+    auto quotient = Q;
+    wideShiftRight(quotient, 3 - count);
+    ret.mantissa = lowBits(quotient);
+    //-------------------------------
+
+
+    // rounding
+    //-------------------------------
+    if(testBit(Q, quotient_rounding_position - count)){
+        addOne(ret.mantissa);
+    }
+    //-------------------------------
+
+    ret.exponent = e;
+    return ret;
+}
+
+/**
+ * Compares the magnitude of two values (exponent first, then mantissa).
+ * Info: Does not check for special values.
+ *
+ * @return 1: first is larger; 0: both are the same; -1: second is larger
+ */
+template<unsigned long M, unsigned long E>
+char mps_t<M, E>::compare(const mps_t& one, const mps_t& two) {
+
+    if(one.exponent != two.exponent){
+        return one.exponent > two.exponent ? 1 : -1;
+    }
+
+    for(auto k = mantissa_limbs; k > 0;){
+        k--;
+        if(one.mantissa[k] != two.mantissa[k]){
+            return one.mantissa[k] > two.mantissa[k] ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+//-------------------------------
+
+
+// helper for the mantissa
+//-------------------------------
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::noneSet(const field& value) {
+
+    limb ret = 0;
+    for(auto v : value){
+        ret |= v;
+    }
+
+    return 0 == ret;
+}
+
+/**
+ * Adds one to the mantissa (modulo 2^M).
+ *
+ * @return true if a carrier bit was present at the end
+ */
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::addOne(field& value) {
+
+    for(unsigned long k = 0; k + 1 < mantissa_limbs; k++){
+        if(++value[k]){
+            return false;
+        }
+    }
+
+    auto& high = value[mantissa_limbs-1];
+    high = (high + 1) & mantissa_high_mask;
+    return 0 == high;
+}
+
+/**
+ * Subtracts one from the mantissa (modulo 2^M).
+ */
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::subtractOne(field& value) {
+
+    for(unsigned long k = 0; k + 1 < mantissa_limbs; k++){
+        if(value[k]--){
+            return;
+        }
+    }
+
+    auto& high = value[mantissa_limbs-1];
+    high = (high - 1) & mantissa_high_mask;
+}
+
+/**
+ * Returns the significand (hidden one followed by the mantissa) as integer.
+ */
+template<unsigned long M, unsigned long E>
+typename mps_t<M, E>::wide mps_t<M, E>::significand(const field& value) {
+
+    wide ret{};
+    for(unsigned long k = 0; k < mantissa_limbs; k++){
+        ret[k] = value[k];
+    }
+    setBit(ret, M);
+
+    return ret;
+}
+
+/**
+ * Returns the lowest M bits.
+ */
+template<unsigned long M, unsigned long E>
+typename mps_t<M, E>::field mps_t<M, E>::lowBits(const wide& value) {
+
+    field ret;
+    for(unsigned long k = 0; k < mantissa_limbs; k++){
+        ret[k] = value[k];
+    }
+    ret[mantissa_limbs-1] &= mantissa_high_mask;
+
+    return ret;
+}
+
+/**
+ * Rounds a fraction with length bits (length >= M) to M bits (round to nearest, ties to even).
+ *
+ * @param fraction reference to the bits of the fraction (without leading one)
+ * @param length the number of bits of the fraction
+ * @param overflow set to true if rounding up overflowed (the result is zero in this case)
+ * @return the rounded fraction
+ */
+template<unsigned long M, unsigned long E>
+typename mps_t<M, E>::field mps_t<M, E>::roundFraction(const wide& fraction, unsigned long length, bool* overflow) {
+
+    *overflow = false;
+
+    if(length == M){
+        return lowBits(fraction);
+    }
+
+    auto cut = length - M;
+    auto shifted = fraction;
+    wideShiftRight(shifted, cut);
+    auto ret = lowBits(shifted);
+
+    if(testBit(fraction, cut-1) && (anyBitBelow(fraction, cut-1) || (ret[0] & 1))){
+        *overflow = addOne(ret);
+    }
+
+    return ret;
+}
+//-------------------------------
+
+
+// helper for the exact results
+//-------------------------------
+
+/**
+ * Returns the number of bits needed to represent the value (0 for zero).
+ */
+template<unsigned long M, unsigned long E>
+unsigned long mps_t<M, E>::bitLength(const wide& value) {
+
+    for(auto k = work_limbs; k > 0;){
+        k--;
+        if(value[k]){
+            return k * limb_size + limb_size - __builtin_clzll(value[k]);
+        }
+    }
+
+    return 0;
+}
+
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::testBit(const wide& value, unsigned long idx) {
+    return (value[idx / limb_size] >> (idx % limb_size)) & 1;
+}
+
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::setBit(wide& value, unsigned long idx) {
+    value[idx / limb_size] |= ((limb) 1) << (idx % limb_size);
+}
+
+/**
+ * Returns true if any of the bits below idx is set.
+ */
+template<unsigned long M, unsigned long E>
+bool mps_t<M, E>::anyBitBelow(const wide& value, unsigned long idx) {
+
+    auto full = idx / limb_size;
+    for(unsigned long k = 0; k < full; k++){
+        if(value[k]){
+            return true;
+        }
+    }
+
+    auto rest = idx % limb_size;
+    return rest && (value[full] & ((((limb) 1) << rest) - 1)) != 0;
+}
+
+/**
+ * Keeps only the lowest n bits.
+ */
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::truncate(wide& value, unsigned long n) {
+
+    auto k = n / limb_size;
+    if(k >= work_limbs){
+        return;
+    }
+
+    value[k] &= (((limb) 1) << (n % limb_size)) - 1;
+    for(k++; k < work_limbs; k++){
+        value[k] = 0;
+    }
+}
+
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::wideShiftLeft(wide& value, unsigned long count) {
+
+    auto word_shift = count / limb_size;
+    auto bit_shift = count % limb_size;
+
+    for(auto k = work_limbs; k > 0;){
+        k--;
+
+        limb v = 0;
+        if(k >= word_shift){
+            v = value[k - word_shift] << bit_shift;
+            if(bit_shift && k > word_shift){
+                v |= value[k - word_shift - 1] >> (limb_size - bit_shift);
+            }
+        }
+        value[k] = v;
+    }
+}
+
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::wideShiftRight(wide& value, unsigned long count) {
+
+    auto word_shift = count / limb_size;
+    auto bit_shift = count % limb_size;
+
+    for(unsigned long k = 0; k < work_limbs; k++){
+
+        limb v = 0;
+        if(k + word_shift < work_limbs){
+            v = value[k + word_shift] >> bit_shift;
+            if(bit_shift && k + word_shift + 1 < work_limbs){
+                v |= value[k + word_shift + 1] << (limb_size - bit_shift);
+            }
+        }
+        value[k] = v;
+    }
+}
+
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::wideAdd(wide& value, const wide& addend) {
+
+    limb carrier = 0;
+    for(unsigned long k = 0; k < work_limbs; k++){
+        limb s = value[k] + addend[k];
+        limb c1 = s < value[k];
+        value[k] = s + carrier;
+        carrier = c1 | (value[k] < s);
+    }
+}
+
+/**
+ * Subtracts the subtrahend from the value. Requires value >= subtrahend.
+ */
+template<unsigned long M, unsigned long E>
+void mps_t<M, E>::wideSubtract(wide& value, const wide& subtrahend) {
+
+    limb borrow = 0;
+    for(unsigned long k = 0; k < work_limbs; k++){
+        limb d = value[k] - subtrahend[k];
+        limb b1 = value[k] < subtrahend[k];
+        value[k] = d - borrow;
+        borrow = b1 | (d < borrow);
+    }
+}
+
+/**
+ * @return 1 if a > b, 0 if a == b, -1 if a < b
+ */
+template<unsigned long M, unsigned long E>
+char mps_t<M, E>::wideCompare(const wide& a, const wide& b) {
+
+    for(auto k = work_limbs; k > 0;){
+        k--;
+        if(a[k] != b[k]){
+            return a[k] > b[k] ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Multiplies two significands (schoolbook multiplication on limbs).
+ */
+template<unsigned long M, unsigned long E>
+typename mps_t<M, E>::wide mps_t<M, E>::wideMultiply(const wide& a, const wide& b) {
+
+    wide ret{};
+
+    for(unsigned long i = 0; i < significand_limbs; i++){
+        limb carrier = 0;
+        for(unsigned long j = 0; j < significand_limbs; j++){
+            unsigned __int128 t = (unsigned __int128) a[i] * b[j] + ret[i+j] + carrier;
+            ret[i+j] = (limb) t;
+            carrier = (limb) (t >> limb_size);
+        }
+        // The exact product has at most 2M+2 bits, so the last carrier is zero if it does not fit.
+        if(i + significand_limbs < work_limbs){
+            ret[i + significand_limbs] = carrier;
+        }
+    }
+
+    return ret;
+}
+//-------------------------------
+
+#endif //MPS_MPS_T_H
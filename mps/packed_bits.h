@@ -0,0 +1,546 @@
+//
+// packed_bits => a bit string stored in packed 64-bit words.
+//
+// The bits are stored most significant first: bit 0 is the highest bit of the first word. Therefore, a field of the
+// floating point representation can be read as a left aligned binary fraction, and the words of two fields of the same
+// length can be compared or added directly. The interface mirrors the parts of vector<bool> used by the bit level
+// algorithms, so they can still access the bits one by one.
+//
+// Bit strings with up to 128 bits (two words) are stored inside the object and do not use heap memory.
+//
+// bits_view is a non-owning read view of a bit string (pointer to the words and the length). It stays valid as long as
+// the viewed bit string is neither changed nor destroyed.
+//
+
+#ifndef MPS_PACKED_BITS_H
+#define MPS_PACKED_BITS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "inline_vector.h"
+
+class bits_view {
+
+public:
+
+    typedef uint64_t word;
+    static constexpr unsigned long word_size = 64;
+
+    bits_view() : words(nullptr), length(0) {}
+    bits_view(const word* words, unsigned long length) : words(words), length(length) {}
+
+    [[nodiscard]] unsigned long size() const { return length; }
+    [[nodiscard]] bool empty() const { return 0 == length; }
+    [[nodiscard]] unsigned long wordCount() const { return (length + word_size - 1) / word_size; }
+    [[nodiscard]] const word* data() const { return words; }
+
+    bool operator[](unsigned long idx) const {
+        return (words[idx / word_size] >> (word_size - 1 - idx % word_size)) & 1;
+    }
+
+    /**
+     * Returns the value of the bits interpreted as unsigned integer (first bit = most significant bit).
+     * Only valid for bit strings with at most 64 bits.
+     */
+    [[nodiscard]] uint64_t toInt() const {
+        return 0 == length ? 0 : words[0] >> (word_size - length);
+    }
+
+    /**
+     * Writes one byte per bit (zero + bit, e.g. 0/1 or '0'/'1') to the buffer, which must hold size() bytes.
+     */
+    void unpack(unsigned char* out, unsigned char zero = 0) const {
+
+        unsigned long idx = 0;
+        for(unsigned long i = 0; idx < length; i++){
+            auto value = words[i];
+            auto n = std::min<unsigned long>(word_size, length - idx);
+            for(unsigned long j = 0; j < n; j++){
+                out[idx + j] = (unsigned char) (zero + ((value >> (word_size - 1 - j)) & 1));
+            }
+            idx += n;
+        }
+    }
+
+    [[nodiscard]] std::vector<bool> toVector() const {
+
+        std::vector<bool> ret(length);
+        for(unsigned long i = 0; i < length; i++){
+            ret[i] = (*this)[i];
+        }
+
+        return ret;
+    }
+
+private:
+
+    const word* words;
+    unsigned long length;
+};
+
+class packed_bits {
+
+public:
+
+    typedef uint64_t word;
+    static constexpr unsigned long word_size = 64;
+    static constexpr unsigned long inline_words = 2;     // words stored without heap memory
+
+    // proxy for a single bit
+    //-------------------------------
+    class reference {
+
+    private:
+        word* ptr;
+        word mask;
+
+    public:
+        reference(word* ptr, word mask) : ptr(ptr), mask(mask) {}
+
+        operator bool() const { return (*ptr & mask) != 0; }
+
+        reference& operator=(bool value){
+            if(value){ *ptr |= mask; } else { *ptr &= ~mask; }
+            return *this;
+        }
+
+        reference& operator=(const reference& other){
+            return *this = (bool) other;
+        }
+    };
+    //-------------------------------
+
+    // iterators
+    //-------------------------------
+    template<bool is_const>
+    class basic_iterator {
+
+        friend class packed_bits;
+
+    private:
+        typedef typename std::conditional<is_const, const packed_bits, packed_bits>::type owner_type;
+
+        owner_type* owner;
+        unsigned long pos;
+
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef bool value_type;
+        typedef long difference_type;
+        typedef void pointer;
+        typedef typename std::conditional<is_const, bool, packed_bits::reference>::type reference;
+
+        basic_iterator() : owner(nullptr), pos(0) {}
+        basic_iterator(owner_type* owner, unsigned long pos) : owner(owner), pos(pos) {}
+
+        // iterator => const_iterator
+        operator basic_iterator<true>() const { return {owner, pos}; }
+
+        reference operator*() const { return (*owner)[pos]; }
+        reference operator[](difference_type off) const { return (*owner)[pos + off]; }
+
+        basic_iterator& operator++(){ pos++; return *this; }
+        basic_iterator& operator--(){ pos--; return *this; }
+        basic_iterator operator++(int){ auto tmp = *this; pos++; return tmp; }
+        basic_iterator operator--(int){ auto tmp = *this; pos--; return tmp; }
+        basic_iterator& operator+=(difference_type off){ pos += off; return *this; }
+        basic_iterator& operator-=(difference_type off){ pos -= off; return *this; }
+        basic_iterator operator+(difference_type off) const { return basic_iterator(owner, pos + off); }
+        basic_iterator operator-(difference_type off) const { return basic_iterator(owner, pos - off); }
+        difference_type operator-(const basic_iterator& other) const { return (difference_type) pos - (difference_type) other.pos; }
+
+        bool operator==(const basic_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const basic_iterator& other) const { return pos != other.pos; }
+        bool operator<(const basic_iterator& other) const { return pos < other.pos; }
+    };
+
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+    //-------------------------------
+
+
+    // constructors
+    //-------------------------------
+    packed_bits() : length(0) {}
+
+    explicit packed_bits(unsigned long size, bool value = false) : length(0) {
+        resize(size, value);
+    }
+
+    packed_bits(std::initializer_list<bool> bits) : length(0) {
+        reserve(bits.size());
+        for(bool bit : bits){
+            push_back(bit);
+        }
+    }
+
+    explicit packed_bits(const std::vector<bool>& bits) : length(0) {
+        reserve(bits.size());
+        for(bool bit : bits){
+            push_back(bit);
+        }
+    }
+    //-------------------------------
+
+
+    // element access
+    //-------------------------------
+    bool operator[](unsigned long idx) const {
+        return (words[idx / word_size] >> (word_size - 1 - idx % word_size)) & 1;
+    }
+
+    reference operator[](unsigned long idx){
+        return {&words[idx / word_size], bitMask(idx)};
+    }
+
+    [[nodiscard]] bool back() const { return (*this)[length - 1]; }
+    reference back(){ return (*this)[length - 1]; }
+
+    iterator begin(){ return {this, 0}; }
+    iterator end(){ return {this, length}; }
+    [[nodiscard]] const_iterator begin() const { return {this, 0}; }
+    [[nodiscard]] const_iterator end() const { return {this, length}; }
+    //-------------------------------
+
+
+    // capacity
+    //-------------------------------
+    [[nodiscard]] unsigned long size() const { return length; }
+    [[nodiscard]] bool empty() const { return 0 == length; }
+
+    void reserve(unsigned long size){
+        words.reserve(wordsFor(size));
+    }
+    //-------------------------------
+
+
+    // modifiers
+    //-------------------------------
+    void clear(){
+        words.clear();
+        length = 0;
+    }
+
+    void push_back(bool value){
+        if(0 == length % word_size){
+            words.push_back(0);
+        }
+        if(value){
+            words[length / word_size] |= bitMask(length);
+        }
+        length++;
+    }
+
+    void pop_back(){
+        length--;
+        words[length / word_size] &= ~bitMask(length);
+        if(0 == length % word_size){
+            words.pop_back();
+        }
+    }
+
+    void resize(unsigned long new_length, bool value = false){
+
+        if(new_length < length){
+            length = new_length;
+            words.resize(wordsFor(length));
+            clearTail();
+            return;
+        }
+
+        words.resize(wordsFor(new_length), 0);
+        if(value){
+            fill(length, new_length, true);
+        }
+        length = new_length;
+    }
+
+    iterator insert(const_iterator position, bool value){
+        return insert(position, 1, value);
+    }
+
+    iterator insert(const_iterator position, unsigned long count, bool value){
+
+        auto pos = position.pos;
+        if(0 == count){
+            return {this, pos};
+        }
+
+        words.resize(wordsFor(length + count), 0);
+        shiftTailRight(pos, length, count);
+        length += count;
+        fill(pos, pos + count, value);
+
+        return {this, pos};
+    }
+
+    iterator insert(const_iterator position, std::initializer_list<bool> bits){
+
+        auto pos = position.pos;
+        insert(position, bits.size(), false);
+
+        auto idx = pos;
+        for(bool bit : bits){
+            if(bit){
+                words[idx / word_size] |= bitMask(idx);
+            }
+            idx++;
+        }
+
+        return {this, pos};
+    }
+
+    iterator erase(const_iterator position){
+        return erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last){
+
+        auto pos = first.pos;
+        auto count = last.pos - first.pos;
+        if(0 == count){
+            return {this, pos};
+        }
+
+        shiftTailLeft(pos, count);
+        length -= count;
+        words.resize(wordsFor(length));
+        clearTail();
+
+        return {this, pos};
+    }
+    //-------------------------------
+
+
+    // word access
+    //-------------------------------
+    [[nodiscard]] unsigned long wordCount() const { return words.size(); }
+    [[nodiscard]] bool isInline() const { return words.isInline(); }
+    [[nodiscard]] const word* data() const { return words.data(); }
+    word* data(){ return words.data(); }
+
+    /**
+     * Returns the value of the bit string interpreted as unsigned integer (first bit = most significant bit).
+     * Only valid for bit strings with at most 64 bits.
+     */
+    [[nodiscard]] uint64_t toInt() const {
+        return 0 == length ? 0 : words[0] >> (word_size - length);
+    }
+
+    /**
+     * Sets the bit string (keeping its size) to the lowest bits of value.
+     * Only valid for bit strings with at most 64 bits.
+     */
+    void fromInt(uint64_t value){
+        if(0 != length){
+            words[0] = value << (word_size - length);
+        }
+    }
+
+    /**
+     * Returns true if all bits are set. An empty bit string returns true.
+     */
+    [[nodiscard]] bool allSet() const {
+
+        if(0 == length){
+            return true;
+        }
+
+        auto full = length / word_size;
+        for(unsigned long i = 0; i < full; i++){
+            if(~words[i]){
+                return false;
+            }
+        }
+
+        auto rest = length % word_size;
+        return 0 == rest || words[full] == highMask(rest);
+    }
+
+    /**
+     * Returns true if no bit is set. An empty bit string returns true.
+     */
+    [[nodiscard]] bool noneSet() const {
+
+        for(auto w : words){
+            if(w){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Returns the number of leading zero bits (the size if no bit is set).
+     */
+    [[nodiscard]] unsigned long leadingZeros() const {
+
+        for(unsigned long i = 0; i < words.size(); i++){
+            if(words[i]){
+                return i * word_size + __builtin_clzll(words[i]);
+            }
+        }
+
+        return length;
+    }
+
+    /**
+     * Returns the position of the first bit that differs from the other bit string of the same size (the size if
+     * both are equal). Both strings are compared word by word.
+     */
+    [[nodiscard]] unsigned long mismatch(const packed_bits& other) const {
+
+        for(unsigned long i = 0; i < words.size(); i++){
+            auto diff = words[i] ^ other.words[i];
+            if(diff){
+                return i * word_size + __builtin_clzll(diff);
+            }
+        }
+
+        return length;
+    }
+
+    /**
+     * Returns |a - b| of two bit strings of the same size interpreted as unsigned integers. The subtraction runs word
+     * by word on the left aligned words (the unused low bits of the last word are zero in both strings).
+     */
+    static packed_bits absoluteDifference(const packed_bits& a, const packed_bits& b){
+
+        auto pos = a.mismatch(b);
+        const auto& larger = (pos < a.length && a[pos]) ? a : b;
+        const auto& smaller = (&larger == &a) ? b : a;
+
+        packed_bits ret(a.length);
+        word borrow = 0;
+        for(auto i = ret.words.size(); i > 0;){
+            i--;
+            auto x = larger.words[i], y = smaller.words[i];
+            ret.words[i] = x - y - borrow;
+            borrow = (x < y) || (x - y < borrow);
+        }
+
+        return ret;
+    }
+
+    bool operator==(const packed_bits& other) const {
+        return length == other.length && words == other.words;
+    }
+
+    bool operator!=(const packed_bits& other) const {
+        return !(*this == other);
+    }
+
+    [[nodiscard]] bits_view view() const { return {words.data(), length}; }
+
+    [[nodiscard]] std::vector<bool> toVector() const {
+        return view().toVector();
+    }
+    //-------------------------------
+
+
+private:
+
+    inline_vector<word, inline_words> words;
+    unsigned long length;
+
+    static unsigned long wordsFor(unsigned long bits){
+        return (bits + word_size - 1) / word_size;
+    }
+
+    static word bitMask(unsigned long idx){
+        return ((word) 1) << (word_size - 1 - idx % word_size);
+    }
+
+    // mask with the highest n bits set (n <= 64)
+    static word highMask(unsigned long n){
+        return n >= word_size ? ~((word) 0) : ~(~((word) 0) >> n);
+    }
+
+    // clears the unused bits of the last word
+    void clearTail(){
+        auto rest = length % word_size;
+        if(0 != rest){
+            words.back() &= highMask(rest);
+        }
+    }
+
+    // sets the bits in [first, last) to value
+    void fill(unsigned long first, unsigned long last, bool value){
+
+        while(first < last){
+            auto idx = first / word_size;
+            auto off = first % word_size;
+            auto n = std::min<unsigned long>(word_size - off, last - first);
+            word mask = highMask(n) >> off;
+
+            if(value){ words[idx] |= mask; } else { words[idx] &= ~mask; }
+            first += n;
+        }
+    }
+
+    // moves the bits [pos, end) by count positions to the right. The word array must already be large enough.
+    void shiftTailRight(unsigned long pos, unsigned long end, unsigned long count){
+
+        auto first_word = pos / word_size;
+        auto off = pos % word_size;
+        word head = words[first_word] & highMask(off);
+        words[first_word] &= ~highMask(off);
+
+        auto word_shift = count / word_size;
+        auto bit_shift = count % word_size;
+        auto last_word = wordsFor(end + count);
+
+        for(auto i = last_word; i > first_word;){
+            i--;
+
+            word value = 0;
+            if(i >= first_word + word_shift){
+                auto src = i - word_shift;
+                value = bit_shift ? words[src] >> bit_shift : words[src];
+                if(bit_shift && src > first_word){
+                    value |= words[src - 1] << (word_size - bit_shift);
+                }
+            }
+            words[i] = value;
+        }
+
+        words[first_word] |= head;
+    }
+
+    // moves the bits [pos + count, length) by count positions to the left (overwriting [pos, pos + count)).
+    void shiftTailLeft(unsigned long pos, unsigned long count){
+
+        auto first_word = pos / word_size;
+        auto off = pos % word_size;
+        word head = words[first_word] & highMask(off);
+
+        auto word_shift = count / word_size;
+        auto bit_shift = count % word_size;
+        auto last_word = words.size();
+
+        for(auto i = first_word; i < last_word; i++){
+
+            auto src = i + word_shift;
+            word value = 0;
+            if(src < last_word){
+                value = bit_shift ? words[src] << bit_shift : words[src];
+                if(bit_shift && src + 1 < last_word){
+                    value |= words[src + 1] >> (word_size - bit_shift);
+                }
+            }
+            words[i] = value;
+        }
+
+        // the bits in front of pos are not part of the shift
+        words[first_word] = (words[first_word] & ~highMask(off)) | head;
+    }
+};
+
+#endif //MPS_PACKED_BITS_H
@@ -0,0 +1,137 @@
+//
+// scratch_arena => per thread cache of heap blocks in size classes (powers of two).
+//
+// inline_vector takes its heap memory from here. A released block is kept by the releasing thread and handed out again
+// for the next request of the same size class, so the temporaries of the arithmetic kernels (long mantissas, limb
+// arrays) are not allocated again after the first operations of a thread. Every thread has its own free lists, so no
+// locks are needed. A block may be released by another thread than the one that allocated it.
+//
+// MPS_SCRATCH_BLOCKS sets the number of blocks per size class a thread keeps (0: every block is returned to the heap).
+//
+
+#ifndef MPS_SCRATCH_ARENA_H
+#define MPS_SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <new>
+
+#ifndef MPS_SCRATCH_BLOCKS
+#define MPS_SCRATCH_BLOCKS 32
+#endif
+
+class scratch_arena {
+
+public:
+
+    static constexpr std::size_t smallest_block = 64;      // bytes of size class 0
+    static constexpr unsigned long size_classes = 16;      // larger blocks (> 2 MiB) are not cached
+    static constexpr unsigned long cached_blocks = MPS_SCRATCH_BLOCKS;
+
+    /**
+     * Returns a block of at least the given number of bytes. The size is rounded up to the size class.
+     *
+     * @param bytes the requested size, set to the usable size of the block
+     * @return the block
+     */
+    static void* allocate(std::size_t& bytes){
+
+        auto size_class = sizeClass(bytes);
+        if(size_class >= size_classes){
+            state.heap_allocations++;
+            return ::operator new(bytes);
+        }
+
+        bytes = smallest_block << size_class;
+
+        auto block = state.free_blocks[size_class];
+        if(nullptr != block){
+            state.free_blocks[size_class] = block->next;
+            state.free_counts[size_class]--;
+            return block;
+        }
+
+        state.heap_allocations++;
+        guard.touch();
+        return ::operator new(bytes);
+    }
+
+    /**
+     * Releases a block returned by allocate (with the usable size set by allocate).
+     */
+    static void deallocate(void* block, std::size_t bytes){
+
+        auto size_class = sizeClass(bytes);
+        if(size_class >= size_classes || state.finished || state.free_counts[size_class] >= cached_blocks){
+            ::operator delete(block);
+            return;
+        }
+
+        guard.touch();
+        auto free_block = static_cast<node*>(block);
+        free_block->next = state.free_blocks[size_class];
+        state.free_blocks[size_class] = free_block;
+        state.free_counts[size_class]++;
+    }
+
+    /**
+     * Returns the number of blocks the calling thread allocated on the heap (the blocks taken from the cache are not
+     * counted).
+     */
+    [[nodiscard]] static unsigned long long heapAllocations(){
+        return state.heap_allocations;
+    }
+
+    /**
+     * Returns the cached blocks of the calling thread to the heap.
+     */
+    static void trim(){
+
+        for(unsigned long i = 0; i < size_classes; i++){
+            while(nullptr != state.free_blocks[i]){
+                auto block = state.free_blocks[i];
+                state.free_blocks[i] = block->next;
+                ::operator delete(block);
+            }
+            state.free_counts[i] = 0;
+        }
+    }
+
+
+private:
+
+    struct node {
+        node* next;
+    };
+
+    // trivially destructible, so it can still be used while the other thread local objects are destroyed
+    struct thread_state {
+        node* free_blocks[size_classes];
+        unsigned long free_counts[size_classes];
+        unsigned long long heap_allocations;
+        bool finished;
+    };
+
+    // returns the cached blocks to the heap when the thread finishes
+    struct thread_guard {
+        void touch(){}
+        ~thread_guard(){
+            trim();
+            state.finished = true;
+        }
+    };
+
+    static inline thread_local thread_state state{};
+    static inline thread_local thread_guard guard;
+
+    static unsigned long sizeClass(std::size_t bytes){
+
+        unsigned long ret = 0;
+        while((smallest_block << ret) < bytes && ret < size_classes){
+            ret++;
+        }
+
+        return ret;
+    }
+};
+
+#endif //MPS_SCRATCH_ARENA_H
@@ -8,18 +8,114 @@
 #include <pybind11/operators.h>
 
 #include "./mps/mps.h"
+#include "./mps/mps_t.h"
+
+#include <vector>
 
 namespace py = pybind11;
 
 
+/**
+ * Copy of the packed words of a field (mantissa_view, exponent_view). A bits_view is only valid until the mps object
+ * changes; fields with more than 128 bits live on the heap, and the arithmetic (e.g. add_product or an assignment) may
+ * move them. A Python object can outlive such changes, so it holds its own words.
+ */
+struct bits_snapshot {
+
+    std::vector<bits_view::word> words;
+    unsigned long length;
+
+    explicit bits_snapshot(const bits_view& view)
+            : words(view.data(), view.data() + view.wordCount()), length(view.size()) {}
+
+    [[nodiscard]] bits_view view() const { return {words.data(), length}; }
+};
+
+
+/**
+ * Binds a format that is fixed at compile time (mps_t) under the given name.
+ */
+template<typename T>
+void bind_static_format(py::module_& handle, const char* name){
+
+    py::class_<T>(handle, name)
+            .def(py::init<double>())
+            .def(py::init<const mps&>())
+            .def(py::init<>())
+
+            .def(py::self + py::self)
+            .def(py::self - py::self)
+            .def(py::self * py::self)
+            .def(py::self / py::self)
+            .def(py::self += py::self)
+            .def(py::self -= py::self)
+            .def(py::self *= py::self)
+            .def(py::self /= py::self)
+            .def(py::self < py::self)
+            .def(py::self <= py::self)
+            .def(py::self > py::self)
+            .def(py::self >= py::self)
+            .def(py::self == py::self)
+            .def(py::self != py::self)
+
+            .def_property_readonly_static("mantissa_length", [](const py::object&){ return T::mantissa_length; })
+            .def_property_readonly_static("exponent_length", [](const py::object&){ return T::exponent_length; })
+
+            .def("is_zero", &T::isZero)
+            .def("is_infinity", &T::isInf)
+            .def("is_positive", &T::isPositive)
+            .def("is_NaN", &T::isNaN)
+
+            .def("to_mps", &T::toMps)
+            .def("get_value", &T::getValue)
+            .def("print", &T::print)
+            .def("to_string", &T::toString)
+            ;
+
+    py::implicitly_convertible<T, mps>();
+}
+
+
 PYBIND11_MODULE(mps_lib, mps_handle) {
     mps_handle.doc() = "Framework for mixed precision floating point simulation.";
 
+    py::enum_<mps::engine>(mps_handle, "engine")
+            .value("reference", mps::engine::reference)
+            .value("packed", mps::engine::packed)
+            .value("native", mps::engine::native)
+            .value("sliced", mps::engine::sliced)
+            .value("analytic", mps::engine::analytic)
+            ;
+
+    // packed words of a field (buffer protocol: read only array of uint64 without a further copy)
+    py::class_<bits_snapshot>(mps_handle, "bits", py::buffer_protocol())
+            .def_buffer([](const bits_snapshot& self){
+                return py::buffer_info(const_cast<bits_view::word*>(self.words.data()), sizeof(bits_view::word),
+                                       py::format_descriptor<bits_view::word>::format(), 1,
+                                       {(py::ssize_t) self.words.size()}, {(py::ssize_t) sizeof(bits_view::word)}, true);
+            })
+            .def("__len__", [](const bits_snapshot& self){ return self.length; })
+            .def("__getitem__", [](const bits_snapshot& self, unsigned long idx){
+                if(idx >= self.length){
+                    throw py::index_error();
+                }
+                return self.view()[idx];
+            })
+            .def_property_readonly("word_count", [](const bits_snapshot& self){ return self.words.size(); })
+            ;
+
     py::class_<mps>(mps_handle, "mps")
             .def(py::init<unsigned long, unsigned long, double>())
             .def(py::init<unsigned long, unsigned long>())
             .def(py::init<>())
 
+            .def_static("set_engine", &mps::setEngine)
+            .def_static("get_engine", &mps::getEngine)
+            .def_static("set_karatsuba_threshold", &mps::setKaratsubaThreshold)
+            .def_static("get_karatsuba_threshold", &mps::getKaratsubaThreshold)
+            .def_static("set_newton_threshold", &mps::setNewtonThreshold)
+            .def_static("get_newton_threshold", &mps::getNewtonThreshold)
+
             .def("copy", [](mps &self){
                 const mps& out = self;
                 return out;
@@ -28,6 +124,10 @@ PYBIND11_MODULE(mps_lib, mps_handle) {
             .def(py::self - py::self)
             .def(py::self * py::self)
             .def(py::self / py::self)
+            .def(py::self += py::self)
+            .def(py::self -= py::self)
+            .def(py::self *= py::self)
+            .def(py::self /= py::self)
             .def(py::self < py::self)
             .def(py::self <= py::self)
             .def(py::self > py::self)
@@ -35,13 +135,42 @@ PYBIND11_MODULE(mps_lib, mps_handle) {
             .def(py::self == py::self)
             .def(py::self != py::self)
 
+            .def_static("from_array", [](const py::array_t<double, py::array::c_style | py::array::forcecast>& values, unsigned long mantissa_length, unsigned long exponent_length){
+                vector<mps> out(values.size());
+                mps::fromDoubles(values.data(), values.size(), out.data(), mantissa_length, exponent_length);
+                return out;
+            })
+            .def_static("to_array", [](const vector<mps>& values){
+                py::array_t<double> out(values.size());
+                mps::toDoubles(values.data(), values.size(), out.mutable_data());
+                return out;
+            })
+            .def_static("to_bit_arrays", [](const vector<mps>& values){
+                auto length = values.empty() ? 0 : values[0].getBitArrayLength();
+                py::array_t<uint8_t> out({(py::ssize_t) values.size(), (py::ssize_t) length});
+                mps::toBitArrays(values.data(), values.size(), out.mutable_data());
+                return out;
+            })
+
+            .def_static("fma", py::overload_cast<const mps&, const mps&, const mps&>(&mps::fma))
+            .def_static("fma", py::overload_cast<const mps&, const mps&, const mps&, unsigned long, unsigned long>(&mps::fma))
+            .def_static("add", &mps::add)
+            .def_static("subtract", &mps::subtract)
+            .def_static("multiply", &mps::multiply)
+            .def_static("divide", &mps::divide)
+            .def("add_product", &mps::addProduct, py::return_value_policy::reference)
+            .def("subtract_product", &mps::subtractProduct, py::return_value_policy::reference)
+
             .def_property_readonly("mantissa_length", &mps::getMantisseLength)
             .def_property_readonly("exponent_length", &mps::getExponentLength)
             .def_property_readonly("bit_array_length", &mps::getBitArrayLength)
             .def_property_readonly("bit_array", [](mps &self){
-                py::array out = py::cast(self.getBitArray());
+                py::array_t<bool> out(self.getBitArrayLength());
+                self.getBitArray(reinterpret_cast<unsigned char*>(out.mutable_data()));
                 return out;
             })
+            .def_property_readonly("mantissa_view", [](const mps& self){ return bits_snapshot(self.getMantissaView()); })
+            .def_property_readonly("exponent_view", [](const mps& self){ return bits_snapshot(self.getExponentView()); })
 
             .def("is_zero", &mps::isZero)
             .def("is_infinity", &mps::isInf)
@@ -61,4 +190,8 @@ PYBIND11_MODULE(mps_lib, mps_handle) {
             .def("print", &mps::print)
             .def("to_string", &mps::toString)
             ;
+
+    bind_static_format<mps_binary16>(mps_handle, "binary16");
+    bind_static_format<mps_binary32>(mps_handle, "binary32");
+    bind_static_format<mps_binary64>(mps_handle, "binary64");
 }
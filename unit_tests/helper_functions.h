@@ -5,7 +5,12 @@
 #ifndef HELPER_FUNCTIONS_H
 #define HELPER_FUNCTIONS_H
 
+#include "mps.h"
+
 #include <bitset>
+#include <random>
+#include <string>
+#include <vector>
 
 inline std::string is_mps(const std::vector<bool>& vec){
 
@@ -34,5 +39,81 @@ inline std::string should_value(T fp_number){
     return  compare_str;
 }
 
+/**
+ * Creates an mps object from the lowest bits of a pattern (sign, exponent, mantissa).
+ */
+inline mps from_pattern(unsigned long m, unsigned long e, unsigned long long pattern){
+
+    mps ret(m, e);
+
+    std::vector<bool> mantissa(m);
+    for(unsigned long i = 0; i < m; i++){
+        mantissa[m-1-i] = (pattern >> i) & 1;
+    }
+    std::vector<bool> exponent(e);
+    for(unsigned long i = 0; i < e; i++){
+        exponent[e-1-i] = (pattern >> (m+i)) & 1;
+    }
+
+    ret.setMantissa(mantissa);
+    ret.setExponent(exponent);
+    ret.setSign((pattern >> (m+e)) & 1);
+
+    return ret;
+}
+
+/**
+ * Creates an mps object with a random sign and mantissa and the given biased exponent.
+ */
+inline mps random_mps(unsigned long m, unsigned long e, unsigned long long exponent, std::mt19937_64& mt){
+
+    mps ret(m, e);
+
+    std::vector<bool> mantissa(m);
+    for(auto && bit : mantissa){
+        bit = mt() & 1;
+    }
+    std::vector<bool> exponent_bits(e);
+    for(unsigned long i = 0; i < e; i++){
+        exponent_bits[e-1-i] = (exponent >> i) & 1;
+    }
+
+    ret.setMantissa(mantissa);
+    ret.setExponent(exponent_bits);
+    ret.setSign(mt() & 1);
+
+    return ret;
+}
+
+/**
+ * Creates an mps object with random bits.
+ * If close is set, the exponent is chosen close to the bias, so the exponents of two numbers overlap.
+ */
+inline mps from_random(unsigned long m, unsigned long e, std::mt19937_64& mt, bool close){
+
+    mps ret(m, e);
+
+    std::vector<bool> mantissa(m);
+    for(auto && bit : mantissa){
+        bit = mt() & 1;
+    }
+    std::vector<bool> exponent(e);
+    for(auto && bit : exponent){
+        bit = mt() & 1;
+    }
+    if(close){
+        auto value = (1ULL << (e-1)) - 1 + mt() % (2*m + 4) - (m + 2);
+        for(unsigned long i = 0; i < e; i++){
+            exponent[e-1-i] = (value >> i) & 1;
+        }
+    }
+
+    ret.setMantissa(mantissa);
+    ret.setExponent(exponent);
+    ret.setSign(mt() & 1);
+
+    return ret;
+}
+
 
 #endif // HELPER_FUNCTIONS_H
@@ -6,6 +6,11 @@
 
 #include "ira.h"
 #include "helper_functions.h"
+#include "task_graph.h"
+
+#include <random>
+#include <sstream>
+#include <atomic>
 
 
 TEST(PLU, exception_mantissa_too_small) {
@@ -1248,6 +1253,385 @@ TEST(solve_LU_double, simple_3x3_2){
     }
 }
 
+TEST(solve_LU, fused_multiply_add_double){
+
+    unsigned long n = 6;
+
+    std::mt19937_64 mt(5);
+    std::uniform_real_distribution<double> distribution(-10, 10);
+
+    vector<double> new_A(n * n);
+    vector<double> b(n);
+    for(auto& value : new_A){
+        value = distribution(mt);
+    }
+    for(auto& value : b){
+        value = distribution(mt);
+    }
+
+    ira IRA(n, 52, 11);
+    IRA.setMatrix(new_A);
+    IRA.setFusedMultiplyAdd(true);
+    EXPECT_TRUE(IRA.getFusedMultiplyAdd());
+
+    auto x_result = ira::mps_to_double(IRA.directPLU(ira::double_to_mps(52, 11, b)));
+
+
+    // the same algorithm with the hardware fma
+    //--------------------------------
+    vector<vector<double>> L(n, vector<double>(n, 0.0));
+    vector<vector<double>> U(n, vector<double>(n));
+    vector<unsigned long> P(n);
+    for(unsigned long i = 0; i < n; i++){
+        P[i] = i;
+        L[i][i] = 1.0;
+        for(unsigned long j = 0; j < n; j++){
+            U[i][j] = new_A[i * n + j];
+        }
+    }
+
+    for(unsigned long k = 0; k < n; k++){
+
+        auto max_row = k;
+        for(unsigned long i = k; i < n; i++){
+            if(std::abs(U[i][k]) > std::abs(U[max_row][k])){
+                max_row = i;
+            }
+        }
+        std::swap_ranges(U[k].begin() + (long) k, U[k].end(), U[max_row].begin() + (long) k);
+        std::swap_ranges(L[k].begin(), L[k].begin() + (long) k, L[max_row].begin());
+        std::swap(P[k], P[max_row]);
+
+        for(unsigned long j = k+1; j < n; j++){
+            L[j][k] = U[j][k] / U[k][k];
+            for(unsigned long i = k; i < n; i++){
+                U[j][i] = std::fma(-L[j][k], U[k][i], U[j][i]);
+            }
+        }
+    }
+
+    vector<double> y(n);
+    for(unsigned long i = 0; i < n; i++){
+        double sum = 0;
+        for(unsigned long j = 0; j < i; j++){
+            sum = std::fma(L[i][j], y[j], sum);
+        }
+        y[i] = (b[P[i]] - sum) / L[i][i];
+    }
+
+    vector<double> x_should(n);
+    for(unsigned long i = n; i > 0;){
+        i--;
+        double sum = 0;
+        for(unsigned long j = n-1; j > i; j--){
+            sum = std::fma(U[i][j], x_should[j], sum);
+        }
+        x_should[i] = (y[i] - sum) / U[i][i];
+    }
+    //--------------------------------
+
+    for(unsigned long i = 0; i < n; i++){
+        EXPECT_EQ(should_value(x_should[i]), should_value(x_result[i]));
+    }
+}
+
+TEST(PLU, in_place){
+
+    unsigned long n = 8;
+
+    std::mt19937_64 mt(7);
+    std::uniform_real_distribution<double> distribution(-10, 10);
+
+    vector<double> new_A(n * n);
+    vector<double> b(n);
+    for(auto& value : new_A){
+        value = distribution(mt);
+    }
+    for(auto& value : b){
+        value = distribution(mt);
+    }
+
+    for(bool fused : {false, true}){
+
+        ira separate(n, 52, 11);
+        separate.setMatrix(new_A);
+        separate.setFusedMultiplyAdd(fused);
+        separate.setLowerPrecision(23, 8);
+        separate.setWorkingPrecision(30, 9);
+        separate.setMaxIter(3);
+
+        ira combined(n, 52, 11);
+        combined.setMatrix(new_A);
+        combined.setFusedMultiplyAdd(fused);
+        combined.setLowerPrecision(23, 8);
+        combined.setWorkingPrecision(30, 9);
+        combined.setMaxIter(3);
+        EXPECT_FALSE(combined.getInPlaceLU());
+        combined.setInPlaceLU(true);
+        EXPECT_TRUE(combined.getInPlaceLU());
+
+        separate.decompPLU(23, 8);
+        combined.decompPLU(23, 8);
+
+        EXPECT_EQ(separate.toString('L', 6), combined.toString('L', 6));
+        EXPECT_EQ(separate.toString('P', 0), combined.toString('P', 0));
+
+        // the upper triangles of U are the same (below the diagonal, only the separate U keeps the residuals)
+        std::stringstream separate_U(separate.toString('U', 10));
+        std::stringstream combined_U(combined.toString('U', 10));
+        std::string separate_value;
+        std::string combined_value;
+        for(unsigned long idx = 0; idx < n * n; idx++){
+            std::getline(separate_U, separate_value, ',');
+            std::getline(combined_U, combined_value, ',');
+            if(idx % n >= idx / n){
+                EXPECT_EQ(separate_value, combined_value);
+            }
+        }
+
+        auto b_mps = ira::double_to_mps(23, 8, b);
+        auto y_separate = separate.forwardSubstitution(b_mps);
+        auto y_combined = combined.forwardSubstitution(b_mps);
+        for(unsigned long i = 0; i < n; i++){
+            EXPECT_EQ(y_separate[i].print(), y_combined[i].print());
+        }
+        auto x_separate = separate.backwardSubstitution(y_separate);
+        auto x_combined = combined.backwardSubstitution(y_combined);
+        for(unsigned long i = 0; i < n; i++){
+            EXPECT_EQ(x_separate[i].print(), x_combined[i].print());
+        }
+
+        auto b_ur = ira::double_to_mps(52, 11, b);
+        auto ir_separate = separate.irPLU(b_ur);
+        auto ir_combined = combined.irPLU(b_ur);
+        for(unsigned long i = 0; i < n; i++){
+            EXPECT_EQ(ir_separate[i].print(), ir_combined[i].print());
+        }
+    }
+}
+
+TEST(PLU, in_place_split){
+
+    vector<double> new_matrix{ 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    ira IRA(3, 23, 8);
+    IRA.setMatrix(new_matrix);
+    IRA.setInPlaceLU(true);
+    IRA.decompPLU(23, 8);
+
+    EXPECT_EQ(IRA.toString('L', 2), "1.00, 0.00, 0.00, 0.14, 1.00, 0.00, 0.57, 0.50, 1.00");
+    EXPECT_EQ(IRA.toString('U', 2), "7.00, 8.00, 9.00, 0.00, 0.86, 1.71, 0.00, 0.00, 0.00");
+    EXPECT_EQ(IRA.toString('P', 2), "0.00, 0.00, 1.00, 1.00, 0.00, 0.00, 0.00, 1.00, 0.00");
+
+    // setting U stores the factors separately again, L is kept
+    IRA.setU({1, 2, 3, 0, 4, 5, 0, 0, 6});
+    EXPECT_EQ(IRA.toString('L', 2), "1.00, 0.00, 0.00, 0.14, 1.00, 0.00, 0.57, 0.50, 1.00");
+    EXPECT_EQ(IRA.toString('U', 2), "1.00, 2.00, 3.00, 0.00, 4.00, 5.00, 0.00, 0.00, 6.00");
+}
+
+TEST(PLU, threads){
+
+    unsigned long n = 40;
+
+    std::mt19937_64 mt(3);
+    std::uniform_real_distribution<double> distribution(-10, 10);
+
+    vector<double> new_A(n * n);
+    vector<double> b(n);
+    for(auto& value : new_A){
+        value = distribution(mt);
+    }
+    for(auto& value : b){
+        value = distribution(mt);
+    }
+
+    auto solve = [&](unsigned long threads, bool in_place, bool fused){
+
+        ira IRA(n, 52, 11);
+        IRA.setMatrix(new_A);
+        IRA.setLowerPrecision(20, 8);
+        IRA.setWorkingPrecision(30, 9);
+        IRA.setMaxIter(2);
+        IRA.setInPlaceLU(in_place);
+        IRA.setFusedMultiplyAdd(fused);
+        IRA.setThreads(threads);
+        EXPECT_EQ(threads, IRA.getThreads());
+
+        auto x = IRA.irPLU(ira::double_to_mps(52, 11, b));
+
+        std::string ret = IRA.toString('L', 12) + IRA.toString('U', 12) + IRA.toString('P', 0);
+        for(const auto& value : x){
+            ret.append(value.print());
+        }
+        return ret;
+    };
+
+    for(bool in_place : {false, true}){
+        for(bool fused : {false, true}){
+            EXPECT_EQ(solve(1, in_place, fused), solve(4, in_place, fused));
+        }
+    }
+}
+
+namespace {
+
+    /**
+     * Solves a random system (seeded) with irPLU and returns the factors, the permutation and the solution as a string.
+     */
+    std::string solve_with_variant(ira::lu_variant variant, unsigned long block_size, unsigned long threads, bool in_place, bool fused, ira::lu_variant used){
+
+        unsigned long n = 40;
+
+        std::mt19937_64 mt(13);
+        std::uniform_real_distribution<double> distribution(-10, 10);
+
+        vector<double> new_A(n * n);
+        vector<double> b(n);
+        for(auto& value : new_A){
+            value = distribution(mt);
+        }
+        for(auto& value : b){
+            value = distribution(mt);
+        }
+
+        ira IRA(n, 52, 11);
+        IRA.setMatrix(new_A);
+        IRA.setLowerPrecision(20, 8);
+        IRA.setWorkingPrecision(30, 9);
+        IRA.setMaxIter(2);
+        IRA.setInPlaceLU(in_place);
+        IRA.setFusedMultiplyAdd(fused);
+        IRA.setThreads(threads);
+        IRA.setLUVariant(variant);
+        IRA.setBlockSize(block_size);
+        EXPECT_EQ(variant, IRA.getLUVariant());
+        EXPECT_EQ(block_size, IRA.getBlockSize());
+
+        auto x = IRA.irPLU(ira::double_to_mps(52, 11, b));
+        EXPECT_EQ(used, IRA.evaluation.lu_variant_used);
+
+        std::string ret = IRA.toString('L', 12) + IRA.toString('U', 12) + IRA.toString('P', 0);
+        for(const auto& value : x){
+            ret.append(value.print());
+        }
+        return ret;
+    }
+}
+
+TEST(PLU, blocked){
+
+    using variant = ira::lu_variant;
+
+    for(bool in_place : {false, true}){
+        for(bool fused : {false, true}){
+
+            auto expected = solve_with_variant(variant::unblocked, 32, 1, in_place, fused, variant::unblocked);
+
+            EXPECT_EQ(expected, solve_with_variant(variant::blocked, 1, 1, in_place, fused, variant::blocked));
+            EXPECT_EQ(expected, solve_with_variant(variant::blocked, 7, 1, in_place, fused, variant::blocked));
+            EXPECT_EQ(expected, solve_with_variant(variant::blocked, 16, 3, in_place, fused, variant::blocked));
+            EXPECT_EQ(expected, solve_with_variant(variant::blocked, 39, 1, in_place, fused, variant::blocked));
+
+            // a single panel is the unblocked decomposition
+            EXPECT_EQ(expected, solve_with_variant(variant::blocked, 40, 1, in_place, fused, variant::unblocked));
+        }
+    }
+
+    ira IRA(3, 52, 11);
+    EXPECT_ANY_THROW(IRA.setBlockSize(0));
+}
+
+TEST(PLU, tiled){
+
+    using variant = ira::lu_variant;
+
+    for(bool in_place : {false, true}){
+        for(bool fused : {false, true}){
+
+            auto expected = solve_with_variant(variant::unblocked, 32, 1, in_place, fused, variant::unblocked);
+
+            EXPECT_EQ(expected, solve_with_variant(variant::tiled, 1, 1, in_place, fused, variant::tiled));
+            EXPECT_EQ(expected, solve_with_variant(variant::tiled, 6, 1, in_place, fused, variant::tiled));
+            EXPECT_EQ(expected, solve_with_variant(variant::tiled, 6, 4, in_place, fused, variant::tiled));
+            EXPECT_EQ(expected, solve_with_variant(variant::tiled, 13, 3, in_place, fused, variant::tiled));
+            EXPECT_EQ(expected, solve_with_variant(variant::tiled, 40, 4, in_place, fused, variant::unblocked));
+        }
+    }
+}
+
+TEST(PLU, task_graph){
+
+    // a grid of tasks, every task waits for its left and upper neighbour
+    const unsigned long size = 12;
+
+    task_graph graph;
+    vector<std::atomic<unsigned long>> finished(size * size);
+    std::atomic<bool> order_kept{true};
+
+    for(unsigned long i = 0; i < size; i++){
+        for(unsigned long j = 0; j < size; j++){
+            auto task = graph.add([&, i, j](){
+                if((i > 0 && 0 == finished[(i-1) * size + j].load()) || (j > 0 && 0 == finished[i * size + j - 1].load())){
+                    order_kept = false;
+                }
+                finished[i * size + j] = 1;
+            }, i + j);
+            if(i > 0){
+                graph.depend(task, (i-1) * size + j);
+            }
+            if(j > 0){
+                graph.depend(task, i * size + j - 1);
+            }
+        }
+    }
+
+    graph.run(4);
+
+    EXPECT_TRUE(order_kept);
+    for(const auto& value : finished){
+        EXPECT_EQ(1, value.load());
+    }
+
+    // exceptions of a task are rethrown
+    task_graph failing;
+    auto first = failing.add([](){ throw std::invalid_argument("ERROR: in task"); });
+    auto second = failing.add([](){});
+    failing.depend(second, first);
+    EXPECT_ANY_THROW(failing.run(2));
+}
+
+TEST(PLU, permutation_low_precision){
+
+    // with a 3 bit mantissa only the indices up to 15 are representable, the permutation must still be exact
+    unsigned long n = 24;
+
+    vector<double> new_A(n * n, 0.0);
+    vector<mps> b;
+    for(unsigned long i = 0; i < n; i++){
+        new_A[i * n + (n-1-i)] = 1;
+        b.emplace_back(3, 5, (double) (i % 8));
+    }
+
+    ira IRA(n, 3, 5);
+    IRA.setMatrix(new_A);
+    auto x = IRA.directPLU(b);
+
+    std::string P_expected;
+    for(unsigned long i = 0; i < n; i++){
+        for(unsigned long j = 0; j < n; j++){
+            P_expected.append(j == n-1-i ? "1." : "0.");
+            if(i < n-1 || j < n-1){
+                P_expected.append(", ");
+            }
+        }
+    }
+    EXPECT_EQ(P_expected, IRA.toString('P', 0));
+
+    for(unsigned long i = 0; i < n; i++){
+        EXPECT_EQ((double) (i % 8), x[n-1-i].getValue());
+    }
+}
+
 TEST(solve_LU_double, simple_6x6_1){
 
     unsigned long u[2] = {52, 11};
@@ -109,6 +109,41 @@ TEST(add, exception_mantissa_not_same_size) {
     EXPECT_ANY_THROW(auto tmp = ira::add(first, second));
 }
 
+TEST(add, target_format) {
+
+    vector<double> a_d = {1.1, -2.25, 3.3};
+    vector<double> b_d = {0.1, 5.5, -1e-3};
+
+    auto a = ira::double_to_mps(52, 11, a_d);
+    auto b = ira::double_to_mps(10, 5, b_d);
+
+    // same as casting the vectors first
+    auto a_cast = a;
+    auto b_cast = b;
+    ira::cast(a_cast, 23, 8);
+    ira::cast(b_cast, 23, 8);
+
+    auto expected = ira::add(a_cast, b_cast);
+    auto result = ira::add(a, b, 23, 8);
+
+    for(unsigned long i = 0; i < a.size(); i++){
+        EXPECT_EQ(expected[i].print(), result[i].print());
+    }
+
+    // matrix vector product in the format of the matrix
+    vector<vector<mps>> D(3, a);
+    auto b_wide = b;
+    ira::cast(b_wide, 52, 11);
+
+    for(auto fused : {false, true}){
+        auto expected_product = ira::dotProduct(D, b_wide, fused);
+        auto product = ira::dotProduct(D, b, 52, 11, fused);
+        for(unsigned long i = 0; i < a.size(); i++){
+            EXPECT_EQ(expected_product[i].print(), product[i].print());
+        }
+    }
+}
+
 TEST(add, simple_1_float) {
 
     std::string should = "4.00, 4.00, 4.00, 4.00";
@@ -0,0 +1,529 @@
+//
+// Tests for the gate level operation counters (only with the CMake option MPS_COUNTERS).
+//
+
+#include "gtest/gtest.h"
+#include "helper_functions.h"
+
+#include "mps.h"
+#include "mps_counters.h"
+#include "mps_sliced.h"
+#include "ira.h"
+
+#include <thread>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+
+namespace {
+
+    /**
+     * Counts an operation with the reference and the analytic engine. Both the results and the counts must match.
+     */
+    void calibrate(const mps& a, const mps& b){
+
+        const std::function<std::string(const mps&, const mps&)> operations[] = {
+                [](const mps& x, const mps& y){ return (x + y).print(); },
+                [](const mps& x, const mps& y){ return (x - y).print(); },
+                [](const mps& x, const mps& y){ return (x * y).print(); },
+                [](const mps& x, const mps& y){ return (x / y).print(); },
+                [](const mps& x, const mps& y){ return std::to_string(x < y) + std::to_string(x == y); },
+                [](const mps& x, const mps& y){
+                    mps sum = x, difference = x, product = x, quotient = x;
+                    sum += y;
+                    difference -= y;
+                    product *= y;
+                    quotient /= y;
+                    return sum.print() + difference.print() + product.print() + quotient.print();
+                },
+        };
+
+        for(const auto& operation : operations){
+
+            mps::setEngine(mps::engine::reference);
+            auto start = mps_counters::read();
+            auto reference = operation(a, b);
+            auto reference_cost = mps_counters::read() - start;
+
+            mps::setEngine(mps::engine::analytic);
+            start = mps_counters::read();
+            auto analytic = operation(a, b);
+            auto analytic_cost = mps_counters::read() - start;
+
+            ASSERT_EQ(reference, analytic) << a.print() << " " << b.print();
+            ASSERT_EQ(reference_cost.full_adders, analytic_cost.full_adders) << a.print() << " " << b.print();
+            ASSERT_EQ(reference_cost.half_adders, analytic_cost.half_adders) << a.print() << " " << b.print();
+            ASSERT_EQ(reference_cost.shifts, analytic_cost.shifts) << a.print() << " " << b.print();
+            ASSERT_EQ(reference_cost.bit_comparisons, analytic_cost.bit_comparisons) << a.print() << " " << b.print();
+            ASSERT_EQ(reference_cost, analytic_cost);
+        }
+    }
+
+    /**
+     * Counts a fused multiply-add with the reference and the analytic engine. Both the results and the counts must
+     * match.
+     */
+    void calibrate_fma(const mps& a, const mps& b, const mps& c){
+
+        const std::function<std::string(const mps&, const mps&, const mps&)> operations[] = {
+                [](const mps& x, const mps& y, const mps& z){ return mps::fma(x, y, z).print(); },
+                [](const mps& x, const mps& y, const mps& z){ auto tmp = z; return tmp.subtractProduct(x, y).print(); },
+        };
+
+        for(const auto& operation : operations){
+
+            mps::setEngine(mps::engine::reference);
+            auto start = mps_counters::read();
+            auto reference = operation(a, b, c);
+            auto reference_cost = mps_counters::read() - start;
+
+            mps::setEngine(mps::engine::analytic);
+            start = mps_counters::read();
+            auto analytic = operation(a, b, c);
+            auto analytic_cost = mps_counters::read() - start;
+
+            auto info = a.print() + " " + b.print() + " " + c.print();
+            ASSERT_EQ(reference, analytic) << info;
+            ASSERT_EQ(reference_cost.full_adders, analytic_cost.full_adders) << info;
+            ASSERT_EQ(reference_cost.half_adders, analytic_cost.half_adders) << info;
+            ASSERT_EQ(reference_cost.shifts, analytic_cost.shifts) << info;
+            ASSERT_EQ(reference_cost.bit_comparisons, analytic_cost.bit_comparisons) << info;
+            ASSERT_EQ(reference_cost, analytic_cost);
+        }
+    }
+}
+
+
+TEST(counters, disabled){
+
+    if(mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    mps a(52, 11, 1.5);
+    mps b(52, 11, 2.25);
+    auto c = a * b + a;
+
+    EXPECT_EQ(mps_counters::snapshot{}, mps_counters::read());
+    EXPECT_EQ(4.875, c.getValue());
+}
+
+TEST(counters, deterministic){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+    mps::setEngine(mps::engine::reference);
+
+    mps a(23, 8, 1.2345);
+    mps b(23, 8, -6.789);
+
+    auto count = [&](){
+        auto start = mps_counters::read();
+        auto c = (a + b) * a / b - a;
+        return mps_counters::read() - start;
+    };
+
+    auto first = count();
+    auto second = count();
+
+    EXPECT_EQ(first, second);
+    EXPECT_LT(0, first.full_adders);
+    EXPECT_LT(0, first.half_adders);
+    EXPECT_LT(0, first.shifts);
+    EXPECT_LT(0, first.bit_comparisons);
+
+    // longer mantissas need more gates
+    mps x(52, 11, 1.2345);
+    mps y(52, 11, -6.789);
+    auto start = mps_counters::read();
+    auto z = (x + y) * x / y - x;
+    auto longer = mps_counters::read() - start;
+
+    EXPECT_LT(first.full_adders, longer.full_adders);
+
+    mps::setEngine(previous);
+}
+
+TEST(counters, operations){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    mps a(10, 5, 1.5);
+    mps b(10, 5, 3.0);
+    mps c(30, 8, 1.5);
+
+    auto start = mps_counters::read();
+    auto r = a + b;
+    r = r - a;
+    r *= b;
+    r = r * b;
+    r /= b;
+    r = mps::fma(a, b, r);
+    auto s = c + c;
+    auto delta = mps_counters::read() - start;
+
+    using op = mps_counters::operation;
+    EXPECT_EQ(1, delta.operationCount(op::addition, 10, 5));
+    EXPECT_EQ(1, delta.operationCount(op::subtraction, 10, 5));
+    EXPECT_EQ(2, delta.operationCount(op::multiplication, 10, 5));
+    EXPECT_EQ(1, delta.operationCount(op::division, 10, 5));
+    EXPECT_EQ(1, delta.operationCount(op::fma, 10, 5));
+    EXPECT_EQ(1, delta.operationCount(op::addition, 30, 8));
+    EXPECT_EQ(2, delta.operationCount(op::addition));
+    EXPECT_EQ(2u, delta.operations.size());
+
+    // the sliced engine counts every element
+    vector<mps> v(100, a);
+    start = mps_counters::read();
+    auto w = (mps_sliced(v) * mps_sliced(v)).toVector();
+    delta = mps_counters::read() - start;
+    EXPECT_EQ(100, delta.operationCount(op::multiplication, 10, 5));
+}
+
+TEST(counters, reset_and_threads){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    mps a(20, 6, 1.25);
+    auto r = a + a;
+
+    mps_counters::reset();
+    EXPECT_EQ(0, mps_counters::read().operationCount(mps_counters::operation::addition));
+
+    // counts of finished threads are kept
+    std::thread worker([&](){
+        for(int i = 0; i < 10; i++){
+            auto tmp = a + a;
+        }
+    });
+    worker.join();
+    r = a * a;
+
+    auto total = mps_counters::read();
+    EXPECT_EQ(10, total.operationCount(mps_counters::operation::addition, 20, 6));
+    EXPECT_EQ(1, total.operationCount(mps_counters::operation::multiplication, 20, 6));
+}
+
+TEST(counters, ira_phases){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    ira IRA(3, 52, 11);
+
+    vector<double> new_A{5, 1 ,3, 1, 1 ,1, 1, 2 ,1};
+    IRA.setMatrix(new_A);
+    IRA.setWorkingPrecision(30, 8);
+    IRA.setLowerPrecision(10, 5);
+    IRA.setUpperPrecision(52, 11);
+    IRA.setMaxIter(3);
+
+    vector<mps> b;
+    b.emplace_back(52, 11, 16);
+    b.emplace_back(52, 11, 6);
+    b.emplace_back(52, 11, 8);
+
+    auto x = IRA.irPLU_2(b);
+
+    using op = mps_counters::operation;
+    const auto& ul = IRA.evaluation.counters_ul;
+    const auto& u = IRA.evaluation.counters_u;
+    const auto& ur = IRA.evaluation.counters_ur;
+
+    EXPECT_LT(0, ul.operationCount(op::division, 10, 5));
+    EXPECT_EQ(ul.operationCount(op::division), ul.operationCount(op::division, 10, 5));
+    EXPECT_EQ(3 * 3, u.operationCount(op::addition, 30, 8));
+    EXPECT_EQ(u.operationCount(op::addition), u.operationCount(op::addition, 30, 8));
+    EXPECT_LT(0, ur.operationCount(op::multiplication, 52, 11) + ur.operationCount(op::fma, 52, 11));
+
+    auto phases = ul + u + ur;
+    EXPECT_LE(phases.operationCount(op::multiplication), IRA.evaluation.counters.operationCount(op::multiplication));
+    EXPECT_LE(phases.full_adders, IRA.evaluation.counters.full_adders);
+}
+
+TEST(counters, ira_threads){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    // the workers of the decomposition count into their own blocks, the sum is the same as with one thread
+    auto count = [](unsigned long threads){
+
+        ira IRA(40, 52, 11);
+        vector<double> A(40 * 40);
+        for(unsigned long i = 0; i < A.size(); i++){
+            A[i] = (double) ((i * 7) % 13) - 6.0 + (i % 41 == 0 ? 30.0 : 0.0);
+        }
+        IRA.setMatrix(A);
+        IRA.setThreads(threads);
+
+        auto start = mps_counters::read();
+        IRA.decompPLU(23, 8);
+        return mps_counters::read() - start;
+    };
+
+    auto serial = count(1);
+    EXPECT_LT(0, serial.operationCount(mps_counters::operation::division, 23, 8));
+    EXPECT_EQ(serial, count(4));
+}
+
+TEST(counters, compare_long_mantissa){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+    mps::setEngine(mps::engine::reference);
+
+    // the mantissas differ in bit 90, the bits up to it are compared
+    mps a(100, 11, 1.5);
+    mps b = a;
+    auto mantissa = b.getMantissa();
+    mantissa[90] = true;
+    b.setMantissa(mantissa);
+
+    auto start = mps_counters::read();
+    EXPECT_TRUE(a < b);
+    EXPECT_EQ(11 + 91, (mps_counters::read() - start).bit_comparisons);
+
+    start = mps_counters::read();
+    EXPECT_TRUE(a == a);
+    EXPECT_EQ(11 + 100, (mps_counters::read() - start).bit_comparisons);
+
+    mps::setEngine(mps::engine::packed);
+    start = mps_counters::read();
+    EXPECT_TRUE(b > a);
+    EXPECT_EQ(0, (mps_counters::read() - start).bit_comparisons);
+
+    mps::setEngine(previous);
+}
+
+TEST(counters, analytic_exhaustive){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+
+    for(auto format : {std::pair<unsigned long, unsigned long>{3, 3}, {1, 4}, {4, 3}}){
+        const unsigned long long values = 1ULL << (format.first + format.second + 1);
+        for(unsigned long long i = 0; i < values; i++){
+            for(unsigned long long j = 0; j < values; j++){
+                calibrate(from_pattern(format.first, format.second, i), from_pattern(format.first, format.second, j));
+                if(HasFatalFailure()){
+                    mps::setEngine(previous);
+                    return;
+                }
+            }
+        }
+    }
+
+    mps::setEngine(previous);
+}
+
+TEST(counters, analytic_random){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+    std::mt19937_64 mt(11);
+
+    for(auto format : {std::pair<unsigned long, unsigned long>{2, 3}, {7, 5}, {10, 8}, {23, 8}, {31, 9}, {52, 11}, {62, 11}, {40, 20}}){
+        for(int i = 0; i < 400; i++){
+
+            // random bits, the exponents of every second pair close to each other (alignment inside the mantissa)
+            auto a = mt(), b = mt();
+            if(i % 2){
+                b = (b & ~(0xfULL << (format.first + 2))) | (a & (~0ULL << (format.first + 6)));
+            }
+
+            calibrate(from_pattern(format.first, format.second, a), from_pattern(format.first, format.second, b));
+            if(HasFatalFailure()){
+                break;
+            }
+        }
+    }
+
+    // values like the ones of ira (many equal exponents, sums and differences with cancellation)
+    std::uniform_real_distribution<double> dis(-10, 10);
+    for(int i = 0; i < 2000 && !HasFatalFailure(); i++){
+        calibrate(mps(52, 11, dis(mt)), mps(52, 11, dis(mt)));
+    }
+
+    mps::setEngine(previous);
+}
+
+TEST(counters, analytic_fma){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+
+    // the bit level fma is counted
+    mps::setEngine(mps::engine::reference);
+    auto start = mps_counters::read();
+    auto tmp = mps::fma(mps(52, 11, 1.5), mps(52, 11, -2.25), mps(52, 11, 0.1));
+    auto cost = mps_counters::read() - start;
+    EXPECT_LT(0, cost.full_adders);
+    EXPECT_LT(0, cost.shifts);
+    EXPECT_EQ(1, cost.operationCount(mps_counters::operation::fma, 52, 11));
+
+    // all operands of a small format
+    const unsigned long long values = 1ULL << (2 + 3 + 1);
+    for(unsigned long long i = 0; i < values && !HasFatalFailure(); i++){
+        for(unsigned long long j = 0; j < values && !HasFatalFailure(); j++){
+            for(unsigned long long k = 0; k < values && !HasFatalFailure(); k += 3){
+                calibrate_fma(from_pattern(2, 3, i), from_pattern(2, 3, j), from_pattern(2, 3, k));
+            }
+        }
+    }
+
+    // random operands, the exponent of the summand mostly close to the one of the product
+    std::mt19937_64 mt(13);
+    for(auto format : {std::pair<unsigned long, unsigned long>{7, 5}, {10, 8}, {23, 8}, {31, 9}, {52, 11}, {62, 11}, {40, 20}}){
+
+        auto m = format.first, e = format.second;
+        auto bias = (1ULL << (e - 1)) - 1;
+        for(int i = 0; i < 300 && !HasFatalFailure(); i++){
+
+            auto exponent_a = bias - 3 + mt() % 7;
+            auto exponent_b = bias - 3 + mt() % 7;
+            auto product_exponent = (long long) (exponent_a + exponent_b - bias);
+            auto distance = (long long) (i % 3 ? 3 : 3 * m);
+            auto exponent_c = product_exponent - distance + (long long) (mt() % (2 * distance + 1));
+            exponent_c = std::max(1LL, std::min((long long) (2 * bias), exponent_c));
+
+            calibrate_fma(random_mps(m, e, exponent_a, mt), random_mps(m, e, exponent_b, mt), random_mps(m, e, exponent_c, mt));
+        }
+    }
+
+    mps::setEngine(previous);
+}
+
+TEST(counters, analytic_ira){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+
+    auto solve = [](mps::engine selected){
+
+        mps::setEngine(selected);
+
+        ira IRA(10, 52, 11);
+        IRA.setRandomRange(-10, 10);
+        IRA.setWorkingPrecision(23, 8);
+        IRA.setLowerPrecision(10, 5);
+        IRA.setUpperPrecision(52, 11);
+        IRA.setMaxIter(3);
+        vector<double> A(100);
+        vector<mps> b;
+        for(unsigned long i = 0; i < 10; i++){
+            for(unsigned long j = 0; j < 10; j++){
+                A[i*10 + j] = i == j ? 20.0 + (double) i : (double) ((i * 7 + j * 3) % 11) - 5.0;
+            }
+            b.emplace_back(52, 11, (double) i - 4.5);
+        }
+        IRA.setMatrix(A);
+        IRA.irPLU_2(b);
+
+        return IRA.evaluation.counters;
+    };
+
+    auto reference = solve(mps::engine::reference);
+    auto analytic = solve(mps::engine::analytic);
+
+    EXPECT_LT(0, reference.full_adders);
+    EXPECT_EQ(reference, analytic);
+
+    mps::setEngine(previous);
+}
+
+TEST(counters, sliced){
+
+    if(!mps_counters::enabled){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+
+    auto cost = [](mps::engine selected, const std::function<vector<mps>()>& operation){
+        mps::setEngine(selected);
+        auto start = mps_counters::read();
+        auto result = operation();
+        auto ret = mps_counters::read() - start;
+        std::string bits;
+        for(const auto& value : result){
+            bits += value.print();
+        }
+        return std::make_pair(bits, ret);
+    };
+
+    std::mt19937_64 mt(17);
+    for(auto format : {std::pair<unsigned long, unsigned long>{4, 3}, {23, 8}, {52, 11}, {80, 15}}){
+
+        // random bits (also special values) and values with close exponents
+        std::uniform_real_distribution<double> dis(-10, 10);
+        vector<mps> a, b;
+        for(int i = 0; i < 300; i++){
+            if(i % 2 && format.first + format.second <= 63){
+                a.push_back(from_pattern(format.first, format.second, mt()));
+                b.push_back(from_pattern(format.first, format.second, mt()));
+            } else {
+                a.emplace_back(format.first, format.second, dis(mt));
+                b.emplace_back(format.first, format.second, dis(mt));
+            }
+        }
+
+        auto elementwise = [&](const std::function<mps(const mps&, const mps&)>& operation){
+            vector<mps> ret;
+            for(unsigned long i = 0; i < a.size(); i++){
+                ret.push_back(operation(a[i], b[i]));
+            }
+            return ret;
+        };
+
+        // pairs of the sliced operation and the same operation one by one with the bit level algorithms
+        const std::pair<std::function<vector<mps>()>, std::function<vector<mps>()>> operations[] = {
+                {[&](){ return ira::add(a, b); }, [&](){ return ira::add(a, b); }},
+                {[&](){ return ira::subtract(a, b); }, [&](){ return ira::subtract(a, b); }},
+                {[&](){ return ira::add(a, b, format.first / 2 + 1, format.second - 1); },
+                 [&](){ return ira::add(a, b, format.first / 2 + 1, format.second - 1); }},
+                {[&](){ return (mps_sliced(a) * mps_sliced(b)).toVector(); }, [&](){ return elementwise(std::multiplies<>()); }},
+                {[&](){ return (mps_sliced(a) / mps_sliced(b)).toVector(); }, [&](){ return elementwise(std::divides<>()); }},
+        };
+
+        for(const auto& operation : operations){
+            auto sliced = cost(mps::engine::sliced, operation.first);
+            auto reference = cost(mps::engine::reference, operation.second);
+
+            EXPECT_EQ(reference.first, sliced.first);
+            EXPECT_LT(0, reference.second.full_adders);
+            EXPECT_EQ(reference.second.full_adders, sliced.second.full_adders);
+            EXPECT_EQ(reference.second.half_adders, sliced.second.half_adders);
+            EXPECT_EQ(reference.second.shifts, sliced.second.shifts);
+            EXPECT_EQ(reference.second.bit_comparisons, sliced.second.bit_comparisons);
+            EXPECT_EQ(reference.second, sliced.second);
+        }
+    }
+
+    mps::setEngine(previous);
+}
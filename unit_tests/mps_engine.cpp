@@ -0,0 +1,528 @@
+//
+// Tests for the arithmetic engines. The packed engine must produce exactly the same bit patterns as the reference engine.
+//
+
+#include "gtest/gtest.h"
+#include "helper_functions.h"
+
+#include "mps.h"
+#include "mps_sliced.h"
+#include "ira.h"
+
+#include <random>
+#include <cstring>
+
+
+namespace {
+
+    /**
+     * Computes all operations with both engines and compares the bit patterns.
+     */
+    void expect_same_results(const mps& one, const mps& two){
+
+        auto previous = mps::getEngine();
+
+        mps::setEngine(mps::engine::reference);
+        auto add = (one + two).print();
+        auto sub = (one - two).print();
+        auto mul = (one * two).print();
+        auto div = (one / two).print();
+        bool eq = one == two;
+        bool lt = one < two;
+        bool gt = one > two;
+
+        mps::setEngine(mps::engine::packed);
+        EXPECT_EQ(add, (one + two).print()) << one.print() << " + " << two.print();
+        EXPECT_EQ(sub, (one - two).print()) << one.print() << " - " << two.print();
+        EXPECT_EQ(mul, (one * two).print()) << one.print() << " * " << two.print();
+        EXPECT_EQ(div, (one / two).print()) << one.print() << " / " << two.print();
+        EXPECT_EQ(eq, one == two) << one.print() << " == " << two.print();
+        EXPECT_EQ(lt, one < two) << one.print() << " < " << two.print();
+        EXPECT_EQ(gt, one > two) << one.print() << " > " << two.print();
+
+        mps::setEngine(previous);
+    }
+
+    void exhaustive(unsigned long m, unsigned long e){
+
+        auto patterns = 1ULL << (m + e + 1);
+        for(unsigned long long i = 0; i < patterns; i++){
+            for(unsigned long long j = 0; j < patterns; j++){
+                expect_same_results(from_pattern(m, e, i), from_pattern(m, e, j));
+            }
+        }
+    }
+
+    void random_pairs(unsigned long m, unsigned long e, unsigned long number_of_tests){
+
+        std::mt19937_64 mt(m * 1000 + e);
+        for(unsigned long i = 0; i < number_of_tests; i++){
+            bool close = i % 4 != 0;
+            expect_same_results(from_random(m, e, mt, close), from_random(m, e, mt, close));
+        }
+    }
+
+    /**
+     * Computes all operations element by element on bit planes and compares them with the operators of mps.
+     */
+    void expect_same_sliced(const vector<mps>& one, const vector<mps>& two){
+
+        mps_sliced ONE(one), TWO(two);
+        auto add = (ONE + TWO).toVector();
+        auto sub = (ONE - TWO).toVector();
+        auto mul = (ONE * TWO).toVector();
+        auto div = (ONE / TWO).toVector();
+
+        for(size_t i = 0; i < one.size(); i++){
+            auto info = one[i].print() + " " + two[i].print();
+            EXPECT_EQ((one[i] + two[i]).print(), add[i].print()) << info;
+            EXPECT_EQ((one[i] - two[i]).print(), sub[i].print()) << info;
+            EXPECT_EQ((one[i] * two[i]).print(), mul[i].print()) << info;
+            EXPECT_EQ((one[i] / two[i]).print(), div[i].print()) << info;
+            EXPECT_EQ((one[i] / two[i]).isNaN(), div[i].isNaN()) << info;
+        }
+    }
+
+    void sliced_exhaustive(unsigned long m, unsigned long e){
+
+        vector<mps> one, two;
+        auto patterns = 1ULL << (m + e + 1);
+        for(unsigned long long i = 0; i < patterns; i++){
+            for(unsigned long long j = 0; j < patterns; j++){
+                one.push_back(from_pattern(m, e, i));
+                two.push_back(from_pattern(m, e, j));
+            }
+        }
+        expect_same_sliced(one, two);
+    }
+
+    void sliced_random(unsigned long m, unsigned long e, unsigned long number_of_tests){
+
+        std::mt19937_64 mt(m * 1000 + e);
+        vector<mps> one, two;
+        for(unsigned long i = 0; i < number_of_tests; i++){
+            bool close = i % 4 != 0;
+            one.push_back(from_random(m, e, mt, close));
+            two.push_back(from_random(m, e, mt, close));
+        }
+        expect_same_sliced(one, two);
+    }
+
+    /**
+     * Casts values on bit planes and compares them with mps::cast.
+     */
+    void expect_same_cast(const vector<mps>& values, unsigned long m, unsigned long e){
+
+        mps_sliced sliced(values);
+        sliced.cast(m, e);
+
+        EXPECT_EQ(m, sliced.getMantisseLength());
+        EXPECT_EQ(e, sliced.getExponentLength());
+        for(size_t i = 0; i < values.size(); i++){
+            auto expected = values[i];
+            expected.cast(m, e);
+            auto value = sliced.get(i);
+            EXPECT_EQ(expected.print(), value.print()) << values[i].print() << " to (" << m << ", " << e << ")";
+            EXPECT_EQ(expected.isNaN(), value.isNaN()) << values[i].print();
+        }
+    }
+
+    /**
+     * Compares the results of the native engine with the reference engine for random bit patterns of float or double.
+     * The bit patterns must be identical, also for overflow, underflow and operands with distant exponents.
+     */
+    template<typename B>
+    void native_random(unsigned long m, unsigned long e, unsigned long number_of_tests){
+
+        auto previous = mps::getEngine();
+
+        std::mt19937_64 mt(m * 1000 + e);
+        auto random_pattern = [&](B base) -> B {
+            // exponents close to the base, just above the mantissa length away from it (the larger operand is the
+            // result of an addition), but also large and small ones (overflow and underflow)
+            B exponent;
+            switch(mt() % 4){
+                case 0:  exponent = 1 + mt() % ((((B) 1) << e) - 2); break;
+                case 1:  exponent = base + m + mt() % 3; break;
+                default: exponent = base + mt() % (2*m + 4) - (m + 2);
+            }
+            exponent &= (((B) 1) << e) - 1;
+            return (B) ((mt() & 1) << (m + e)) | (exponent << m) | (B) (mt() & ((((B) 1) << m) - 1));
+        };
+
+        B bias = (((B) 1) << (e-1)) - 1;
+        for(unsigned long i = 0; i < number_of_tests; i++){
+
+            B one_bits = random_pattern(bias);
+            B two_bits = random_pattern((one_bits >> m) & ((((B) 1) << e) - 1));
+
+            auto ONE = from_pattern(m, e, one_bits);
+            auto TWO = from_pattern(m, e, two_bits);
+            auto info = ONE.print() + " " + TWO.print();
+
+            mps::setEngine(mps::engine::reference);
+            auto add = (ONE + TWO).print();
+            auto sub = (ONE - TWO).print();
+            auto mul = (ONE * TWO).print();
+            auto div = (ONE / TWO).print();
+
+            mps::setEngine(mps::engine::native);
+            EXPECT_EQ(add, (ONE + TWO).print()) << info;
+            EXPECT_EQ(sub, (ONE - TWO).print()) << info;
+            EXPECT_EQ(mul, (ONE * TWO).print()) << info;
+            EXPECT_EQ(div, (ONE / TWO).print()) << info;
+        }
+
+        mps::setEngine(previous);
+    }
+}
+
+
+TEST(engine, select){
+
+    auto previous = mps::getEngine();
+
+    mps::setEngine(mps::engine::packed);
+    EXPECT_EQ(mps::engine::packed, mps::getEngine());
+
+    mps::setEngine(mps::engine::native);
+    EXPECT_EQ(mps::engine::native, mps::getEngine());
+
+    mps::setEngine(mps::engine::reference);
+    EXPECT_EQ(mps::engine::reference, mps::getEngine());
+
+    mps::setEngine(previous);
+}
+
+TEST(engine, packed_exhaustive_small){
+    exhaustive(1, 2);
+    exhaustive(2, 3);
+    exhaustive(3, 3);
+}
+
+TEST(engine, packed_exhaustive_medium){
+    exhaustive(3, 4);
+    exhaustive(4, 4);
+}
+
+TEST(engine, packed_random_standard){
+    random_pairs(10, 5, 2000);
+    random_pairs(23, 8, 2000);
+    random_pairs(52, 11, 2000);
+}
+
+TEST(engine, packed_random_word_boundaries){
+    random_pairs(63, 11, 1000);
+    random_pairs(64, 11, 1000);
+    random_pairs(65, 11, 1000);
+    random_pairs(127, 11, 500);
+    random_pairs(128, 15, 500);
+}
+
+TEST(engine, packed_random_integer_boundaries){
+    random_pairs(59, 11, 1000);
+    random_pairs(60, 11, 1000);
+    random_pairs(62, 11, 1000);
+    random_pairs(100, 15, 500);
+    random_pairs(112, 15, 500);
+    random_pairs(113, 15, 500);
+}
+
+TEST(engine, packed_random_wide){
+    random_pairs(200, 15, 200);
+    random_pairs(300, 15, 100);
+}
+
+TEST(engine, packed_karatsuba){
+
+    auto previous = mps::getKaratsubaThreshold();
+    mps::setKaratsubaThreshold(4);
+
+    random_pairs(300, 15, 100);
+    random_pairs(520, 15, 30);
+
+    // very wide mantissas: Karatsuba and schoolbook multiplication must give the same products
+    auto previous_engine = mps::getEngine();
+    mps::setEngine(mps::engine::packed);
+
+    std::mt19937_64 mt(42);
+    for(unsigned long m : {1000UL, 2500UL, 4099UL}){
+        for(int i = 0; i < 10; i++){
+            auto one = from_random(m, 20, mt, true);
+            auto two = from_random(m, 20, mt, true);
+
+            mps::setKaratsubaThreshold(4);
+            auto karatsuba = (one * two).print();
+            mps::setKaratsubaThreshold(1000);
+            EXPECT_EQ((one * two).print(), karatsuba) << m;
+        }
+    }
+
+    mps::setEngine(previous_engine);
+    mps::setKaratsubaThreshold(previous);
+}
+
+TEST(engine, packed_newton_division){
+
+    auto previous = mps::getNewtonThreshold();
+    mps::setNewtonThreshold(1);
+
+    random_pairs(113, 15, 300);
+    random_pairs(300, 15, 100);
+    random_pairs(520, 15, 30);
+
+    // very wide mantissas: the Newton-Raphson reciprocal and the restoring division must give the same quotients
+    auto previous_engine = mps::getEngine();
+    mps::setEngine(mps::engine::packed);
+
+    std::mt19937_64 mt(7);
+    for(unsigned long m : {1000UL, 2500UL, 4099UL}){
+        for(int i = 0; i < 10; i++){
+            auto one = from_random(m, 20, mt, true);
+            auto two = from_random(m, 20, mt, true);
+
+            mps::setNewtonThreshold(1);
+            auto newton = (one / two).print();
+            mps::setNewtonThreshold(1000);
+            EXPECT_EQ((one / two).print(), newton) << m;
+        }
+    }
+
+    // divisors with long runs of ones and zeros (reciprocal close to a power of two)
+    for(unsigned long m : {200UL, 1000UL}){
+        mps one(m, 15, 1.0), two(m, 15, 1.0);
+        vector<bool> ones(m, true), zeros(m, false);
+        zeros[m-1] = true;
+
+        for(auto mantissa : {ones, zeros}){
+            two.setMantissa(mantissa);
+            mps::setNewtonThreshold(1);
+            auto newton = (one / two).print();
+            mps::setNewtonThreshold(1000);
+            EXPECT_EQ((one / two).print(), newton) << m;
+        }
+    }
+
+    mps::setEngine(previous_engine);
+    mps::setNewtonThreshold(previous);
+}
+
+TEST(engine, packed_values){
+
+    auto previous = mps::getEngine();
+    mps::setEngine(mps::engine::packed);
+
+    mps one(52, 11, 3.25);
+    mps two(52, 11, -0.1);
+
+    EXPECT_EQ(3.25 + -0.1, (one + two).getValue());
+    EXPECT_EQ(3.25 - -0.1, (one - two).getValue());
+    EXPECT_EQ(3.25 * -0.1, (one * two).getValue());
+    EXPECT_EQ(3.25 / -0.1, (one / two).getValue());
+    EXPECT_TRUE(one > two);
+
+    mps::setEngine(previous);
+}
+
+TEST(engine, native_random_double){
+    native_random<uint64_t>(52, 11, 20000);
+}
+
+TEST(engine, native_random_float){
+    native_random<uint32_t>(23, 8, 20000);
+}
+
+TEST(engine, native_range){
+
+    auto previous = mps::getEngine();
+
+    // results outside the normal range and distant exponents are computed like by the reference engine
+    mps small(52, 11, numeric_limits<double>::min());
+    mps large(23, 8, numeric_limits<float>::max());
+    std::vector<std::pair<mps, mps>> operands = {
+            {small, mps(52, 11, -0.5)},
+            {small, mps(52, 11, 3.0)},
+            {mps(52, 11, 1.5 * numeric_limits<double>::min()), small},
+            {mps(52, 11, 2.5), mps(52, 11, 2.5)},
+            {large, large},
+            {large, mps(23, 8, -2.0)},
+            {from_pattern(23, 8, 0xC059C457ULL), from_pattern(23, 8, 0xCC0F37CAULL)},
+            {mps(23, 8, 1.0), from_pattern(23, 8, 0x33800001ULL)},
+            {mps(52, 11, 1.0), from_pattern(52, 11, 0x3C90000000000001ULL)},
+    };
+
+    for(auto& [one, two] : operands){
+
+        mps::setEngine(mps::engine::reference);
+        auto add = (one + two).print();
+        auto sub = (one - two).print();
+        auto mul = (one * two).print();
+        auto div = (one / two).print();
+
+        mps::setEngine(mps::engine::native);
+        EXPECT_EQ(add, (one + two).print());
+        EXPECT_EQ(sub, (one - two).print());
+        EXPECT_EQ(mul, (one * two).print());
+        EXPECT_EQ(div, (one / two).print());
+    }
+
+    mps::setEngine(previous);
+}
+
+TEST(engine, native_fallback){
+
+    auto previous = mps::getEngine();
+
+    // other formats and operands with the exponents 00...0 or 11...1 are computed by the packed engine
+    std::vector<std::pair<mps, mps>> operands = {
+            {mps(10, 5, 1.75), mps(10, 5, -3.5)},
+            {mps(112, 15, 1.0/3.0), mps(112, 15, 7.0)},
+            {from_pattern(52, 11, 0x0008000000000001ULL), mps(52, 11, 1.5)},
+            {from_pattern(23, 8, 0x7F812345ULL), mps(23, 8, 2.0)},
+    };
+
+    for(auto& [one, two] : operands){
+
+        mps::setEngine(mps::engine::reference);
+        auto add = (one + two).print();
+        auto sub = (one - two).print();
+        auto mul = (one * two).print();
+        auto div = (one / two).print();
+
+        mps::setEngine(mps::engine::native);
+        EXPECT_EQ(add, (one + two).print());
+        EXPECT_EQ(sub, (one - two).print());
+        EXPECT_EQ(mul, (one * two).print());
+        EXPECT_EQ(div, (one / two).print());
+    }
+
+    mps::setEngine(previous);
+}
+
+TEST(engine, sliced_exhaustive){
+
+    auto previous = mps::getEngine();
+    mps::setEngine(mps::engine::reference);
+
+    sliced_exhaustive(1, 2);
+    sliced_exhaustive(2, 3);
+    sliced_exhaustive(3, 3);
+    sliced_exhaustive(4, 4);
+
+    mps::setEngine(previous);
+}
+
+TEST(engine, sliced_random){
+
+    // the packed engine gives the same results as the reference engine (see above)
+    auto previous = mps::getEngine();
+    mps::setEngine(mps::engine::packed);
+
+    sliced_random(10, 5, 2000);
+    sliced_random(23, 8, 2000);
+    sliced_random(52, 11, 2000);
+    sliced_random(64, 11, 500);
+    sliced_random(113, 15, 300);
+    sliced_random(200, 15, 100);
+
+    // exponents with more than 64 bits (reference engine), the values are close to each other
+    mps::setEngine(mps::engine::reference);
+    std::mt19937_64 mt(70);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    vector<mps> one, two;
+    for(int i = 0; i < 300; i++){
+        one.emplace_back(20, 70, distribution(mt) * std::ldexp(1.0, (int) (mt() % 64) - 32));
+        two.emplace_back(20, 70, distribution(mt) * std::ldexp(1.0, (int) (mt() % 64) - 32));
+    }
+    expect_same_sliced(one, two);
+
+    mps::setEngine(previous);
+}
+
+TEST(engine, sliced_storage){
+
+    vector<mps> values = {mps(23, 8, 1.5), mps(23, 8, -0.0), mps(23, 8, numeric_limits<double>::infinity())};
+    mps_sliced sliced(values);
+
+    EXPECT_EQ(values.size(), sliced.size());
+    for(size_t i = 0; i < values.size(); i++){
+        EXPECT_EQ(values[i].print(), sliced.get(i).print());
+    }
+    EXPECT_TRUE(sliced.get(2).isInf());
+
+    sliced.set(0, mps(23, 8, 2.0));
+    EXPECT_EQ(2.0, sliced.get(0).getValue());
+
+    EXPECT_THROW(mps_sliced(vector<mps>{}), std::invalid_argument);
+    EXPECT_THROW(sliced.set(0, mps(10, 8, 2.0)), std::invalid_argument);
+    EXPECT_THROW(auto tmp = sliced.get(3), std::invalid_argument);
+    EXPECT_THROW(auto tmp = sliced + mps_sliced(23, 8, 4), std::invalid_argument);
+    EXPECT_THROW(auto tmp = sliced + mps_sliced(10, 8, 3), std::invalid_argument);
+}
+
+TEST(engine, sliced_cast){
+
+    // all values of small formats to larger and smaller formats
+    for(auto format : {std::pair<unsigned long, unsigned long>{3, 3}, {4, 4}, {5, 2}}){
+        vector<mps> values;
+        for(unsigned long long i = 0; i < (1ULL << (format.first + format.second + 1)); i++){
+            values.push_back(from_pattern(format.first, format.second, i));
+        }
+        for(unsigned long m = 1; m <= 7; m++){
+            for(unsigned long e = 2; e <= 6; e++){
+                expect_same_cast(values, m, e);
+            }
+        }
+    }
+
+    // random values (also in the lanes of a second block)
+    std::mt19937_64 mt(9);
+    for(auto format : {std::pair<unsigned long, unsigned long>{52, 11}, {23, 8}, {100, 15}}){
+        vector<mps> values;
+        for(unsigned long i = 0; i < mps_sliced::lanesPerBlock() + 37; i++){
+            values.push_back(from_random(format.first, format.second, mt, i % 2));
+        }
+        expect_same_cast(values, 23, 8);
+        expect_same_cast(values, 10, 5);
+        expect_same_cast(values, 64, 11);
+        expect_same_cast(values, 120, 20);
+        expect_same_cast(values, 52, 11);
+    }
+
+    mps_sliced sliced(vector<mps>{mps(23, 8, 1.5)});
+    EXPECT_THROW(sliced.cast(0, 8), std::invalid_argument);
+    EXPECT_THROW(sliced.cast(23, 1), std::invalid_argument);
+}
+
+TEST(engine, sliced_ira){
+
+    auto previous = mps::getEngine();
+
+    std::mt19937_64 mt(5);
+    vector<mps> a, b;
+    for(int i = 0; i < 1000; i++){
+        a.push_back(from_random(52, 11, mt, true));
+        b.push_back(from_random(52, 11, mt, true));
+    }
+
+    mps::setEngine(mps::engine::reference);
+    auto add = ira::add(a, b);
+    auto sub = ira::subtract(a, b);
+    auto add_cast = ira::add(a, b, 23, 8);
+
+    mps::setEngine(mps::engine::sliced);
+    auto sliced_add = ira::add(a, b);
+    auto sliced_sub = ira::subtract(a, b);
+    auto sliced_add_cast = ira::add(a, b, 23, 8);
+
+    for(size_t i = 0; i < a.size(); i++){
+        EXPECT_EQ(add[i].print(), sliced_add[i].print());
+        EXPECT_EQ(sub[i].print(), sliced_sub[i].print());
+        EXPECT_EQ(add_cast[i].print(), sliced_add_cast[i].print());
+    }
+
+    // single operations use the reference engine
+    EXPECT_EQ(add[0].print(), (a[0] + b[0]).print());
+
+    mps::setEngine(previous);
+}
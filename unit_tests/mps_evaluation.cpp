@@ -170,6 +170,22 @@ TEST(checkPrecision, values_too_small){
 
 
 
+TEST(checkPrecision, long_mantissa){
+
+    mps MPS_should(100, 11, 1.5);
+    mps MPS_is = MPS_should;
+
+    // error 2^-91
+    auto mantissa = MPS_is.getMantissa();
+    mantissa[90] = !mantissa[90];
+    MPS_is.setMantissa(mantissa);
+
+    EXPECT_TRUE(MPS_is.checkPrecision(MPS_should, 89));
+    EXPECT_TRUE(MPS_is.checkPrecision(MPS_should, 90));
+    EXPECT_FALSE(MPS_is.checkPrecision(MPS_should, 91));
+    EXPECT_TRUE(MPS_should.checkPrecision(MPS_should, 99));
+}
+
 TEST(getPrecision, simple_0){
 
     mps MPS_should(6, 4, 3.14);
@@ -419,6 +435,47 @@ TEST(getPrecision, negative_precision_4){
     EXPECT_EQ(0, MPS_should.getPrecision(MPS_is));
 }
 
+TEST(getPrecision, long_mantissa){
+
+    mps MPS_should(100, 11, 1.5);
+    mps MPS_is = MPS_should;
+    EXPECT_EQ(100, MPS_is.getPrecision(MPS_should));
+
+    // same exponent
+    auto mantissa = MPS_is.getMantissa();
+    mantissa[80] = !mantissa[80];
+    MPS_is.setMantissa(mantissa);
+    EXPECT_EQ(80, MPS_is.getPrecision(MPS_should));
+    EXPECT_EQ(80, MPS_should.getPrecision(MPS_is));
+
+    mantissa[80] = !mantissa[80];
+    mantissa[99] = !mantissa[99];
+    MPS_is.setMantissa(mantissa);
+    EXPECT_EQ(99, MPS_is.getPrecision(MPS_should));
+
+    // exponents differ by one: 2 and 2 - 2^-99
+    mps MPS_larger(100, 11, 2);
+    mps MPS_smaller(100, 11, 1);
+    mantissa = vector<bool>(100, true);
+    MPS_smaller.setMantissa(mantissa);
+    EXPECT_EQ(99, MPS_larger.getPrecision(MPS_smaller));
+    EXPECT_EQ(99, MPS_smaller.getPrecision(MPS_larger));
+
+    // exponents differ by 70
+    mps MPS_far(100, 11, 1);
+    vector<bool> exponent{1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 1}; // NOLINT(*-use-bool-literals)
+    MPS_far.setExponent(exponent);
+    mantissa = vector<bool>(100, false);
+    mantissa[80] = true;
+    MPS_far.setMantissa(mantissa);
+    EXPECT_EQ(-70, MPS_far.getPrecision(MPS_smaller));
+    EXPECT_EQ(0, MPS_smaller.getPrecision(MPS_far));
+
+    mantissa[10] = true;
+    MPS_far.setMantissa(mantissa);
+    EXPECT_EQ(-71, MPS_far.getPrecision(MPS_smaller));
+}
+
 TEST(getPrecision, exceptions){
 
     bool ret = true;
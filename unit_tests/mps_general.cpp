@@ -7,6 +7,9 @@
 
 #include "mps.h"
 
+#include <cstring>
+#include <random>
+
 
 // ######################
 // Constructor Tests
@@ -172,6 +175,26 @@ TEST(converter_tests, test_small_difference) {
     EXPECT_EQ(should_value(test_value), is_mps(MPS.getBitArray()));
 }
 
+TEST(converter_tests, test_below_power_of_two) {
+
+    // log2 of these values rounds up to the next integer
+    for(double test_value : {9007199254740991.0, std::nextafter(1.0, 0.0), std::nextafter(0x1p-500, 0.0)}){
+        mps MPS(52, 11, test_value);
+
+        EXPECT_EQ(should_value(test_value), is_mps(MPS.getBitArray())) << test_value;
+        EXPECT_EQ(test_value, MPS.getValue()) << test_value;
+    }
+}
+
+TEST(converter_tests, test_truncation) {
+
+    // the mantissa is truncated, not rounded
+    double test_value = 1.0 + pow(0.5, 3) + pow(0.5, 11);
+    mps MPS(10, 5, test_value);
+
+    EXPECT_EQ(1.125, MPS.getValue());
+}
+
 TEST(converter_tests, test_neg_max_double) {
 
     double test_value = numeric_limits<double>::max() * -1;
@@ -371,6 +394,49 @@ TEST(get_value_tests, get_zero_float) {
     EXPECT_EQ(test_value, MPS.getValue());
 }
 
+TEST(get_value_tests, round_trip_random) {
+
+    std::mt19937_64 mt(17);
+    for(int i = 0; i < 20000; i++){
+
+        uint64_t bits = mt();
+        double test_value;
+        std::memcpy(&test_value, &bits, sizeof test_value);
+        if(!std::isfinite(test_value) || std::abs(test_value) < numeric_limits<double>::min()){
+            continue;
+        }
+
+        EXPECT_EQ(should_value(test_value), is_mps(mps(52, 11, test_value).getBitArray())) << test_value;
+        EXPECT_EQ(test_value, mps(52, 11, test_value).getValue()) << test_value;
+        EXPECT_EQ(test_value, mps(100, 15, test_value).getValue()) << test_value;
+        EXPECT_EQ(test_value, mps(52, 80, test_value).getValue()) << test_value;
+    }
+}
+
+TEST(get_value_tests, wide_exponent) {
+
+    // subnormal doubles are normal numbers with a wider exponent
+    for(double test_value : {numeric_limits<double>::denorm_min(), -0x1.8p-1060, 0x1p-1000, -1e300}){
+        EXPECT_EQ(test_value, mps(52, 15, test_value).getValue()) << test_value;
+        EXPECT_EQ(test_value, mps(52, 64, test_value).getValue()) << test_value;
+        EXPECT_EQ(test_value, mps(60, 200, test_value).getValue()) << test_value;
+    }
+}
+
+TEST(get_value_tests, long_mantissa) {
+
+    // mantissas longer than 52 bits are rounded to the nearest double (ties to even)
+    mps MPS(60, 11, 1.0);
+    vector<bool> new_mantissa(60, false);
+    new_mantissa[52] = true;
+    MPS.setMantissa(new_mantissa);
+    EXPECT_EQ(1.0, MPS.getValue());
+
+    new_mantissa[51] = true;
+    MPS.setMantissa(new_mantissa);
+    EXPECT_EQ(1.0 + pow(0.5, 51), MPS.getValue());
+}
+
 TEST(get_value_tests, get_pos_inf_double) {
 
     double test_value = numeric_limits<double>::infinity();
@@ -1340,3 +1406,111 @@ TEST(setCustom, exponent_too_large_flaot){
 
 
 
+
+
+// ######################
+// Batch Conversion Tests
+// ######################
+TEST(batch_conversion, exceptions){
+
+    double value = 1.0;
+    mps MPS;
+    EXPECT_THROW(mps::fromDoubles(&value, 1, &MPS, 0, 11), std::invalid_argument);
+    EXPECT_THROW(mps::fromDoubles(&value, 1, &MPS, 52, 1), std::invalid_argument);
+}
+
+TEST(batch_conversion, same_as_constructor){
+
+    // large enough for the parallel conversion
+    std::mt19937_64 mt(23);
+    std::uniform_real_distribution<double> distribution(-1e3, 1e3);
+    vector<double> values(100000);
+    for(auto& value : values){
+        value = distribution(mt);
+    }
+    values[1] = 0.0;
+    values[2] = -numeric_limits<double>::infinity();
+    values[3] = numeric_limits<double>::quiet_NaN();
+    values[4] = 1e300;
+
+    for(auto [m, e] : vector<std::pair<unsigned long, unsigned long>>{{52, 11}, {10, 5}, {200, 15}}){
+
+        // the previous format of the objects does not matter
+        vector<mps> batch(values.size(), mps(23, 8, 1.0));
+        mps::fromDoubles(values.data(), values.size(), batch.data(), m, e);
+
+        vector<double> back(values.size());
+        mps::toDoubles(batch.data(), batch.size(), back.data());
+
+        for(size_t i = 0; i < values.size(); i += 97){
+            mps expected(m, e, values[i]);
+            EXPECT_EQ(expected.print(), batch[i].print()) << values[i];
+            if(expected.isNaN()){
+                EXPECT_TRUE(batch[i].isNaN() && std::isnan(back[i]));
+            } else {
+                EXPECT_EQ(expected.getValue(), back[i]);
+            }
+        }
+    }
+}
+
+TEST(batch_conversion, float){
+
+    vector<float> values = {1.5f, -0.1f, numeric_limits<float>::max(), 0.0f, numeric_limits<float>::min()};
+    vector<mps> batch(values.size());
+    mps::fromFloats(values.data(), values.size(), batch.data(), 23, 8);
+
+    vector<float> back(values.size());
+    mps::toFloats(batch.data(), batch.size(), back.data());
+
+    for(size_t i = 0; i < values.size(); i++){
+        EXPECT_EQ(should_value(values[i]), is_mps(batch[i].getBitArray()));
+        EXPECT_EQ(values[i], back[i]);
+    }
+}
+
+TEST(target_format, same_as_cast){
+
+    auto previous = mps::getEngine();
+    std::mt19937_64 mt(31);
+    std::uniform_real_distribution<double> distribution(-1e3, 1e3);
+
+    using format = std::pair<unsigned long, unsigned long>;
+    const vector<format> formats{{10, 5}, {23, 8}, {52, 11}, {80, 15}};
+
+    auto cast = [](const mps& value, format target){
+        auto ret = value;
+        ret.cast(target.first, target.second);
+        return ret;
+    };
+
+    for(auto selected : {mps::engine::reference, mps::engine::packed}){
+        mps::setEngine(selected);
+
+        for(int i = 0; i < 300; i++){
+
+            auto fa = formats[mt() % formats.size()], fb = formats[mt() % formats.size()], fc = formats[mt() % formats.size()];
+            auto target = formats[mt() % formats.size()];
+
+            mps a(fa.first, fa.second, distribution(mt));
+            mps b(fb.first, fb.second, i % 7 ? distribution(mt) : 1e200);   // overflows in the narrow formats
+            mps c(fc.first, fc.second, i % 11 ? distribution(mt) : 0.0);
+
+            auto a_cast = cast(a, target), b_cast = cast(b, target), c_cast = cast(c, target);
+
+            EXPECT_EQ((a_cast + b_cast).print(), mps::add(a, b, target.first, target.second).print());
+            EXPECT_EQ((a_cast - b_cast).print(), mps::subtract(a, b, target.first, target.second).print());
+            EXPECT_EQ((a_cast * b_cast).print(), mps::multiply(a, b, target.first, target.second).print());
+            EXPECT_EQ((a_cast / c_cast).print(), mps::divide(a, c, target.first, target.second).print());
+            EXPECT_EQ(mps::fma(a_cast, b_cast, c_cast).print(), mps::fma(a, b, c, target.first, target.second).print());
+        }
+    }
+
+    // operands in the target format are used directly
+    mps x(52, 11, 1.5);
+    EXPECT_EQ(3.0, mps::add(x, x, 52, 11).getValue());
+    EXPECT_EQ(52UL, mps::add(mps(10, 5, 1.0), x, 52, 11).getMantisseLength());
+    EXPECT_ANY_THROW(auto y = mps::add(x, x, 0, 11));
+
+    mps::setEngine(previous);
+}
@@ -7,6 +7,9 @@
 
 #include "mps.h"
 
+#include <algorithm>
+#include <limits>
+
 
 TEST(implicit_equal, pos_double){
 
@@ -666,3 +669,212 @@ TEST(assign, different_exponent_float){
     EXPECT_EQ(should_value(5.0f), is_mps(MPS_copy.getBitArray()));
 }
 
+
+
+TEST(move, constructor){
+
+    mps MPS(52, 11, -3.75);
+    mps MPS_moved(std::move(MPS));
+
+    EXPECT_EQ(-3.75, MPS_moved.getValue());
+    EXPECT_EQ(52, MPS_moved.getMantisseLength());
+    EXPECT_EQ(11, MPS_moved.getExponentLength());
+
+    // the moved from object is empty and can be reused with |=
+    EXPECT_EQ(0, MPS.getMantisseLength());
+    MPS |= mps(23, 8, 2.5f);
+    EXPECT_EQ(should_value(2.5f), is_mps(MPS.getBitArray()));
+}
+
+TEST(move, assign){
+
+    mps ONE(200, 15, 1.0);
+    mps TWO(200, 15, 3.0);
+
+    ONE = ONE / TWO;
+    EXPECT_EQ((mps(200, 15, 1.0) / TWO).print(), ONE.print());
+
+    mps THREE(23, 8, 1.0);
+    EXPECT_ANY_THROW(THREE = mps(23, 9, 1.0));
+    EXPECT_ANY_THROW(THREE = mps(22, 8, 1.0));
+    EXPECT_EQ(1.0, THREE.getValue());
+}
+
+TEST(move, empty_destination){
+
+    // moved from and default constructed objects take over the format of the assigned object
+    mps ONE(23, 8, 1.5);
+    mps TWO(std::move(ONE));
+    ONE = mps(52, 11, -2.5);
+    EXPECT_EQ(should_value(-2.5), is_mps(ONE.getBitArray()));
+
+    mps THREE;
+    THREE = TWO;
+    EXPECT_EQ(should_value(1.5f), is_mps(THREE.getBitArray()));
+    EXPECT_ANY_THROW(THREE = ONE);
+
+    mps FOUR = std::move(THREE);
+    THREE = std::move(FOUR);
+    EXPECT_EQ(0, FOUR.getMantisseLength());
+    EXPECT_EQ(should_value(1.5f), is_mps(THREE.getBitArray()));
+}
+
+TEST(move, algorithms){
+
+    for(unsigned long m : {23UL, 200UL}){
+
+        mps a(m, 11, 1.25);
+        mps b(m, 11, -7.0);
+        std::swap(a, b);
+        EXPECT_EQ(-7.0, a.getValue());
+        EXPECT_EQ(1.25, b.getValue());
+
+        vector<double> values = {3.5, -1.0, 0.0, 1e10, -2.25, 0.125, 42.0, -1e-5, 7.0, 3.5, -8.0, 1.0, 2.0, -3.0, 9.0,
+                                 0.5, 6.0, -0.25};
+        vector<mps> numbers;
+        for(auto value : values){
+            numbers.emplace_back(m, 11, value);
+        }
+
+        std::sort(numbers.begin(), numbers.end(), [](const mps& one, const mps& two){ return one < two; });
+        std::sort(values.begin(), values.end());
+        for(unsigned long i = 0; i < values.size(); i++){
+            EXPECT_EQ(mps(m, 11, values[i]).print(), numbers[i].print());
+            EXPECT_EQ(m, numbers[i].getMantisseLength());
+        }
+
+        numbers.erase(numbers.begin() + 3);
+        numbers.erase(numbers.begin(), numbers.begin() + 2);
+        values.erase(values.begin() + 3);
+        values.erase(values.begin(), values.begin() + 2);
+        ASSERT_EQ(values.size(), numbers.size());
+        for(unsigned long i = 0; i < values.size(); i++){
+            EXPECT_EQ(mps(m, 11, values[i]).print(), numbers[i].print());
+        }
+    }
+}
+
+TEST(compound, operators){
+
+    for(unsigned long m : {23UL, 52UL, 200UL}){
+
+        mps a(m, 11, 3.25);
+        mps b(m, 11, -0.1);
+
+        auto x = a;
+        x += b;
+        EXPECT_EQ((a + b).print(), x.print());
+
+        x = a;
+        x -= b;
+        EXPECT_EQ((a - b).print(), x.print());
+
+        x = a;
+        x *= b;
+        EXPECT_EQ((a * b).print(), x.print());
+
+        x = a;
+        x /= b;
+        EXPECT_EQ((a / b).print(), x.print());
+
+        // the operand may be the object itself
+        x = a;
+        x += x;
+        EXPECT_EQ((a + a).print(), x.print());
+    }
+
+    mps c(23, 8, 1.0);
+    EXPECT_ANY_THROW(c += mps(23, 9, 1.0));
+    EXPECT_ANY_THROW(c *= mps(22, 8, 1.0));
+}
+
+TEST(compound, temporaries){
+
+    mps a(52, 11, 1.5);
+    mps b(52, 11, -2.25);
+    mps c(52, 11, 0.1);
+
+    EXPECT_EQ(1.5 * -2.25 + 0.1, (a * b + c).getValue());
+    EXPECT_EQ((1.5 + -2.25) - 0.1, (a + b - c).getValue());
+    EXPECT_EQ((1.5 - -2.25) * 0.1, ((a - b) * c).getValue());
+    EXPECT_EQ((1.5 / -2.25) / 0.1, (a / b / c).getValue());
+    EXPECT_EQ(0.1 + 0.0, (mps(52, 11, 0.0) + c).getValue());
+}
+
+TEST(compound, storage){
+
+    auto previous = mps::getEngine();
+    mps::setEngine(mps::engine::packed);
+
+    // mantissas longer than 128 bits are stored on the heap, the result is written into the same memory
+    mps a(200, 15, 3.25);
+    mps b(200, 15, -0.1);
+    auto x = a;
+    auto words = x.getMantissaView().data();
+
+    x += b;
+    x -= a;
+    x *= b;
+    x /= a;
+    x *= x;
+    EXPECT_EQ(words, x.getMantissaView().data());
+    EXPECT_EQ((((a + b - a) * b / a) * ((a + b - a) * b / a)).print(), x.print());
+
+    // a temporary operand is reused for the result
+    auto product = a * b;
+    words = product.getMantissaView().data();
+    auto sum = std::move(product) + a;
+    EXPECT_EQ(words, sum.getMantissaView().data());
+    words = sum.getMantissaView().data();
+    auto quotient = b / std::move(sum);
+    EXPECT_EQ(words, quotient.getMantissaView().data());
+
+    mps::setEngine(previous);
+}
+
+TEST(compound, engines){
+
+    auto previous = mps::getEngine();
+
+    vector<double> values = {3.25, -0.1, 1e-300, -7e300, 0.0, -0.0, 1.0, std::numeric_limits<double>::infinity(),
+                             -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+
+    for(auto selected : {mps::engine::reference, mps::engine::packed, mps::engine::analytic}){
+        mps::setEngine(selected);
+
+        for(auto format : {std::pair<unsigned long, unsigned long>{10, 5}, {52, 11}, {150, 70}, {200, 15}}){
+            for(auto u : values){
+                for(auto v : values){
+
+                    mps a(format.first, format.second, u);
+                    mps b(format.first, format.second, v);
+                    auto info = a.print() + " " + b.print();
+
+                    auto x = a;
+                    x += b;
+                    EXPECT_EQ((a + b).print(), x.print()) << info;
+                    x = a;
+                    x -= b;
+                    EXPECT_EQ((a - b).print(), x.print()) << info;
+                    x = a;
+                    x *= b;
+                    EXPECT_EQ((a * b).print(), x.print()) << info;
+                    x = a;
+                    x /= b;
+                    EXPECT_EQ((a / b).print(), x.print()) << info;
+                    EXPECT_EQ((a / b).isNaN(), x.isNaN()) << info;
+
+                    // temporaries on the left, on the right and on both sides
+                    auto y = a;
+                    EXPECT_EQ((a - b).print(), (mps(a) - b).print()) << info;
+                    EXPECT_EQ((a - b).print(), (a - mps(b)).print()) << info;
+                    EXPECT_EQ((a / b).print(), (mps(a) / mps(b)).print()) << info;
+                    EXPECT_EQ((y * b).print(), (a * mps(b)).print()) << info;
+                    EXPECT_EQ((b + a).print(), (mps(b) + std::move(y)).print()) << info;
+                }
+            }
+        }
+    }
+
+    mps::setEngine(previous);
+}
@@ -0,0 +1,246 @@
+//
+// Tests for the fused multiply-add (mps::fma, addProduct and subtractProduct).
+//
+
+#include "gtest/gtest.h"
+#include "helper_functions.h"
+
+#include "mps.h"
+
+#include <cstring>
+#include <random>
+
+
+namespace {
+
+    /**
+     * Compares mps::fma with the hardware fma for random bit patterns of float or double.
+     * The exponents stay in the range of normal numbers. Subnormal results must be flushed to (positive) zero.
+     */
+    template<typename T, typename B>
+    void fma_random(unsigned long m, unsigned long e, unsigned long number_of_tests){
+
+        std::mt19937_64 mt(m * 1000 + e);
+        B bias = (((B) 1) << (e-1)) - 1;
+
+        auto random_value = [&](B exponent) -> T {
+            B bits = (B) ((mt() & 1) << (m + e)) | (exponent << m) | (B) (mt() & ((((B) 1) << m) - 1));
+            T ret;
+            std::memcpy(&ret, &bits, sizeof ret);
+            return ret;
+        };
+        auto random_exponent = [&](B range) -> B {
+            return bias + mt() % (2 * range + 1) - range;
+        };
+
+        for(unsigned long i = 0; i < number_of_tests; i++){
+
+            // the summand is mostly close to the product, so that cancellation happens
+            T a = random_value(random_exponent(i % 8 ? 3 : bias / 2));
+            T b = random_value(random_exponent(i % 8 ? 3 : bias / 2));
+            T c = random_value(random_exponent(i % 2 ? 2 * m + 4 : 8));
+            if(i % 16 == 1){
+                c = -(a * b);
+            }
+
+            T value = std::fma(a, b, c);
+            auto result = mps::fma(mps(m, e, a), mps(m, e, b), mps(m, e, c));
+            auto info = std::to_string(a) + " " + std::to_string(b) + " " + std::to_string(c);
+
+            if(std::abs(value) < numeric_limits<T>::min()){
+                EXPECT_TRUE(result.isZero() && result.isPositive()) << info;
+            } else {
+                EXPECT_EQ(should_value(value), is_mps(result.getBitArray())) << info;
+            }
+        }
+    }
+}
+
+
+TEST(fma_tests, exceptions) {
+
+    EXPECT_THROW(auto tmp = mps::fma(mps(23, 8, 1.0), mps(23, 8, 1.0), mps(52, 8, 1.0)), std::invalid_argument);
+    EXPECT_THROW(auto tmp = mps::fma(mps(23, 8, 1.0), mps(23, 11, 1.0), mps(23, 8, 1.0)), std::invalid_argument);
+    EXPECT_THROW(mps(23, 8, 1.0).addProduct(mps(10, 8, 1.0), mps(10, 8, 1.0)), std::invalid_argument);
+}
+
+TEST(fma_tests, values) {
+
+    mps a(52, 11, 3.25);
+    mps b(52, 11, -0.1);
+    mps c(52, 11, 7.5);
+
+    EXPECT_EQ(std::fma(3.25, -0.1, 7.5), mps::fma(a, b, c).getValue());
+    EXPECT_EQ(std::fma(-0.1, 7.5, 3.25), mps::fma(b, c, a).getValue());
+    EXPECT_EQ(2 * 3 + 4.0, mps::fma(mps(10, 5, 2.0), mps(10, 5, 3.0), mps(10, 5, 4.0)).getValue());
+
+    // the result is exact
+    EXPECT_TRUE(mps::fma(a, mps(52, 11, 2.0), mps(52, 11, -6.5)).isZero());
+}
+
+TEST(fma_tests, single_rounding) {
+
+    // (1 + 2^-30) (1 - 2^-30) - 1 = -2^-60, but the rounded product is 1
+    double x = 1 + std::ldexp(1.0, -30);
+    double y = 1 - std::ldexp(1.0, -30);
+
+    mps a(52, 11, x);
+    mps b(52, 11, y);
+    mps c(52, 11, -1.0);
+
+    EXPECT_TRUE(((a * b) + c).isZero());
+    EXPECT_EQ(-std::ldexp(1.0, -60), mps::fma(a, b, c).getValue());
+}
+
+TEST(fma_tests, accumulate) {
+
+    mps sum(52, 11, 0.0);
+    double expected = 0.0;
+
+    std::mt19937_64 mt(3);
+    std::uniform_real_distribution<double> distribution(-10, 10);
+    for(int i = 0; i < 100; i++){
+        double x = distribution(mt);
+        double y = distribution(mt);
+
+        if(i % 3){
+            sum.addProduct(mps(52, 11, x), mps(52, 11, y));
+            expected = std::fma(x, y, expected);
+        } else {
+            sum.subtractProduct(mps(52, 11, x), mps(52, 11, y));
+            expected = std::fma(-x, y, expected);
+        }
+
+        EXPECT_EQ(should_value(expected), is_mps(sum.getBitArray()));
+    }
+}
+
+TEST(fma_tests, special_values) {
+
+    mps one(23, 8, 1.0);
+    mps zero(23, 8, 0.0);
+    mps inf(23, 8);
+    inf.setInf();
+    mps nan(23, 8);
+    nan.setNaN();
+
+    EXPECT_TRUE(mps::fma(nan, one, one).isNaN());
+    EXPECT_TRUE(mps::fma(one, one, nan).isNaN());
+    EXPECT_EQ(((inf * zero) + one).print(), mps::fma(inf, zero, one).print());
+    EXPECT_TRUE(mps::fma(inf, one, one).isInf());
+    EXPECT_TRUE(mps::fma(one, one, inf).isInf());
+    EXPECT_EQ(1.0, mps::fma(zero, one, one).getValue());
+    EXPECT_EQ(1.0, mps::fma(one, one, zero).getValue());
+
+    // overflow and flush to zero
+    mps large(23, 8, numeric_limits<float>::max());
+    EXPECT_TRUE(mps::fma(large, mps(23, 8, 2.0), one).isInf());
+    mps small(23, 8, numeric_limits<float>::min());
+    EXPECT_TRUE(mps::fma(small, mps(23, 8, 0.25), zero).isZero());
+    EXPECT_TRUE(mps::fma(small, mps(23, 8, 1.5), mps(23, 8, -1.25 * numeric_limits<float>::min())).isZero());
+}
+
+TEST(fma_tests, engines) {
+
+    // the bit level fma of the reference engine must give the same bit patterns as the packed engine
+    auto previous = mps::getEngine();
+    std::mt19937_64 mt(5);
+
+    for(auto format : {std::pair<unsigned long, unsigned long>{2, 3}, {7, 5}, {23, 8}, {52, 11}, {80, 15}, {130, 9}}){
+
+        auto m = format.first, e = format.second;
+        long long bias = (1LL << (e - 1)) - 1;
+        long long largest = (1LL << e) - 2;
+
+        // biased exponents around a center, inside the range of normal numbers
+        auto exponent = [&](long long center, long long range) -> unsigned long long {
+            auto value = center + (long long) (mt() % (2 * range + 1)) - range;
+            return (unsigned long long) std::max(1LL, std::min(largest, value));
+        };
+
+        for(int i = 0; i < 300; i++){
+
+            auto range = i % 8 ? 2 : bias;
+            auto exponent_a = exponent(bias, range);
+            auto exponent_b = exponent(bias, range);
+            auto a = random_mps(m, e, exponent_a, mt);
+            auto b = random_mps(m, e, exponent_b, mt);
+
+            // the summand close to the product (cancellation), far from it or zero
+            auto product_exponent = (long long) (exponent_a + exponent_b) - bias;
+            auto c = i % 5 ? random_mps(m, e, exponent(product_exponent, i % 3 ? 2 : 3 * (long long) m), mt) : mps(m, e, 0.0);
+            if(i % 7 == 0){
+                c = a * b;
+                c.setSign(!c.getSign());
+            }
+
+            mps::setEngine(mps::engine::packed);
+            auto fma = mps::fma(a, b, c).print();
+            auto product = c;
+            product.subtractProduct(a, b);
+
+            mps::setEngine(mps::engine::reference);
+            auto info = a.print() + " " + b.print() + " " + c.print();
+            EXPECT_EQ(fma, mps::fma(a, b, c).print()) << info;
+            auto tmp = c;
+            tmp.subtractProduct(a, b);
+            EXPECT_EQ(product.print(), tmp.print()) << info;
+        }
+    }
+
+    mps::setEngine(previous);
+}
+
+TEST(fma_tests, long_exponent) {
+
+    // exponents longer than 62 bits: the product and the sum are rounded separately
+    mps a(52, 64, 3.25);
+    mps b(52, 64, -0.1);
+    mps c(52, 64, 7.5);
+
+    EXPECT_EQ(((a * b) + c).print(), mps::fma(a, b, c).print());
+
+    auto sum = c;
+    sum.addProduct(a, b);
+    EXPECT_EQ(((a * b) + c).print(), sum.print());
+
+    sum = c;
+    sum.subtractProduct(a, b);
+    EXPECT_EQ((c - (a * b)).print(), sum.print());
+}
+
+TEST(fma_tests, random_double) {
+    fma_random<double, uint64_t>(52, 11, 20000);
+}
+
+TEST(fma_tests, random_float) {
+    fma_random<float, uint32_t>(23, 8, 20000);
+}
+
+TEST(fma_tests, random_wide) {
+
+    // The exact result is computed in a format that is wide enough, then rounded once by the cast.
+    std::mt19937_64 mt(11);
+    std::uniform_real_distribution<double> distribution(-10, 10);
+
+    for(unsigned long m : {80UL, 112UL, 200UL}){
+        auto wide = 3 * m + 8;
+
+        for(int i = 0; i < 100; i++){
+
+            // random mantissas: products and quotients of random doubles
+            mps a = mps(m, 15, distribution(mt)) / mps(m, 15, distribution(mt));
+            mps b = mps(m, 15, distribution(mt)) / mps(m, 15, distribution(mt));
+            mps c = mps(m, 15, distribution(mt)) / mps(m, 15, distribution(mt));
+
+            auto A = a, B = b, C = c;
+            A.cast(wide, 15);
+            B.cast(wide, 15);
+            C.cast(wide, 15);
+            auto expected = (A * B) + C;
+            expected.cast(m, 15);
+
+            EXPECT_EQ(expected.print(), mps::fma(a, b, c).print()) << m;
+        }
+    }
+}
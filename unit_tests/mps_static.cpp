@@ -0,0 +1,150 @@
+//
+// Tests for the formats fixed at compile time (mps_t). They must produce exactly the same bit patterns as mps.
+//
+
+#include "gtest/gtest.h"
+#include "helper_functions.h"
+
+#include "mps_t.h"
+
+#include <random>
+
+
+namespace {
+
+    /**
+     * Computes all operations with mps and mps_t and compares the bit patterns.
+     */
+    template<unsigned long M, unsigned long E>
+    void expect_same_results(const mps& one, const mps& two){
+
+        mps_t<M, E> a(one);
+        mps_t<M, E> b(two);
+
+        EXPECT_EQ((one + two).print(), (a + b).print()) << one.print() << " + " << two.print();
+        EXPECT_EQ((one - two).print(), (a - b).print()) << one.print() << " - " << two.print();
+        EXPECT_EQ((one * two).print(), (a * b).print()) << one.print() << " * " << two.print();
+        EXPECT_EQ((one / two).print(), (a / b).print()) << one.print() << " / " << two.print();
+
+        EXPECT_EQ(one == two, a == b) << one.print() << " == " << two.print();
+        EXPECT_EQ(one != two, a != b) << one.print() << " != " << two.print();
+        EXPECT_EQ(one < two, a < b) << one.print() << " < " << two.print();
+        EXPECT_EQ(one > two, a > b) << one.print() << " > " << two.print();
+        EXPECT_EQ(one <= two, a <= b) << one.print() << " <= " << two.print();
+        EXPECT_EQ(one >= two, a >= b) << one.print() << " >= " << two.print();
+    }
+
+    template<unsigned long M, unsigned long E>
+    void exhaustive(){
+
+        auto patterns = 1ULL << (M + E + 1);
+        for(unsigned long long i = 0; i < patterns; i++){
+            for(unsigned long long j = 0; j < patterns; j++){
+                expect_same_results<M, E>(from_pattern(M, E, i), from_pattern(M, E, j));
+            }
+        }
+    }
+
+    template<unsigned long M, unsigned long E>
+    void random_pairs(unsigned long number_of_tests){
+
+        std::mt19937_64 mt(M * 1000 + E);
+        for(unsigned long i = 0; i < number_of_tests; i++){
+            expect_same_results<M, E>(from_random(M, E, mt, mt() % 4), from_random(M, E, mt, mt() % 4));
+        }
+    }
+}
+
+
+TEST(static_format, constants){
+
+    EXPECT_EQ(23, mps_binary32::mantissa_length);
+    EXPECT_EQ(8, mps_binary32::exponent_length);
+    EXPECT_EQ(127, mps_binary32::bias);
+    EXPECT_EQ(255, mps_binary32::exponent_mask);
+    EXPECT_EQ(1, mps_binary32::mantissa_limbs);
+
+    EXPECT_EQ(1023, mps_binary64::bias);
+    EXPECT_EQ(1, mps_binary64::significand_limbs);
+
+    EXPECT_EQ(16383, mps_binary128::bias);
+    EXPECT_EQ(2, mps_binary128::mantissa_limbs);
+    EXPECT_EQ(4, mps_binary128::work_limbs);
+}
+
+TEST(static_format, conversion){
+
+    mps value(52, 11, -3.0/7.0);
+
+    mps_binary64 a(value);
+    EXPECT_EQ(value.print(), a.print());
+    EXPECT_EQ(-3.0/7.0, a.getValue());
+    EXPECT_EQ(mps_binary64(-3.0/7.0).print(), a.print());
+
+    // implicit conversion back to mps
+    mps b = a;
+    EXPECT_TRUE(value == b);
+    EXPECT_TRUE((value + a) == (a + a).toMps());
+
+    mps_t<130, 20> wide(mps(130, 20, 1.0/3.0));
+    EXPECT_EQ(mps(130, 20, 1.0/3.0).print(), wide.print());
+
+    EXPECT_THROW(mps_binary32 tmp(value), std::invalid_argument);
+    EXPECT_THROW(mps_binary64 tmp(mps(52, 8, 1.0)), std::invalid_argument);
+}
+
+TEST(static_format, special_values){
+
+    mps_binary32 a;
+    EXPECT_TRUE(a.isNaN());
+
+    a.setInf(true);
+    EXPECT_TRUE(a.isInf());
+    EXPECT_FALSE(a.isPositive());
+    EXPECT_EQ(-numeric_limits<double>::infinity(), a.getValue());
+
+    a.setZero();
+    EXPECT_TRUE(a.isZero());
+    EXPECT_EQ(0, a.getValue());
+
+    EXPECT_TRUE((mps_binary32(1.0) / a).isInf());
+    EXPECT_TRUE((a / a).isZero());
+}
+
+TEST(static_format, values){
+
+    mps_binary64 one(3.25);
+    mps_binary64 two(-0.1);
+
+    EXPECT_EQ(3.25 + -0.1, (one + two).getValue());
+    EXPECT_EQ(3.25 - -0.1, (one - two).getValue());
+    EXPECT_EQ(3.25 * -0.1, (one * two).getValue());
+    EXPECT_EQ(3.25 / -0.1, (one / two).getValue());
+    EXPECT_TRUE(one > two);
+
+    mps_binary32 three(1.5f);
+    mps_binary32 four(2.75f);
+    EXPECT_EQ(1.5f * 2.75f, (float) (three * four).getValue());
+}
+
+TEST(static_format, exhaustive_small){
+    exhaustive<1, 2>();
+    exhaustive<2, 3>();
+    exhaustive<3, 3>();
+    exhaustive<3, 4>();
+}
+
+TEST(static_format, random_standard){
+    random_pairs<10, 5>(2000);
+    random_pairs<23, 8>(2000);
+    random_pairs<52, 11>(2000);
+    random_pairs<112, 15>(500);
+}
+
+TEST(static_format, random_word_boundaries){
+    random_pairs<63, 11>(1000);
+    random_pairs<64, 11>(1000);
+    random_pairs<65, 11>(1000);
+    random_pairs<128, 15>(500);
+    random_pairs<200, 15>(200);
+}
@@ -0,0 +1,301 @@
+//
+// Tests for the storage of the bit array (packed words with inline storage).
+//
+
+#include "gtest/gtest.h"
+
+#include "mps.h"
+#include "inline_vector.h"
+#include "scratch_arena.h"
+
+#include <thread>
+
+
+TEST(packed_bits, insert_and_erase){
+
+    packed_bits bits(70, true);
+    bits.insert(bits.begin() + 3, 62, false);
+
+    EXPECT_EQ(132UL, bits.size());
+    EXPECT_EQ(3UL, bits.wordCount());
+    EXPECT_TRUE(bits[2]);
+    EXPECT_FALSE(bits[3]);
+    EXPECT_FALSE(bits[64]);
+    EXPECT_TRUE(bits[65]);
+    EXPECT_TRUE(bits[131]);
+
+    bits.erase(bits.begin() + 3, bits.begin() + 65);
+
+    EXPECT_EQ(70UL, bits.size());
+    EXPECT_EQ(2UL, bits.wordCount());
+    EXPECT_TRUE(bits.allSet());
+}
+
+TEST(packed_bits, integer_value){
+
+    packed_bits bits = {true, false, true, true};
+    EXPECT_EQ(11UL, bits.toInt());
+
+    bits.fromInt(6);
+    EXPECT_EQ(vector<bool>({false, true, true, false}), bits.toVector());
+
+    bits.pop_back();
+    EXPECT_EQ(3UL, bits.toInt());
+    EXPECT_FALSE(bits.noneSet());
+}
+
+TEST(packed_bits, word_comparison){
+
+    packed_bits a(150), b(150);
+    EXPECT_EQ(150UL, a.mismatch(b));
+    EXPECT_EQ(150UL, a.leadingZeros());
+
+    // a = 2^80, b = 2^80 - 1 (the difference is carried over the word boundaries)
+    a[69] = true;
+    for(unsigned long i = 70; i < 150; i++){
+        b[i] = true;
+    }
+
+    EXPECT_EQ(69UL, a.mismatch(b));
+    EXPECT_EQ(69UL, a.leadingZeros());
+    EXPECT_EQ(70UL, b.leadingZeros());
+
+    auto diff = packed_bits::absoluteDifference(a, b);
+    EXPECT_EQ(150UL, diff.size());
+    EXPECT_EQ(149UL, diff.leadingZeros());
+    EXPECT_EQ(diff, packed_bits::absoluteDifference(b, a));
+    EXPECT_TRUE(packed_bits::absoluteDifference(a, a).noneSet());
+}
+
+TEST(packed_bits, inline_storage){
+
+    packed_bits bits(128, true);
+    EXPECT_TRUE(bits.isInline());
+
+    bits.push_back(false);
+    EXPECT_FALSE(bits.isInline());
+    EXPECT_EQ(3UL, bits.wordCount());
+
+    packed_bits copy = bits;
+    EXPECT_EQ(bits, copy);
+
+    copy.resize(52);
+    packed_bits small = copy;
+    EXPECT_TRUE(small.isInline());
+    EXPECT_EQ(52UL, small.size());
+    EXPECT_TRUE(small.allSet());
+}
+
+TEST(inline_vector, inline_and_heap){
+
+    inline_vector<int, 2> vec = {1, 2};
+    EXPECT_TRUE(vec.isInline());
+
+    vec.push_back(3);
+    EXPECT_FALSE(vec.isInline());
+    EXPECT_EQ(3UL, vec.size());
+    EXPECT_EQ(3, vec.back());
+
+    vec.resize(5, 7);
+    EXPECT_EQ(7, vec[4]);
+
+    vec.pop_back();
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+}
+
+TEST(inline_vector, copy_and_move){
+
+    inline_vector<int, 2> small = {1, 2};
+    inline_vector<int, 2> large = {1, 2, 3, 4};
+
+    auto small_copy = small;
+    auto large_copy = large;
+    EXPECT_EQ(small, small_copy);
+    EXPECT_EQ(large, large_copy);
+    EXPECT_TRUE(small_copy.isInline());
+
+    auto small_moved = std::move(small_copy);
+    auto large_moved = std::move(large_copy);
+    EXPECT_EQ(small, small_moved);
+    EXPECT_EQ(large, large_moved);
+    EXPECT_TRUE(small_moved.isInline());
+    EXPECT_FALSE(large_moved.isInline());
+
+    large_moved = small;
+    EXPECT_EQ(small, large_moved);
+
+    small_moved = std::move(large);
+    EXPECT_EQ(4UL, small_moved.size());
+    EXPECT_EQ(4, small_moved[3]);
+}
+
+TEST(storage, standard_formats){
+
+    // The values must be the same as before regardless of the storage.
+    mps half(10, 5, 1.5);
+    mps single(23, 8, -2.75);
+    mps quad(112, 15, 0.1);
+    mps wide(300, 15, 0.1);
+
+    EXPECT_EQ(1.5, half.getValue());
+    EXPECT_EQ(-2.75, single.getValue());
+    EXPECT_EQ(0.1, quad.getValue());
+    EXPECT_EQ(0.1, wide.getValue());
+
+    EXPECT_EQ(0.2, (wide + wide).getValue());
+
+    mps product = quad * quad;
+    product.cast(52, 11);
+    EXPECT_EQ(0.1 * 0.1, product.getValue());
+}
+
+TEST(storage, classification){
+
+    // the class of the value must follow every change of the bits
+    mps value(10, 5, 1.5);
+    EXPECT_FALSE(value.isZero() || value.isInf() || value.isNaN());
+
+    vector<bool> ones(5, true);
+    vector<bool> zeros(5, false);
+    vector<bool> mantissa(10, false);
+
+    value.setExponent(ones);
+    value.setMantissa(mantissa);
+    EXPECT_TRUE(value.isInf());
+
+    mantissa[0] = true;
+    value.setMantissa(mantissa);
+    EXPECT_TRUE(value.isNaN());
+
+    mantissa[9] = true;
+    value.setMantissa(mantissa);
+    EXPECT_FALSE(value.isNaN() || value.isInf());   // all ones exponent, but a normal number
+
+    value.setExponent(zeros);
+    mantissa = vector<bool>(10, false);
+    value.setMantissa(mantissa);
+    EXPECT_TRUE(value.isZero());
+
+    value = 2.0;
+    EXPECT_FALSE(value.isZero());
+    value = 0.0;
+    EXPECT_TRUE(value.isZero());
+
+    // results of the operators and casts
+    mps large(23, 8, 3.0e38);
+    EXPECT_TRUE((large + large).isInf());
+    EXPECT_TRUE((large - large).isZero());
+    large.cast(10, 5);
+    EXPECT_TRUE(large.isInf());
+
+    mps copy = large;
+    EXPECT_TRUE(copy.isInf());
+    copy |= mps(52, 11, 1.0);
+    EXPECT_FALSE(copy.isInf());
+}
+
+TEST(storage, views_and_bit_export){
+
+    mps value(130, 11, -1.75);
+
+    auto mantissa = value.getMantissaView();
+    EXPECT_EQ(130UL, mantissa.size());
+    EXPECT_EQ(3UL, mantissa.wordCount());
+    EXPECT_EQ(0xc000000000000000ULL, mantissa.data()[0]);
+    EXPECT_EQ(value.getMantissa(), mantissa.toVector());
+    EXPECT_EQ(1023UL, value.getExponentView().toInt());
+
+    // bulk export (one byte per bit)
+    vector<unsigned char> bits(value.getBitArrayLength());
+    value.getBitArray(bits.data());
+    EXPECT_EQ(value.getBitArray(), vector<bool>(bits.begin(), bits.end()));
+
+    vector<mps> values{value, mps(130, 11, 3.0), mps(130, 11)};
+    vector<unsigned char> rows(3 * value.getBitArrayLength());
+    mps::toBitArrays(values.data(), values.size(), rows.data());
+    for(unsigned long i = 0; i < values.size(); i++){
+        std::string row(rows.begin() + (long) (i * value.getBitArrayLength()), rows.begin() + (long) ((i + 1) * value.getBitArrayLength()));
+        for(auto& c : row){
+            c = (char) ('0' + c);
+        }
+        EXPECT_EQ(values[i].print(), row);
+    }
+
+    values.emplace_back(52, 11, 1.0);
+    EXPECT_ANY_THROW(mps::toBitArrays(values.data(), values.size(), rows.data()));
+}
+
+TEST(scratch_arena, reuse){
+
+    scratch_arena::trim();
+
+    std::size_t bytes = 100;
+    auto block = scratch_arena::allocate(bytes);
+    EXPECT_EQ(128UL, bytes);
+    scratch_arena::deallocate(block, bytes);
+
+    if(scratch_arena::cached_blocks > 0){
+        std::size_t again = 65;
+        EXPECT_EQ(block, scratch_arena::allocate(again));
+        EXPECT_EQ(128UL, again);
+        scratch_arena::deallocate(block, again);
+    }
+
+    scratch_arena::trim();
+}
+
+TEST(scratch_arena, kernels_without_allocations){
+
+    if(0 == scratch_arena::cached_blocks){
+        GTEST_SKIP();
+    }
+
+    auto previous = mps::getEngine();
+
+    for(auto selected : {mps::engine::reference, mps::engine::packed}){
+
+        mps::setEngine(selected);
+
+        mps a(3000, 15, 1.2345);
+        mps b(3000, 15, -6.789);
+        mps c(3000, 15);
+
+        auto calculate = [&](){
+            c = a + b;
+            c = a - b;
+            c = a * b;
+            c = a / b;
+        };
+
+        // the first operations fill the cache, afterwards all temporaries come from it
+        calculate();
+        calculate();
+        auto allocations = scratch_arena::heapAllocations();
+        for(int i = 0; i < 5; i++){
+            calculate();
+        }
+        EXPECT_EQ(allocations, scratch_arena::heapAllocations());
+    }
+
+    mps::setEngine(previous);
+}
+
+TEST(scratch_arena, other_threads){
+
+    // blocks released by another thread than the allocating one
+    vector<mps> values;
+    std::thread worker([&values](){
+        for(int i = 0; i < 20; i++){
+            values.emplace_back(500, 11, i + 0.5);
+        }
+        values.push_back(values[3] * values[5]);
+    });
+    worker.join();
+
+    EXPECT_EQ(3.5 * 5.5, values.back().getValue());
+    values.clear();
+
+    mps x(500, 11, 2.0);
+    EXPECT_EQ(4.0, (x + x).getValue());
+}
@@ -95,6 +95,38 @@ class TestStringMethods(unittest.TestCase):
         testValue = (te == fpn.bit_array).all()
         message = "Setting exponent or mantissa not working correctly."
         self.assertTrue(testValue, message)
+
+    def test_bit_views(self):
+        fpn = mps(70, 11, 1.75)
+        words = np.asarray(fpn.mantissa_view)
+        message = "Bit views not working correctly."
+        self.assertTrue(words.dtype == np.uint64 and len(words) == 2, message)
+        self.assertTrue(words[0] == 0xc000000000000000, message)
+        self.assertTrue(len(fpn.mantissa_view) == 70 and fpn.mantissa_view[1] and not fpn.mantissa_view[2], message)
+        self.assertTrue(np.asarray(fpn.exponent_view)[0] == 1023 << 53, message)
+
+        bits = mps.to_bit_arrays([fpn, mps(70, 11, -2)])
+        self.assertTrue(bits.shape == (2, 82), message)
+        self.assertTrue((bits[0] == fpn.bit_array).all(), message)
+        self.assertTrue(bits[1][0] == 1, message)
+
+    def test_bit_views_after_changes(self):
+        # mantissas longer than 128 bits are stored on the heap, the views must not point into this memory
+        fpn = mps(200, 11, 1.75)
+        view = fpn.mantissa_view
+        words = np.asarray(view)
+        before = words.copy()
+        message = "Bit views change with the object."
+
+        fpn.add_product(mps(200, 11, 3.1), mps(200, 11, -0.7))
+        fpn += mps(200, 11, 0.3)
+        fpn.cast(300, 15)
+        fpn = mps(200, 11, 5)
+
+        self.assertTrue(len(view) == 200 and view.word_count == 4 and words.flags.writeable is False, message)
+        self.assertTrue((np.asarray(view) == before).all() and (words == before).all(), message)
+        self.assertTrue(view[0] and view[1] and not view[2], message)
+        self.assertTrue(np.asarray(fpn.mantissa_view)[0] == 0x4000000000000000, message)
     ###################################
 
     ###################################